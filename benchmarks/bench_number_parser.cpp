@@ -0,0 +1,128 @@
+// Copyright 2019 Guillaume AUJAY. All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "number_parser.h"
+
+#include <QByteArray>
+#include <QJsonArray>
+#include <QJsonDocument>
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+
+//
+// Numbers as written by Google Benchmark json reporter
+// (times and rates with max_digits10 precision, integer counters)
+static const std::vector<QByteArray>& sampleNumbers()
+{
+    static std::vector<QByteArray> numbers;
+    if ( !numbers.empty() )
+        return numbers;
+    
+    std::mt19937_64 rng(42);
+    std::uniform_real_distribution<double> timeExp(0.0, 9.0);
+    std::uniform_real_distribution<double> rateExp(3.0, 11.0);
+    std::uniform_int_distribution<long long> iterations(1, 100000000);
+    char buffer[64];
+    for (int i=0; i<10000; ++i)
+    {
+        // real_time, cpu_time
+        for (int j=0; j<2; ++j) {
+            std::snprintf(buffer, sizeof(buffer), "%.17g", std::pow(10.0, timeExp(rng)));
+            numbers.push_back(QByteArray(buffer));
+        }
+        // bytes_per_second / items_per_second
+        std::snprintf(buffer, sizeof(buffer), "%.17g", std::pow(10.0, rateExp(rng)));
+        numbers.push_back(QByteArray(buffer));
+        // iterations
+        std::snprintf(buffer, sizeof(buffer), "%lld", iterations(rng));
+        numbers.push_back(QByteArray(buffer));
+    }
+    
+    return numbers;
+}
+
+static qint64 sampleBytes()
+{
+    qint64 bytes = 0;
+    for (const auto& number : sampleNumbers())
+        bytes += number.size();
+    return bytes;
+}
+
+/**************************************************************************************************/
+
+static void BM_NumberParser(benchmark::State& state)
+{
+    const auto& numbers = sampleNumbers();
+    for (auto _ : state)
+    {
+        double sum = 0.0;
+        for (const auto& number : numbers) {
+            double value = 0.0;
+            NumberParser::parseDouble(number.constData(), number.size(), value);
+            sum += value;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * numbers.size());
+    state.SetBytesProcessed(state.iterations() * sampleBytes());
+}
+BENCHMARK(BM_NumberParser);
+
+// Previous JsonReader conversion
+static void BM_QByteArrayToDouble(benchmark::State& state)
+{
+    const auto& numbers = sampleNumbers();
+    for (auto _ : state)
+    {
+        double sum = 0.0;
+        for (const auto& number : numbers) {
+            bool ok = false;
+            sum += QByteArray::fromRawData(number.constData(), number.size()).toDouble(&ok);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * numbers.size());
+    state.SetBytesProcessed(state.iterations() * sampleBytes());
+}
+BENCHMARK(BM_QByteArrayToDouble);
+
+// Original QJsonDocument parsing, then QJsonValue::toDouble
+static void BM_QJsonValueToDouble(benchmark::State& state)
+{
+    const auto& numbers = sampleNumbers();
+    QByteArray json("[");
+    for (const auto& number : numbers)
+        json += number + ',';
+    json[json.size() - 1] = ']';
+    
+    for (auto _ : state)
+    {
+        double sum = 0.0;
+        const QJsonArray array = QJsonDocument::fromJson(json).array();
+        for (const auto& value : array)
+            sum += value.toDouble();
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * numbers.size());
+    state.SetBytesProcessed(state.iterations() * json.size());
+}
+BENCHMARK(BM_QJsonValueToDouble);
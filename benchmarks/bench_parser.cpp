@@ -0,0 +1,257 @@
+// Copyright 2019 Guillaume AUJAY. All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "result_generator.h"
+#include "result_parser.h"
+#include "result_cache.h"
+#include "benchmark_results.h"
+
+#include <QFileInfo>
+#include <QMap>
+#include <QTemporaryDir>
+
+#include <benchmark/benchmark.h>
+
+#if defined(Q_OS_UNIX)
+#include <sys/resource.h>
+#endif
+
+
+//
+// Results cache in temporary folder (user settings left untouched)
+static void isolateCache()
+{
+    static QTemporaryDir cacheDir;
+    if (ResultCache::folder() != cacheDir.path() + "/")
+        ResultCache::setFolder( cacheDir.path() );
+}
+
+// Synthetic files (generated once per configuration)
+static QString resultsFile(int benchmarks, int repetitions, bool aggregates)
+{
+    static QTemporaryDir tempDir;
+    static QMap<QString, QString> files;
+    isolateCache();
+    
+    QString key = QString("%1_%2_%3").arg(benchmarks).arg(repetitions).arg(aggregates);
+    if ( !files.contains(key) )
+    {
+        GeneratorOptions options;
+        options.benchmarks  = benchmarks;
+        options.repetitions = repetitions;
+        options.aggregates  = aggregates;
+        options.arguments   = 2;
+        options.templates   = 1;
+        options.jomtNaming  = true;
+        
+        QString errorMsg;
+        QString filename = tempDir.filePath(key + ".json");
+        if ( !ResultGenerator::writeFile(filename, options, errorMsg) )
+            qFatal("%s", qPrintable(errorMsg));
+        files[key] = filename;
+    }
+    
+    return files[key];
+}
+
+static const BenchResults& parsedResults(int benchmarks)
+{
+    static QMap<int, BenchResults> results;
+    if ( !results.contains(benchmarks) )
+    {
+        QString errorMsg;
+        results[benchmarks] = ResultParser::parseJsonFile(resultsFile(benchmarks, 1, false), errorMsg);
+    }
+    
+    return results[benchmarks];
+}
+
+// Process peak memory (kB, monotonic over whole run)
+static double peakRssKB()
+{
+#if defined(Q_OS_UNIX)
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#if defined(Q_OS_MACOS)
+    return usage.ru_maxrss / 1024.0;    // bytes
+#else
+    return usage.ru_maxrss;             // kilobytes
+#endif
+#else
+    return 0.0;
+#endif
+}
+
+static void setParseCounters(benchmark::State& state, const QString &filename, int entries)
+{
+    qint64 fileSize = QFileInfo(filename).size();
+    state.SetBytesProcessed(state.iterations() * fileSize);
+    state.counters["entries/s"] = benchmark::Counter(static_cast<double>(state.iterations()) * entries,
+                                                     benchmark::Counter::kIsRate);
+    state.counters["peak_rss_kB"] = peakRssKB();
+}
+
+/**************************************************************************************************/
+
+// Parsing (args: benchmarks, repetitions, aggregates)
+static void BM_ParseJsonFile(benchmark::State& state)
+{
+    int benchmarks  = static_cast<int>(state.range(0));
+    int repetitions = static_cast<int>(state.range(1));
+    bool aggregates = state.range(2) != 0;
+    QString filename = resultsFile(benchmarks, repetitions, aggregates);
+    
+    ResultCache::setEnabled(false);
+    int entries = 0;
+    for (auto _ : state)
+    {
+        QString errorMsg;
+        BenchResults bchResults = ResultParser::parseJsonFile(filename, errorMsg);
+        if ( bchResults.benchmarks.isEmpty() ) {
+            state.SkipWithError(qPrintable(errorMsg));
+            break;
+        }
+        entries = benchmarks * (repetitions + (aggregates ? 4 : 0));
+        benchmark::DoNotOptimize(bchResults);
+    }
+    ResultCache::setEnabled(true);
+    setParseCounters(state, filename, entries);
+}
+// Linear scaling with entries (index lookup), then repetitions/aggregates merging
+BENCHMARK(BM_ParseJsonFile)->Unit(benchmark::kMillisecond)
+    ->Args({10000, 1, 0})->Args({100000, 1, 0})->Args({1000000, 1, 0})
+    ->Args({10000, 10, 0})->Args({10000, 10, 1})->Args({100000, 10, 1});
+
+// Parsing with binary cache (warm)
+static void BM_ParseJsonFileCached(benchmark::State& state)
+{
+    int benchmarks = static_cast<int>(state.range(0));
+    QString filename = resultsFile(benchmarks, 1, false);
+    
+    QString errorMsg;
+    ResultParser::parseJsonFile(filename, errorMsg);   // fill cache
+    for (auto _ : state)
+    {
+        BenchResults bchResults = ResultParser::parseJsonFile(filename, errorMsg);
+        benchmark::DoNotOptimize(bchResults);
+    }
+    QFile::remove( ResultCache::cachePath(filename) );
+    setParseCounters(state, filename, benchmarks);
+}
+BENCHMARK(BM_ParseJsonFileCached)->Unit(benchmark::kMillisecond)->Arg(10000)->Arg(100000);
+
+/**************************************************************************************************/
+
+// Merging (args: benchmarks)
+static void BM_AppendResults(benchmark::State& state)
+{
+    const BenchResults &bchResults = parsedResults(static_cast<int>(state.range(0)));
+    for (auto _ : state)
+    {
+        BenchResults merged = bchResults;
+        BenchResults added = bchResults;
+        merged.appendResults( std::move(added) );   // all renamed
+        benchmark::DoNotOptimize(merged);
+    }
+    state.SetItemsProcessed(state.iterations() * bchResults.benchmarks.size());
+}
+BENCHMARK(BM_AppendResults)->Unit(benchmark::kMillisecond)->Arg(1000)->Arg(10000)->Arg(100000);
+
+static void BM_OverwriteResults(benchmark::State& state)
+{
+    const BenchResults &bchResults = parsedResults(static_cast<int>(state.range(0)));
+    for (auto _ : state)
+    {
+        BenchResults merged = bchResults;
+        BenchResults added = bchResults;
+        merged.overwriteResults( std::move(added) );    // all overwritten
+        benchmark::DoNotOptimize(merged);
+    }
+    state.SetItemsProcessed(state.iterations() * bchResults.benchmarks.size());
+}
+BENCHMARK(BM_OverwriteResults)->Unit(benchmark::kMillisecond)->Arg(1000)->Arg(10000)->Arg(100000);
+
+// Merging shards with same names (args: shards, benchmarks per shard)
+static void BM_AppendShards(benchmark::State& state)
+{
+    int shards = static_cast<int>(state.range(0));
+    const BenchResults &bchResults = parsedResults(static_cast<int>(state.range(1)));
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        QVector<BenchResults> added(shards - 1, bchResults);
+        BenchResults merged = bchResults;
+        state.ResumeTiming();
+        
+        for (auto& shard : added)
+            merged.appendResults(std::move(shard), false);
+        merged.updateDerived();
+        benchmark::DoNotOptimize(merged);
+    }
+    state.SetItemsProcessed(state.iterations() * shards * bchResults.benchmarks.size());
+}
+BENCHMARK(BM_AppendShards)->Unit(benchmark::kMillisecond)->Args({10, 10000})->Args({40, 50000});
+
+/**************************************************************************************************/
+
+// Segmentation/grouping used by plotters (args: benchmarks)
+static void BM_SegmentFamilies(benchmark::State& state)
+{
+    const BenchResults &bchResults = parsedResults(static_cast<int>(state.range(0)));
+    for (auto _ : state)
+        benchmark::DoNotOptimize( bchResults.segmentFamilies() );
+    state.SetItemsProcessed(state.iterations() * bchResults.benchmarks.size());
+}
+BENCHMARK(BM_SegmentFamilies)->Unit(benchmark::kMillisecond)->Arg(10000)->Arg(100000);
+
+static void BM_SegmentArguments(benchmark::State& state)
+{
+    const BenchResults &bchResults = parsedResults(static_cast<int>(state.range(0)));
+    QVector<int> subset = bchResults.segmentAll();
+    for (auto _ : state)
+        benchmark::DoNotOptimize( bchResults.segmentArguments(subset, 0) );
+    state.SetItemsProcessed(state.iterations() * bchResults.benchmarks.size());
+}
+BENCHMARK(BM_SegmentArguments)->Unit(benchmark::kMillisecond)->Arg(10000)->Arg(100000);
+
+static void BM_Segment2DNames(benchmark::State& state)
+{
+    const BenchResults &bchResults = parsedResults(static_cast<int>(state.range(0)));
+    QVector<int> subset = bchResults.segmentAll();
+    for (auto _ : state)
+        benchmark::DoNotOptimize( bchResults.segment2DNames(subset, true, 0, true, 1) );
+    state.SetItemsProcessed(state.iterations() * bchResults.benchmarks.size());
+}
+BENCHMARK(BM_Segment2DNames)->Unit(benchmark::kMillisecond)->Arg(10000)->Arg(100000);
+
+static void BM_GroupArgument(benchmark::State& state)
+{
+    const BenchResults &bchResults = parsedResults(static_cast<int>(state.range(0)));
+    QVector<int> subset = bchResults.segmentAll();
+    for (auto _ : state)
+        benchmark::DoNotOptimize( bchResults.groupArgument(subset, 0, "X") );
+    state.SetItemsProcessed(state.iterations() * bchResults.benchmarks.size());
+}
+BENCHMARK(BM_GroupArgument)->Unit(benchmark::kMillisecond)->Arg(10000)->Arg(100000);
+
+static void BM_GroupTemplate(benchmark::State& state)
+{
+    const BenchResults &bchResults = parsedResults(static_cast<int>(state.range(0)));
+    QVector<int> subset = bchResults.segmentAll();
+    for (auto _ : state)
+        benchmark::DoNotOptimize( bchResults.groupTemplate(subset, 0, "T") );
+    state.SetItemsProcessed(state.iterations() * bchResults.benchmarks.size());
+}
+BENCHMARK(BM_GroupTemplate)->Unit(benchmark::kMillisecond)->Arg(10000)->Arg(100000);
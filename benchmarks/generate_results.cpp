@@ -0,0 +1,72 @@
+// Copyright 2019 Guillaume AUJAY. All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "result_generator.h"
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDebug>
+
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("jomt_generate");
+    
+    // Options
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Generate synthetic Google Benchmark json results");
+    parser.addHelpOption();
+    parser.addPositionalArgument("file", "Output json file.");
+    
+    QCommandLineOption benchmarksOption(QStringList() << "b" << "benchmarks", "Distinct benchmarks.", "count", "1000");
+    QCommandLineOption repetitionsOption(QStringList() << "r" << "repetitions", "Repetitions per benchmark.", "count", "1");
+    QCommandLineOption aggregatesOption(QStringList() << "g" << "aggregates", "Add aggregates (with repetitions).");
+    QCommandLineOption argumentsOption(QStringList() << "a" << "arguments", "Argument depth.", "depth", "1");
+    QCommandLineOption templatesOption(QStringList() << "t" << "templates", "Template depth.", "depth", "0");
+    QCommandLineOption jomtOption(QStringList() << "j" << "jomt", "Use JOMT_Family_Container naming.");
+    QCommandLineOption noCountersOption("no-counters", "Omit bytes/items per second.");
+    QCommandLineOption seedOption("seed", "Random seed.", "seed", "1");
+    parser.addOptions({benchmarksOption, repetitionsOption, aggregatesOption, argumentsOption,
+                       templatesOption, jomtOption, noCountersOption, seedOption});
+    parser.process(app);
+    
+    const QStringList args = parser.positionalArguments();
+    if (args.size() != 1)
+        parser.showHelp(1);
+    
+    GeneratorOptions options;
+    options.benchmarks  = parser.value(benchmarksOption).toInt();
+    options.repetitions = parser.value(repetitionsOption).toInt();
+    options.aggregates  = parser.isSet(aggregatesOption);
+    options.arguments   = parser.value(argumentsOption).toInt();
+    options.templates   = parser.value(templatesOption).toInt();
+    options.jomtNaming  = parser.isSet(jomtOption);
+    options.counters    = !parser.isSet(noCountersOption);
+    options.seed        = parser.value(seedOption).toUInt();
+    if (options.benchmarks <= 0 || options.repetitions <= 0 || options.arguments < 0 || options.templates < 0) {
+        qCritical() << "Invalid options";
+        return 1;
+    }
+    
+    // Generate
+    QString errorMsg;
+    if ( !ResultGenerator::writeFile(args[0], options, errorMsg) ) {
+        qCritical() << errorMsg;
+        return 1;
+    }
+    
+    return 0;
+}
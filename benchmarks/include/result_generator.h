@@ -0,0 +1,48 @@
+// Copyright 2019 Guillaume AUJAY. All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef RESULT_GENERATOR_H
+#define RESULT_GENERATOR_H
+
+#include <QByteArray>
+#include <QString>
+
+
+// Synthetic results configuration
+struct GeneratorOptions
+{
+    int benchmarks  = 1000;     // distinct run names
+    int repetitions = 1;        // runs per benchmark
+    bool aggregates = false;    // mean/median/stddev/cv per benchmark (if repetitions)
+    int arguments   = 1;        // argument depth ("/a1/a2")
+    int templates   = 0;        // template depth ("<t1, t2>")
+    bool jomtNaming = false;    // "JOMT_Family_Container" names
+    bool counters   = true;     // bytes/items per second
+    quint32 seed    = 1;
+};
+
+//
+// ResultGenerator
+// Google Benchmark json output, with realistic names and number formatting
+class ResultGenerator
+{
+public:
+    static QByteArray generate(const GeneratorOptions &options);
+    
+    static bool writeFile(const QString &filename, const GeneratorOptions &options, QString &errorMsg);
+};
+
+
+#endif // RESULT_GENERATOR_H
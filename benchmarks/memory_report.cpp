@@ -0,0 +1,142 @@
+// Copyright 2019 Guillaume AUJAY. All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "result_parser.h"
+#include "result_cache.h"
+#include "benchmark_results.h"
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QTextStream>
+
+
+// Previous layout (24 aggregate doubles and a QString time unit inline)
+struct LegacyBenchData {
+    QString name;
+    QString run_name;
+    QString run_type;
+    int repetitions;
+    int repetition_index;
+    int threads;
+    int iterations;
+    QString time_unit;
+    QVector<double> real_time;
+    QVector<double> cpu_time;
+    QVector<double> kbytes_sec;
+    QVector<double> kitems_sec;
+    
+    bool hasAggregate;
+    double aggregates[24];
+    
+    QString base_name;
+    QString family;
+    QString container;
+    QStringList arguments;
+    QStringList templates;
+    
+    double real_time_us, cpu_time_us;
+    double kbytes_sec_dflt, kitems_sec_dflt;
+};
+static const qint64 legacyDataSize = static_cast<qint64>(sizeof(LegacyBenchData));
+
+// Heap array header (Qt 6 QArrayData, same as BenchResults::memoryUsage)
+static const qint64 arrayHeader = 16;
+
+/**************************************************************************************************/
+
+//
+// Estimate with previous layout (inline aggregates, unshared strings, no derived data)
+static BenchMemory legacyUsage(const BenchResults &bchResults)
+{
+    BenchMemory usage;
+    auto stringSize = [](const QString &str) -> qint64 {
+        return str.isEmpty() ? 0 : arrayHeader + (str.size() + 1) * 2;
+    };
+    
+    usage.benchmarks = arrayHeader + bchResults.benchmarks.size() * legacyDataSize;
+    for (const auto& bchData : bchResults.benchmarks)
+    {
+        for (const QVector<double>* vec : {&bchData.real_time, &bchData.cpu_time,
+                                          &bchData.kbytes_sec, &bchData.kitems_sec})
+            if ( !vec->isEmpty() )
+                usage.repetitions += arrayHeader + vec->size() * 8;
+        
+        usage.strings += stringSize(bchData.name) + stringSize(bchData.run_name)
+                + stringSize(bchData.run_type) + stringSize(bchData.base_name)
+                + stringSize(bchData.family) + stringSize(bchData.container)
+                + stringSize(timeUnitName(bchData.time_unit));
+        for (const QStringList* list : {&bchData.arguments, &bchData.templates}) {
+            if ( !list->isEmpty() )
+                usage.strings += arrayHeader + list->size() * static_cast<qint64>(sizeof(QString));
+            for (const auto& str : *list)
+                usage.strings += stringSize(str);
+        }
+    }
+    
+    return usage;
+}
+
+static void printUsage(QTextStream &out, const char* label, const BenchMemory &usage, int benchmarks)
+{
+    auto perBench = [benchmarks](qint64 bytes) { return QString::number(static_cast<double>(bytes) / benchmarks, 'f', 1); };
+    out << "  " << label << ": " << perBench(usage.total()) << " bytes/benchmark"
+        << " (inline " << perBench(usage.benchmarks)
+        << ", repetitions " << perBench(usage.repetitions)
+        << ", aggregates " << perBench(usage.aggregates)
+        << ", strings " << perBench(usage.strings)
+        << ", derived " << perBench(usage.derived)
+        << ", indexes " << perBench(usage.indexes)
+        << ", meta " << perBench(usage.meta) << ")\n";
+}
+
+/**************************************************************************************************/
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("jomt_memory");
+    
+    // Options
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Report benchmark results memory usage (estimate)");
+    parser.addHelpOption();
+    parser.addPositionalArgument("files", "Json results files.", "files...");
+    parser.process(app);
+    
+    const QStringList args = parser.positionalArguments();
+    if (args.isEmpty())
+        parser.showHelp(1);
+    
+    QTextStream out(stdout);
+    out << "BenchData: " << sizeof(BenchData) << " bytes (previously " << legacyDataSize << ")"
+        << ", BenchAggregate: " << sizeof(BenchAggregate) << " bytes\n";
+    
+    ResultCache::setEnabled(false);
+    for (const auto& filename : args)
+    {
+        QString errorMsg;
+        BenchResults bchResults = ResultParser::parseJsonFile(filename, errorMsg);
+        if ( bchResults.benchmarks.isEmpty() ) {
+            qCritical() << errorMsg;
+            return 1;
+        }
+        int benchmarks = bchResults.benchmarks.size();
+        out << filename << ": " << benchmarks << " benchmarks\n";
+        printUsage(out, "before", legacyUsage(bchResults), benchmarks);
+        printUsage(out, "after ", bchResults.memoryUsage(), benchmarks);
+    }
+    
+    return 0;
+}
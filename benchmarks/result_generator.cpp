@@ -0,0 +1,227 @@
+// Copyright 2019 Guillaume AUJAY. All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "result_generator.h"
+
+#include <QSaveFile>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+
+static const int families_count   = 8;
+static const int containers_count = 4;
+static const char* container_names[containers_count] = { "vector", "deque", "list", "set" };
+
+static void appendNumber(QByteArray &out, double value)
+{
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.17g", value);  // like json reporter (max_digits10)
+    out += buffer;
+}
+
+static void appendField(QByteArray &out, const char *name, const QByteArray &value, bool isString, bool isLast = false)
+{
+    out += "      \"";
+    out += name;
+    out += isString ? "\": \"" : "\": ";
+    out += value;
+    out += isString ? "\"" : "";
+    out += isLast ? "\n" : ",\n";
+}
+
+static void appendField(QByteArray &out, const char *name, double value, bool isLast = false)
+{
+    QByteArray number;
+    appendNumber(number, value);
+    appendField(out, name, number, false, isLast);
+}
+
+// Parameter values from benchmark index (mixed radix: small cycles, last one unbounded)
+static QByteArray benchmarkName(const GeneratorOptions &options, int index, int families)
+{
+    int baseIdx = index % (families * containers_count);
+    int paramsIdx = index / (families * containers_count);
+    int family = baseIdx / containers_count;
+    int container = baseIdx % containers_count;
+    
+    QByteArray name;
+    if (options.jomtNaming)
+        name = "JOMT_Family" + QByteArray::number(family) + '_' + container_names[container];
+    else
+        name = "BM_Family" + QByteArray::number(family) + '_' + container_names[container];
+    
+    int paramsCount = options.templates + options.arguments;
+    QVector<int> params(paramsCount);
+    for (int i=0; i<paramsCount; ++i)
+    {
+        if (i < paramsCount - 1) {
+            params[i] = 1 << (paramsIdx % 4 + 3);
+            paramsIdx /= 4;
+        }
+        else
+            params[i] = 1 + paramsIdx;
+    }
+    
+    // Templates then arguments
+    if (options.templates > 0)
+    {
+        name += '<';
+        for (int i=0; i<options.templates; ++i) {
+            if (i > 0)
+                name += ", ";
+            name += QByteArray::number(params[i]);
+        }
+        name += '>';
+    }
+    for (int i=options.templates; i<paramsCount; ++i)
+        name += '/' + QByteArray::number(params[i]);
+    
+    return name;
+}
+
+/**************************************************************************************************/
+
+QByteArray ResultGenerator::generate(const GeneratorOptions &options)
+{
+    std::mt19937 rng(options.seed);
+    std::lognormal_distribution<double> baseTime(4.0, 2.0);     // ns
+    std::normal_distribution<double> noise(1.0, 0.02);
+    
+    // Unique names without parameters need more families
+    int families = families_count;
+    if (options.templates + options.arguments == 0)
+        families = std::max(families, (options.benchmarks + containers_count - 1) / containers_count);
+    int repetitions = std::max(1, options.repetitions);
+    bool hasAggregates = options.aggregates && repetitions > 1;
+    
+    QByteArray out;
+    out.reserve( static_cast<int>(qMin<qint64>(qint64(options.benchmarks) * repetitions * 450, 1 << 30)) );
+    
+    // Context
+    out += "{\n"
+           "  \"context\": {\n"
+           "    \"date\": \"2019-06-01T12:00:00+00:00\",\n"
+           "    \"host_name\": \"synthetic\",\n"
+           "    \"executable\": \"./synthetic_benchmarks\",\n"
+           "    \"num_cpus\": 8,\n"
+           "    \"mhz_per_cpu\": 3600,\n"
+           "    \"cpu_scaling_enabled\": false,\n"
+           "    \"caches\": [\n"
+           "      {\"type\": \"Data\", \"level\": 1, \"size\": 32768, \"num_sharing\": 2},\n"
+           "      {\"type\": \"Instruction\", \"level\": 1, \"size\": 32768, \"num_sharing\": 2},\n"
+           "      {\"type\": \"Unified\", \"level\": 2, \"size\": 262144, \"num_sharing\": 2},\n"
+           "      {\"type\": \"Unified\", \"level\": 3, \"size\": 12582912, \"num_sharing\": 8}\n"
+           "    ],\n"
+           "    \"load_avg\": [0.5, 0.4, 0.3],\n"
+           "    \"library_build_type\": \"release\"\n"
+           "  },\n"
+           "  \"benchmarks\": [\n";
+    
+    // Benchmarks
+    bool isFirst = true;
+    std::vector<double> realTimes(repetitions), cpuTimes(repetitions);
+    for (int idx=0; idx<options.benchmarks; ++idx)
+    {
+        QByteArray name = benchmarkName(options, idx, families);
+        double time = baseTime(rng) + 1.0;
+        qint64 iterations = std::max<qint64>(1, static_cast<qint64>(1e9 / time));
+        
+        for (int rep=0; rep<repetitions; ++rep)
+        {
+            realTimes[rep] = time * noise(rng);
+            cpuTimes[rep] = realTimes[rep] * 0.99;
+            
+            out += isFirst ? "    {\n" : ",\n    {\n";
+            isFirst = false;
+            appendField(out, "name", name, true);
+            appendField(out, "run_name", name, true);
+            appendField(out, "run_type", "iteration", true);
+            appendField(out, "repetitions", repetitions);
+            appendField(out, "repetition_index", rep);
+            appendField(out, "threads", 1);
+            appendField(out, "iterations", static_cast<double>(iterations));
+            appendField(out, "real_time", realTimes[rep]);
+            appendField(out, "cpu_time", cpuTimes[rep]);
+            appendField(out, "time_unit", "ns", true, !options.counters);
+            if (options.counters) {
+                appendField(out, "bytes_per_second", 64e9 / cpuTimes[rep]);
+                appendField(out, "items_per_second", 1e9 / cpuTimes[rep], true);
+            }
+            out += "    }";
+        }
+        
+        // Aggregates
+        if (hasAggregates)
+        {
+            auto stats = [repetitions](std::vector<double> values, double &mean, double &median, double &stddev) {
+                mean = 0;
+                for (double v : values) mean += v;
+                mean /= repetitions;
+                stddev = 0;
+                for (double v : values) stddev += (v - mean) * (v - mean);
+                stddev = std::sqrt(stddev / (repetitions - 1));
+                std::sort(values.begin(), values.end());
+                median = (repetitions % 2 == 1) ? values[repetitions / 2]
+                                                : (values[repetitions / 2 - 1] + values[repetitions / 2]) / 2;
+            };
+            double real[3], cpu[3];
+            stats(realTimes, real[0], real[1], real[2]);
+            stats(cpuTimes, cpu[0], cpu[1], cpu[2]);
+            
+            const char* aggNames[4] = { "mean", "median", "stddev", "cv" };
+            double aggReal[4] = { real[0], real[1], real[2], real[2] / real[0] };
+            double aggCpu[4]  = { cpu[0],  cpu[1],  cpu[2],  cpu[2] / cpu[0] };
+            for (int agg=0; agg<4; ++agg)
+            {
+                out += ",\n    {\n";
+                appendField(out, "name", name + '_' + aggNames[agg], true);
+                appendField(out, "run_name", name, true);
+                appendField(out, "run_type", "aggregate", true);
+                appendField(out, "repetitions", repetitions);
+                appendField(out, "threads", 1);
+                appendField(out, "aggregate_name", aggNames[agg], true);
+                appendField(out, "aggregate_unit", agg == 3 ? "percentage" : "time", true);
+                appendField(out, "iterations", repetitions);
+                appendField(out, "real_time", aggReal[agg]);
+                appendField(out, "cpu_time", aggCpu[agg]);
+                appendField(out, "time_unit", "ns", true, true);
+                out += "    }";
+            }
+        }
+    }
+    out += "\n  ]\n}\n";
+    
+    return out;
+}
+
+bool ResultGenerator::writeFile(const QString &filename, const GeneratorOptions &options, QString &errorMsg)
+{
+    QSaveFile file(filename);
+    if ( !file.open(QIODevice::WriteOnly) ) {
+        errorMsg = "Couldn't open output file: " + filename;
+        return false;
+    }
+    file.write( generate(options) );
+    if ( !file.commit() ) {
+        errorMsg = "Couldn't write output file: " + filename;
+        return false;
+    }
+    
+    return true;
+}
@@ -15,13 +15,21 @@
 
 #include "benchmark_results.h"
 
+#include <QAtomicInteger>
 #include <QMap>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSet>
 
+#include <algorithm>
 #include <utility>
 
 #define BCHRES_DEBUG false
 #include <QDebug>
 
+// Axis name of custom data size templates
+static const char* data_size_name = "Data (bytes)";
+
 
 /**************************************************************************************************
 *
@@ -119,7 +127,7 @@ QPair<double, QString> BenchResults::convertCustomDataSize(const QString &tplt)
             res.first = val.toDouble(&ok);
             if (ok) {
                 res.first *= mult;
-                res.second = "Data (bytes)";
+                res.second = data_size_name;
             }
         }
     }
@@ -157,6 +165,58 @@ double BenchResults::getParamValue(const QString &name, QString &custDataName, b
     return val;
 }
 
+double BenchResults::getParamValue(const BenchParamValue &param, QString &custDataName,
+                                   bool &custDataAxis, double &fallbackIdx)
+{
+    double val = param.value;
+    if (param.type != ParamNumberType)
+    {
+        if (custDataAxis) {
+            // Custom data size template
+            if (param.type == ParamDataSizeType) {
+                if (custDataName.isEmpty())
+                    custDataName = data_size_name;
+            }
+            else {
+                val = fallbackIdx++;
+                custDataAxis = false;
+            }
+        }
+        else
+            val = fallbackIdx++;
+    }
+    else
+        custDataAxis = false;
+    
+    return val;
+}
+
+/**************************************************************************************************/
+
+BenchParamValue BenchResults::parseParamValue(const QString &name)
+{
+    BenchParamValue param;
+    
+    bool ok = false;
+    param.value = name.toDouble(&ok);
+    if (ok)
+        param.type = ParamNumberType;
+    else
+    {
+        const auto &custData = convertCustomDataSize(name);
+        if ( !custData.second.isEmpty() ) {
+            param.type = ParamDataSizeType;
+            param.value = custData.first;
+        }
+        else {
+            param.type = ParamNameType;
+            param.value = 0.;
+        }
+    }
+    
+    return param;
+}
+
 /**************************************************************************************************
 *
 * Member functions
@@ -193,48 +253,71 @@ QVector<BenchSubset> BenchResults::segmentEach() const
 
 /**************************************************************************************************/
 
-QVector<BenchSubset> BenchResults::segmentFamilies() const
+// Each code of dimension from index vector in its own subset (first appearance order)
+static QVector<BenchSubset> segmentDimension(const BenchDimension &dim, const QVector<int> &subset)
 {
-    QVector<BenchSubset> famRes;
-    QMap<QString, int> famMap;
+    QVector<BenchSubset> dimRes;
+    QVector<int> codeMap(dim.subsets.size(), -1);  // code -> subset
     
-    for (int idx = 0; idx < benchmarks.size(); ++idx)
+    for (int idx : subset)
     {
-        const BenchData &bchData = benchmarks[idx];
-                
-        if ( !famMap.contains(bchData.family) )
+        if (idx < 0 || idx >= dim.codes.size())
+            continue; //No longer exists
+        
+        int code = dim.codes[idx];
+        if (code < 0) continue;
+        
+        int &subIdx = codeMap[code];
+        if (subIdx < 0)
         {
-            famMap[bchData.family] = famRes.size();
-            famRes.push_back( BenchSubset(bchData.family) );
+            subIdx = dimRes.size();
+            dimRes.push_back( BenchSubset(dim.subsets[code].name) );
         }
         // Append to associated entry
-        famRes[famMap[bchData.family]].idxs.push_back(idx);
+        dimRes[subIdx].idxs.push_back(idx);
     }
     
-    return famRes;
+    return dimRes;
+}
+
+// Dimensions of results, built in fallback if outdated (e.g. benchmarks changed without update)
+static const BenchDimensions& validDimensions(const BenchResults &bchResults, BenchDimensions &fallback)
+{
+    if ( bchResults.hasDimensions() )
+        return bchResults.dimensions;
+    
+    qWarning() << "Outdated benchmark dimensions, rebuilding them";
+    fallback.build(bchResults.benchmarks, bchResults.revision);
+    return fallback;
+}
+
+// Index vector holds all benchmarks in order (i.e. from segmentAll)
+static bool isWholeSet(const QVector<int> &subset, int size)
+{
+    if (subset.size() != size)
+        return false;
+    for (int i=0; i<size; ++i)
+        if (subset[i] != i) return false;
+    
+    return true;
+}
+
+/**************************************************************************************************/
+
+QVector<BenchSubset> BenchResults::segmentFamilies() const
+{
+    BenchDimensions fallback;
+    return validDimensions(*this, fallback).families().subsets;
 }
 
 /**************************************************************************************************/
 
 QVector<BenchSubset> BenchResults::segmentFamilies(const QVector<int> &subset) const
 {
-    QVector<BenchSubset> famRes;
-    QMap<QString, int> famMap;
-    
-    for (int idx : subset)
-    {
-        if (idx >= benchmarks.size())
-            continue; //No longer exists
-        
-        const BenchData &bchData = benchmarks[idx];
-        if ( !famMap.contains(bchData.family) )
-        {
-            famMap[bchData.family] = famRes.size();
-            famRes.push_back( BenchSubset(bchData.family) );
-        }
-        // Append to associated entry
-        famRes[famMap[bchData.family]].idxs.push_back(idx);
-    }
+    BenchDimensions fallback;
+    const BenchDimensions &dims = validDimensions(*this, fallback);
+    QVector<BenchSubset> famRes = isWholeSet(subset, benchmarks.size()) ? dims.families().subsets
+                                                                        : segmentDimension(dims.families(), subset);
     for (const BenchSubset& sub : std::as_const(famRes))
         if (BCHRES_DEBUG) qDebug() << "familySub:" << sub.name << "->" << sub.idxs;
     
@@ -245,23 +328,19 @@ QVector<BenchSubset> BenchResults::segmentFamilies(const QVector<int> &subset) c
 
 QVector<BenchSubset> BenchResults::segmentContainers(const QVector<int> &subset) const
 {
+    BenchDimensions fallback;
+    const BenchDimensions &dims = validDimensions(*this, fallback);
     QVector<BenchSubset> ctnRes;
-    QMap<QString, int> ctnMap;
     
-    for (int idx : subset)
+    // Whole family (cached hierarchy)
+    if ( !subset.isEmpty() && subset.front() >= 0 && subset.front() < benchmarks.size() )
     {
-        if (idx >= benchmarks.size())
-            continue; //No longer exists
-        
-        const BenchData &bchData = benchmarks[idx];
-        if ( !ctnMap.contains(bchData.container) )
-        {
-            ctnMap[bchData.container] = ctnRes.size();
-            ctnRes.push_back( BenchSubset(bchData.container) );
-        }
-        // Append to associated entry
-        ctnRes[ctnMap[bchData.container]].idxs.push_back(idx);
+        int famCode = dims.families().codes[subset.front()];
+        if (famCode >= 0 && dims.families().subsets[famCode].idxs == subset)
+            ctnRes = dims.familyContainers(famCode);
     }
+    if ( ctnRes.isEmpty() )
+        ctnRes = segmentDimension(dims.containers(), subset);
     for (const BenchSubset& sub : std::as_const(ctnRes))
         if (BCHRES_DEBUG) qDebug() << "containerSub:" << sub.name << "->" << sub.idxs;
     
@@ -272,46 +351,18 @@ QVector<BenchSubset> BenchResults::segmentContainers(const QVector<int> &subset)
 
 QVector<BenchSubset> BenchResults::segmentBaseNames() const
 {
-    QVector<BenchSubset> nameRes;
-    QMap<QString, int> nameMap;
-    
-    for (int idx = 0; idx < benchmarks.size(); ++idx)
-    {
-        const BenchData &bchData = benchmarks[idx];
-                
-        if ( !nameMap.contains(bchData.base_name) )
-        {
-            nameMap[bchData.base_name] = nameRes.size();
-            nameRes.push_back( BenchSubset(bchData.base_name) );
-        }
-        // Append to associated entry
-        nameRes[nameMap[bchData.base_name]].idxs.push_back(idx);
-    }
-    
-    return nameRes;
+    BenchDimensions fallback;
+    return validDimensions(*this, fallback).baseNames().subsets;
 }
 
 /**************************************************************************************************/
 
 QVector<BenchSubset> BenchResults::segmentBaseNames(const QVector<int> &subset) const
 {
-    QVector<BenchSubset> nameRes;
-    QMap<QString, int> nameMap;
-    
-    for (int idx : subset)
-    {
-        if (idx >= benchmarks.size())
-            continue; //No longer exists
-        
-        const BenchData &bchData = benchmarks[idx];
-        if ( !nameMap.contains(bchData.base_name) )
-        {
-            nameMap[bchData.base_name] = nameRes.size();
-            nameRes.push_back( BenchSubset(bchData.base_name) );
-        }
-        // Append to associated entry
-        nameRes[nameMap[bchData.base_name]].idxs.push_back(idx);
-    }
+    BenchDimensions fallback;
+    const BenchDimensions &dims = validDimensions(*this, fallback);
+    QVector<BenchSubset> nameRes = isWholeSet(subset, benchmarks.size()) ? dims.baseNames().subsets
+                                                                         : segmentDimension(dims.baseNames(), subset);
     for (const BenchSubset& sub : std::as_const(nameRes))
         if (BCHRES_DEBUG) qDebug() << "nameSub:" << sub.name << "->" << sub.idxs;
     
@@ -320,40 +371,126 @@ QVector<BenchSubset> BenchResults::segmentBaseNames(const QVector<int> &subset)
 
 /**************************************************************************************************/
 
-QVector<BenchSubset> BenchResults::segment2DNames(const QVector<int> &subset,
-                                    bool isArg1, int idx1, bool isArg2, int idx2) const
+// Structural key of benchmark name: base name, templates and arguments codes,
+// masked parameters excluded (compared without building strings or key vectors)
+class NameKey
 {
+public:
+    NameKey(const BenchResults &bchResults, const BenchDimensions &dims, int argIdx, int tpltIdx, int argIdx2, int tpltIdx2)
+        : mBenchmarks(bchResults.benchmarks), mDims(dims)
+        , mArgIdx(argIdx), mTpltIdx(tpltIdx), mArgIdx2(argIdx2), mTpltIdx2(tpltIdx2)
+    {}
+    
+    // Has all masked parameters
+    bool isCompatible(int idx) const
+    {
+        int ttlArgs  = mBenchmarks[idx].arguments.size();
+        int ttlTplts = mBenchmarks[idx].templates.size();
+        return mArgIdx+1 <= ttlArgs && mArgIdx2+1 <= ttlArgs && mTpltIdx+1 <= ttlTplts && mTpltIdx2+1 <= ttlTplts;
+    }
+    
+    quint64 hash(int idx) const
+    {
+        int ttlArgs  = mBenchmarks[idx].arguments.size();
+        int ttlTplts = mBenchmarks[idx].templates.size();
+        
+        quint64 h = mix(0, mDims.baseNames().codes[idx]);
+        h = mix(h, ttlTplts);
+        for (int i=0; i<ttlTplts; ++i)
+            h = mix(h, templateCode(i, idx));
+        h = mix(h, ttlArgs);
+        for (int i=0; i<ttlArgs; ++i)
+            h = mix(h, argumentCode(i, idx));
+        
+        return h;
+    }
+    
+    bool equal(int idxA, int idxB) const
+    {
+        int ttlArgs  = mBenchmarks[idxA].arguments.size();
+        int ttlTplts = mBenchmarks[idxA].templates.size();
+        if (   mDims.baseNames().codes[idxA] != mDims.baseNames().codes[idxB]
+            || ttlArgs != mBenchmarks[idxB].arguments.size() || ttlTplts != mBenchmarks[idxB].templates.size() )
+            return false;
+        
+        for (int i=0; i<ttlTplts; ++i)
+            if (templateCode(i, idxA) != templateCode(i, idxB)) return false;
+        for (int i=0; i<ttlArgs; ++i)
+            if (argumentCode(i, idxA) != argumentCode(i, idxB)) return false;
+        
+        return true;
+    }
+    
+private:
+    int templateCode(int tpltIdx, int idx) const
+    {
+        return tpltIdx == mTpltIdx || tpltIdx == mTpltIdx2 ? -1 : mDims.templateParam(tpltIdx).codes[idx];
+    }
+    int argumentCode(int argIdx, int idx) const
+    {
+        return argIdx == mArgIdx || argIdx == mArgIdx2 ? -1 : mDims.argument(argIdx).codes[idx];
+    }
+    static quint64 mix(quint64 h, int value)
+    {
+        h ^= static_cast<quint32>(value) + 0x9E3779B97F4A7C15ULL + (h << 6) + (h >> 2);
+        return h * 0xFF51AFD7ED558CCDULL;
+    }
+    
+    const QVector<BenchData> &mBenchmarks;
+    const BenchDimensions &mDims;
+    int mArgIdx, mTpltIdx, mArgIdx2, mTpltIdx2;
+};
+
+// Each 'full name % masked params' from index vector in its own subset
+// (grouped on structural key, name only built once per subset)
+static QVector<BenchSubset> groupNames(const BenchResults &bchResults, const QVector<int> &subset,
+                                       int argIdx, int tpltIdx, const QString &glyph,
+                                       int argIdx2 = -1, int tpltIdx2 = -1, const QString &glyph2 = "")
+{
+    BenchDimensions fallback;
+    const BenchDimensions &dims = validDimensions(bchResults, fallback);
+    NameKey nameKey(bchResults, dims, argIdx, tpltIdx, argIdx2, tpltIdx2);
+    
     QVector<BenchSubset> nameRes;
-    QMap<QString, int> nameMap;
+    QHash<quint64, int> nameMap;    // key hash -> first subset
+    QVector<int> nextSubset;        // next subset with same key hash (-1 if none)
     
     for (int idx : subset)
     {
-        if (idx >= benchmarks.size())
+        if (idx < 0 || idx >= bchResults.benchmarks.size())
             continue; //No longer exists
+        if ( !nameKey.isCompatible(idx) )
+            continue; //Ignore if incompatible
         
-        const BenchData &bchData = benchmarks[idx];
-        QString difName;
-        if (isArg1) {
-            if (isArg2)
-                difName = extractData(bchData, idx1, -1, "X", idx2, -1, "Z");
-            else
-                difName = extractData(bchData, idx1, -1, "X", -1, idx2, "Z");
-        }
-        else {
-            if (isArg2)
-                difName = extractData(bchData, -1, idx1, "X", idx2, -1, "Z");
-            else
-                difName = extractData(bchData, -1, idx1, "X", -1, idx2, "Z");
-        }
+        // Find subset (check hash collisions)
+        quint64 hash = nameKey.hash(idx);
+        int subIdx = nameMap.value(hash, -1);
+        while (subIdx >= 0 && !nameKey.equal(nameRes[subIdx].idxs.front(), idx))
+            subIdx = nextSubset[subIdx];
         
-        if ( !nameMap.contains(difName) )
+        if (subIdx < 0)
         {
-            nameMap[difName] = nameRes.size();
-            nameRes.push_back( BenchSubset(difName) );
+            subIdx = nameRes.size();
+            nextSubset.push_back( nameMap.value(hash, -1) );
+            nameMap.insert(hash, subIdx);
+            nameRes.push_back( BenchSubset(BenchResults::extractData(bchResults.benchmarks[idx],
+                                                                      argIdx, tpltIdx, glyph,
+                                                                      argIdx2, tpltIdx2, glyph2)) );
         }
         // Append to associated entry
-        nameRes[nameMap[difName]].idxs.push_back(idx);
+        nameRes[subIdx].idxs.push_back(idx);
     }
+    
+    return nameRes;
+}
+
+/**************************************************************************************************/
+
+QVector<BenchSubset> BenchResults::segment2DNames(const QVector<int> &subset,
+                                    bool isArg1, int idx1, bool isArg2, int idx2) const
+{
+    QVector<BenchSubset> nameRes = groupNames(*this, subset, isArg1 ? idx1 : -1, isArg1 ? -1 : idx1, "X",
+                                                             isArg2 ? idx2 : -1, isArg2 ? -1 : idx2, "Z");
     for (const BenchSubset& sub : std::as_const(nameRes))
         if (BCHRES_DEBUG) qDebug() << "nameSub:" << sub.name << "->" << sub.idxs;
     
@@ -364,26 +501,14 @@ QVector<BenchSubset> BenchResults::segment2DNames(const QVector<int> &subset,
 
 QVector<BenchSubset> BenchResults::segmentArguments(const QVector<int> &subset, int argIdx) const
 {
-    QVector<BenchSubset> argRes;
-    QMap<QString, int> argMap;
+    BenchDimensions fallback;
+    const BenchDimensions &dims = validDimensions(*this, fallback);
+    if (argIdx < 0 || argIdx >= dims.argumentCount())
+        return QVector<BenchSubset>();
     
-    for (int idx : subset)
-    {
-        if (idx >= benchmarks.size())
-            continue; //No longer exists
-        
-        const BenchData &bchData = benchmarks[idx];
-        if (bchData.arguments.size() <= argIdx) continue;
-        
-        const QString &param = bchData.arguments[argIdx];
-        if ( !argMap.contains(param) )
-        {
-            argMap[param] = argRes.size();
-            argRes.push_back( BenchSubset(param) ); //Full name but param
-        }
-        // Append to associated entry
-        argRes[argMap[param]].idxs.push_back(idx);
-    }
+    const BenchDimension &dim = dims.argument(argIdx);
+    QVector<BenchSubset> argRes = isWholeSet(subset, benchmarks.size()) ? dim.subsets
+                                                                        : segmentDimension(dim, subset);
     for (const BenchSubset& sub : std::as_const(argRes))
         if (BCHRES_DEBUG) qDebug() << "argSub:" << sub.name << "->" << sub.idxs;
     
@@ -394,26 +519,14 @@ QVector<BenchSubset> BenchResults::segmentArguments(const QVector<int> &subset,
 
 QVector<BenchSubset> BenchResults::segmentTemplates(const QVector<int> &subset, int tpltIdx) const
 {
-    QVector<BenchSubset> tpltRes;
-    QMap<QString, int> tpltMap;
+    BenchDimensions fallback;
+    const BenchDimensions &dims = validDimensions(*this, fallback);
+    if (tpltIdx < 0 || tpltIdx >= dims.templateCount())
+        return QVector<BenchSubset>();
     
-    for (int idx : subset)
-    {
-        if (idx >= benchmarks.size())
-            continue; //No longer exists
-        
-        const BenchData &bchData = benchmarks[idx];
-        if (bchData.templates.size() <= tpltIdx) continue;
-        
-        const QString &param = bchData.templates[tpltIdx];
-        if ( !tpltMap.contains(param) )
-        {
-            tpltMap[param] = tpltRes.size();
-            tpltRes.push_back( BenchSubset(param) );
-        }
-        // Append to associated entry
-        tpltRes[tpltMap[param]].idxs.push_back(idx);
-    }
+    const BenchDimension &dim = dims.templateParam(tpltIdx);
+    QVector<BenchSubset> tpltRes = isWholeSet(subset, benchmarks.size()) ? dim.subsets
+                                                                         : segmentDimension(dim, subset);
     for (const BenchSubset& sub : std::as_const(tpltRes))
         if (BCHRES_DEBUG) qDebug() << "templateSub:" << sub.name << "->" << sub.idxs;
     
@@ -436,27 +549,7 @@ QVector<BenchSubset> BenchResults::segmentParam(bool isArgument, const QVector<i
 QVector<BenchSubset> BenchResults::groupArgument(const QVector<int> &subset,
                                                  int argIdx, const QString &argGlyph) const
 {
-    QVector<BenchSubset> argRes;
-    QMap<QString, int> argMap;
-    
-    for (int idx : subset)
-    {
-        if (idx >= benchmarks.size())
-            continue; //No longer exists
-        
-        const BenchData &bchData = benchmarks[idx];
-        const QString &bchID = extractArgument(bchData, argIdx, argGlyph);
-        if ( bchID.isEmpty() )
-            continue; //Ignore if incompatible
-        
-        if ( !argMap.contains(bchID) )
-        {
-            argMap[bchID] = argRes.size(); //Add ID to map
-            argRes.push_back( BenchSubset(bchID) );
-        }
-        // Append to associated entry
-        argRes[argMap[bchID]].idxs.push_back(idx);
-    }
+    QVector<BenchSubset> argRes = groupNames(*this, subset, argIdx, -1, argGlyph);
     for (const BenchSubset& sub : std::as_const(argRes))
         if (BCHRES_DEBUG) qDebug() << "argGSub:" << sub.name << "->" << sub.idxs;
     
@@ -468,27 +561,7 @@ QVector<BenchSubset> BenchResults::groupArgument(const QVector<int> &subset,
 QVector<BenchSubset> BenchResults::groupTemplate(const QVector<int> &subset,
                                                  int tpltIdx, const QString &tpltGlyph) const
 {
-    QVector<BenchSubset> tpltRes;
-    QMap<QString, int> tpltMap;
-    
-    for (int idx : subset)
-    {
-        if (idx >= benchmarks.size())
-            continue; //No longer exists
-
-        const BenchData &bchData = benchmarks[idx];
-        const QString &bchID = extractTemplate(bchData, tpltIdx, tpltGlyph);
-        if ( bchID.isEmpty() )
-            continue; //Ignore if incompatible
-        
-        if ( !tpltMap.contains(bchID) )
-        {
-            tpltMap[bchID] = tpltRes.size(); //Add ID to map
-            tpltRes.push_back( BenchSubset(bchID) );
-        }
-        // Append to associated entry
-        tpltRes[tpltMap[bchID]].idxs.push_back(idx);
-    }
+    QVector<BenchSubset> tpltRes = groupNames(*this, subset, -1, tpltIdx, tpltGlyph);
     for (const BenchSubset& sub : std::as_const(tpltRes))
         if (BCHRES_DEBUG) qDebug() << "tpltGSub:" << sub.name << "->" << sub.idxs;
     
@@ -530,43 +603,81 @@ QString BenchResults::getParamName(bool isArgument, int benchIdx, int paramIdx)
     return benchmarks[benchIdx].templates[paramIdx];
 }
 
+double BenchResults::getParamValue(bool isArgument, int benchIdx, int paramIdx, QString &custDataName,
+                                   bool &custDataAxis, double &fallbackIdx) const
+{
+    // Not parsed yet
+    if ( !hasDimensions() )
+        return getParamValue(getParamName(isArgument, benchIdx, paramIdx), custDataName, custDataAxis, fallbackIdx);
+    
+    const BenchDimension &dim = isArgument ? dimensions.argument(paramIdx) : dimensions.templateParam(paramIdx);
+    Q_ASSERT(dim.codes[benchIdx] >= 0);
+    return getParamValue(dim.values[dim.codes[benchIdx]], custDataName, custDataAxis, fallbackIdx);
+}
+
+ParamValueType BenchResults::getParamAxisType(bool isArgument, int paramIdx, QString &custDataName) const
+{
+    // Not parsed yet (values classified one by one)
+    if ( !hasDimensions() || paramIdx < 0
+         || paramIdx >= (isArgument ? dimensions.argumentCount() : dimensions.templateCount()) )
+        return ParamNameType;
+    
+    const BenchDimension &dim = isArgument ? dimensions.argument(paramIdx) : dimensions.templateParam(paramIdx);
+    if (dim.axisType == ParamDataSizeType && custDataName.isEmpty())
+        custDataName = data_size_name;
+    
+    return dim.axisType;
+}
+
+double BenchResults::getParamNumber(bool isArgument, int benchIdx, int paramIdx) const
+{
+    Q_ASSERT(hasDimensions());
+    const BenchDimension &dim = isArgument ? dimensions.argument(paramIdx) : dimensions.templateParam(paramIdx);
+    int code = dim.codes[benchIdx];
+    return code >= 0 ? dim.values[code].value : 0.;
+}
+
 /**************************************************************************************************/
 /**************************************************************************************************/
 
-void BenchResults::appendResults(const BenchResults &bchRes)
+void BenchResults::appendResults(BenchResults &&bchRes, bool update)
 {
+    // Existing names
+    if (names.size() != this->benchmarks.size()) {
+        names.build(this->benchmarks);
+        suffixes.clear();
+    }
+    ++revision;
+    
     // Benchmarks
-    for (const auto& newBench : std::as_const(bchRes.benchmarks))
+    this->benchmarks.reserve(this->benchmarks.size() + bchRes.benchmarks.size());
+    for (auto& newBench : bchRes.benchmarks)
     {
-        // Rename if needed
+        // Rename if needed (smallest free suffix, probed from last one used for same name as names stay taken)
         QString tempName = newBench.name;
-        int suffix = 1;
-        
-        int idx;
-        do {
-            idx = -1;
-            for (int i=0; idx<0 && i<this->benchmarks.size(); ++i)
-                if (this->benchmarks[i].name == tempName) idx = i;
-            
-            if (idx >= 0) {
+        int suffix = 0;
+        if ( names.contains(tempName) )
+        {
+            suffix = suffixes.value(newBench.name, 1);
+            do {
                 tempName = newBench.name;
                 tempName.insert(newBench.base_name.size(), "_" + QString::number(++suffix));
-            }
-        } while (idx >= 0);
-        
-        // Apply and append
-        if (newBench.name == tempName)
-            this->benchmarks.append(newBench);
-        else {
-            BenchData cpyBench = newBench;
-            cpyBench.name     = tempName;
-            cpyBench.run_name = tempName;
-            cpyBench.base_name += "_" + QString::number(suffix);
-            
-            this->benchmarks.append(cpyBench);
+            } while ( names.contains(tempName) );
         }
         if (BCHRES_DEBUG) qDebug() << "newBench:" << newBench.name << "|" << tempName;
+        
+        // Apply and append (strings moved to own pool)
+        if (newBench.name != tempName) {
+            suffixes.insert(newBench.name, suffix);
+            newBench.name     = tempName;
+            newBench.run_name = tempName;
+            newBench.base_name += "_" + QString::number(suffix);
+        }
+        strings.intern(newBench);
+        names.append(newBench.name);
+        this->benchmarks.append( std::move(newBench) );
     }
+    bchRes.benchmarks.clear();
     
     // Meta
     if (this->meta.maxArguments < bchRes.meta.maxArguments)
@@ -581,24 +692,43 @@ void BenchResults::appendResults(const BenchResults &bchRes)
     this->meta.hasCv         |= bchRes.meta.hasCv;
     this->meta.hasBytesSec   |= bchRes.meta.hasBytesSec;
     this->meta.hasItemsSec   |= bchRes.meta.hasItemsSec;
+    for (int aggId : std::as_const(bchRes.meta.customAggregates))
+        if ( !this->meta.customAggregates.contains(aggId) )
+            this->meta.customAggregates.append(aggId);
+    for (int aggId : std::as_const(bchRes.meta.percentAggregates))
+        if ( !this->meta.percentAggregates.contains(aggId) )
+            this->meta.percentAggregates.append(aggId);
+    
+    if (update)
+        updateDerived();
 }
 
 /**************************************************************************************************/
 
-void BenchResults::overwriteResults(const BenchResults &bchRes)
+void BenchResults::overwriteResults(BenchResults &&bchRes, bool update)
 {
+    // Existing names
+    if (names.size() != this->benchmarks.size()) {
+        names.build(this->benchmarks);
+        suffixes.clear();
+    }
+    ++revision;
+    
     // Benchmarks
-    for (const auto& newBench : std::as_const(bchRes.benchmarks))
+    for (auto& newBench : bchRes.benchmarks)
     {
-        int idx = -1;
-        for (int i=0; idx<0 && i<this->benchmarks.size(); ++i)
-            if (this->benchmarks[i].name == newBench.name) idx = i;
+        // Strings moved to own pool
+        strings.intern(newBench);
         
-        if (idx < 0)
-            this->benchmarks.append(newBench);
+        int idx = names.indexOf(newBench.name);
+        if (idx < 0) {
+            names.append(newBench.name);
+            this->benchmarks.append( std::move(newBench) );
+        }
         else
-            this->benchmarks[idx] = newBench;
+            this->benchmarks[idx] = std::move(newBench);
     }
+    bchRes.benchmarks.clear();
     
     // Meta
     if (this->meta.maxArguments < bchRes.meta.maxArguments)
@@ -613,6 +743,595 @@ void BenchResults::overwriteResults(const BenchResults &bchRes)
     this->meta.hasCv         |= bchRes.meta.hasCv;
     this->meta.hasBytesSec   |= bchRes.meta.hasBytesSec;
     this->meta.hasItemsSec   |= bchRes.meta.hasItemsSec;
+    for (int aggId : std::as_const(bchRes.meta.customAggregates))
+        if ( !this->meta.customAggregates.contains(aggId) )
+            this->meta.customAggregates.append(aggId);
+    for (int aggId : std::as_const(bchRes.meta.percentAggregates))
+        if ( !this->meta.percentAggregates.contains(aggId) )
+            this->meta.percentAggregates.append(aggId);
+    
+    if (update)
+        updateDerived();
 }
 
 /**************************************************************************************************/
+
+void BenchNameIndex::build(const QVector<BenchData> &benchmarks)
+{
+    mSize = 0;
+    mIndexes.clear();
+    mIndexes.reserve(benchmarks.size());
+    for (const auto& bchData : benchmarks)
+        append(bchData.name);
+}
+
+void BenchNameIndex::append(const QString &name)
+{
+    if ( !mIndexes.contains(name) )
+        mIndexes.insert(name, mSize);
+    ++mSize;
+}
+
+/**************************************************************************************************/
+
+void BenchResults::updateDerived()
+{
+    columns.build(benchmarks, revision);
+    dimensions.build(benchmarks, revision);
+}
+
+void BenchResults::updateDerived(int changedFrom)
+{
+    columns.update(benchmarks, changedFrom, revision);
+    dimensions.update(benchmarks, changedFrom, revision);
+    
+    // Appended names (merged benchmarks keep theirs)
+    if (names.size() > 0 && names.size() <= benchmarks.size())
+        for (int i=names.size(); i<benchmarks.size(); ++i)
+            names.append(benchmarks[i].name);
+}
+
+void BenchResults::internStrings()
+{
+    for (auto& bchData : benchmarks)
+        strings.intern(bchData);
+}
+
+/**************************************************************************************************/
+
+BenchSnapshot makeSnapshot(BenchResults &&bchResults)
+{
+    static QAtomicInteger<quint64> lastVersion;
+    
+    QSharedPointer<BenchResults> snapshot = QSharedPointer<BenchResults>::create( std::move(bchResults) );
+    snapshot->version = ++lastVersion;
+    
+    return snapshot;
+}
+
+/**************************************************************************************************/
+
+// Names registry (shared by parsing threads)
+static QMutex aggregateNamesMutex;
+static QHash<QString, int> aggregateNamesIds;
+static QStringList aggregateNamesList;
+
+int AggregateNames::id(const QString &name)
+{
+    QMutexLocker locker(&aggregateNamesMutex);
+    int id = aggregateNamesIds.value(name, -1);
+    if (id < 0)
+    {
+        id = aggregateNamesList.size();
+        aggregateNamesIds.insert(name, id);
+        aggregateNamesList.append(name);
+    }
+    
+    return id;
+}
+
+QString AggregateNames::name(int id)
+{
+    QMutexLocker locker(&aggregateNamesMutex);
+    if (id < 0 || id >= aggregateNamesList.size())
+        return QString();
+    
+    return aggregateNamesList[id];
+}
+
+/**************************************************************************************************/
+
+const BenchCustomAggregate* BenchAggregate::findCustom(int id) const
+{
+    for (const auto& value : custom)
+        if (value.id == id)
+            return &value;
+    
+    return nullptr;
+}
+
+void BenchAggregate::setCustom(const BenchCustomAggregate &value)
+{
+    auto it = std::lower_bound(custom.begin(), custom.end(), value.id,
+                               [](const BenchCustomAggregate &lhs, int id) { return lhs.id < id; });
+    if (it != custom.end() && it->id == value.id)
+        *it = value;
+    else
+        custom.insert(it, value);
+}
+
+/**************************************************************************************************/
+
+QString StringPool::intern(const QString &value)
+{
+    int id = mIds.value(value, -1);
+    if (id < 0)
+        id = add(value);
+    
+    return mStrings[id];
+}
+
+QString StringPool::intern(QByteArrayView utf8)
+{
+    // Lookup without copy
+    int id = mUtf8Ids.value(QByteArray::fromRawData(utf8.data(), utf8.size()), -1);
+    if (id < 0)
+    {
+        // Decoded once, may already be pooled (e.g. interned as QString when merging)
+        QString value = QString::fromUtf8(utf8);
+        id = mIds.value(value, -1);
+        if (id < 0)
+            id = add(value);
+        mUtf8Ids.insert(utf8.toByteArray(), id);
+    }
+    
+    return mStrings[id];
+}
+
+QStringList StringPool::intern(const QStringList &values)
+{
+    QStringList pooled;
+    pooled.reserve(values.size());
+    for (const auto& value : values)
+        pooled.append( intern(value) );
+    
+    return pooled;
+}
+
+void StringPool::intern(BenchData &bchData)
+{
+    bchData.name      = intern(bchData.name);
+    bchData.run_name  = intern(bchData.run_name);
+    bchData.run_type  = intern(bchData.run_type);
+    bchData.base_name = intern(bchData.base_name);
+    bchData.family    = intern(bchData.family);
+    bchData.container = intern(bchData.container);
+    bchData.arguments = intern(bchData.arguments);
+    bchData.templates = intern(bchData.templates);
+}
+
+void StringPool::clear()
+{
+    mStrings.clear();
+    mIds.clear();
+    mUtf8Ids.clear();
+}
+
+int StringPool::add(const QString &value)
+{
+    int id = mStrings.size();
+    QString pooled = value;
+    pooled.squeeze();   // no spare capacity (e.g. after truncate)
+    mStrings.append(pooled);
+    mIds.insert(pooled, id);
+    
+    return id;
+}
+
+/**************************************************************************************************/
+
+void BenchDimensions::build(const QVector<BenchData> &benchmarks, quint64 revision)
+{
+    // Reset
+    mSize = 0;
+    mFamilies   = BenchDimension();
+    mContainers = BenchDimension();
+    mBaseNames  = BenchDimension();
+    mFamilyContainers.clear();
+    mArguments.clear();
+    mTemplates.clear();
+    
+    update(benchmarks, 0, revision);
+}
+
+void BenchDimensions::update(const QVector<BenchData> &benchmarks, int changedFrom, quint64 revision)
+{
+    int from = std::max(0, std::min(changedFrom, mSize));
+    
+    /*
+     * Remove changed benchmarks (last indexes of their subsets, new codes last)
+     */
+    for (int i=mSize-1; i>=from; --i)
+    {
+        // Family -> containers hierarchy
+        int famCode = mFamilies.codes[i], ctnCode = mContainers.codes[i];
+        QVector<BenchSubset> &famCtns = mFamilyContainers[famCode];
+        for (auto& ctnSub : famCtns) {
+            if (mContainers.codes[ctnSub.idxs.front()] == ctnCode) {
+                ctnSub.idxs.removeLast();
+                break;
+            }
+        }
+        while ( !famCtns.isEmpty() && famCtns.constLast().idxs.isEmpty() )
+            famCtns.removeLast();
+    }
+    auto truncate = [from, this](BenchDimension &dim) {
+        for (int i=mSize-1; i>=from; --i)
+            if (dim.codes[i] >= 0)
+                dim.subsets[dim.codes[i]].idxs.removeLast();
+        while ( !dim.subsets.isEmpty() && dim.subsets.constLast().idxs.isEmpty() )
+            dim.subsets.removeLast();
+        dim.codes.resize(from);
+        if (dim.values.size() > dim.subsets.size())
+            dim.values.resize(dim.subsets.size());
+    };
+    truncate(mFamilies);
+    truncate(mContainers);
+    truncate(mBaseNames);
+    for (auto& dim : mArguments)
+        truncate(dim);
+    for (auto& dim : mTemplates)
+        truncate(dim);
+    while ( !mArguments.isEmpty() && mArguments.constLast().subsets.isEmpty() )
+        mArguments.removeLast();
+    while ( !mTemplates.isEmpty() && mTemplates.constLast().subsets.isEmpty() )
+        mTemplates.removeLast();
+    mFamilyContainers.resize(mFamilies.subsets.size());
+    
+    /*
+     * Append changed benchmarks
+     */
+    mSize = benchmarks.size();
+    mRevision = revision;
+    
+    int maxArguments = mArguments.size(), maxTemplates = mTemplates.size();
+    for (int i=from; i<mSize; ++i) {
+        maxArguments = std::max(maxArguments, int(benchmarks[i].arguments.size()));
+        maxTemplates = std::max(maxTemplates, int(benchmarks[i].templates.size()));
+    }
+    mArguments.resize(maxArguments);
+    mTemplates.resize(maxTemplates);
+    
+    // Codes of kept values (first appearance order)
+    auto dictionary = [this](BenchDimension &dim) {
+        QHash<QString, int> dict;
+        dict.reserve(dim.subsets.size());
+        for (int code=0; code<dim.subsets.size(); ++code)
+            dict.insert(dim.subsets[code].name, code);
+        int kept = dim.codes.size();
+        dim.codes.resize(mSize);
+        std::fill(dim.codes.begin() + kept, dim.codes.end(), -1);
+        return dict;
+    };
+    QHash<QString, int> famDict = dictionary(mFamilies), ctnDict = dictionary(mContainers);
+    QHash<QString, int> baseDict = dictionary(mBaseNames);
+    QVector<QHash<QString, int>> argDicts(maxArguments), tpltDicts(maxTemplates);
+    for (int j=0; j<maxArguments; ++j)
+        argDicts[j] = dictionary(mArguments[j]);
+    for (int j=0; j<maxTemplates; ++j)
+        tpltDicts[j] = dictionary(mTemplates[j]);
+    
+    // Container subsets of families (family code and container code)
+    QHash<quint64, int> famCtnMap;
+    for (int famCode=0; famCode<mFamilyContainers.size(); ++famCode) {
+        const QVector<BenchSubset> &famCtns = mFamilyContainers[famCode];
+        for (int sub=0; sub<famCtns.size(); ++sub)
+            famCtnMap.insert(quint64(famCode) << 32 | quint32(mContainers.codes[famCtns[sub].idxs.front()]), sub);
+    }
+    
+    // Encode
+    auto encode = [](BenchDimension &dim, QHash<QString, int> &dict, int idx, const QString &value) {
+        auto it = dict.constFind(value);
+        if (it == dict.constEnd()) {
+            it = dict.insert(value, dim.subsets.size());
+            dim.subsets.append( BenchSubset(value) );
+        }
+        dim.codes[idx] = it.value();
+        dim.subsets[it.value()].idxs.append(idx);
+    };
+    for (int i=from; i<mSize; ++i)
+    {
+        const BenchData &bchData = benchmarks[i];
+        encode(mFamilies,   famDict,  i, bchData.family);
+        encode(mContainers, ctnDict,  i, bchData.container);
+        encode(mBaseNames,  baseDict, i, bchData.base_name);
+        for (int j=0; j<bchData.arguments.size(); ++j)
+            encode(mArguments[j], argDicts[j], i, bchData.arguments[j]);
+        for (int j=0; j<bchData.templates.size(); ++j)
+            encode(mTemplates[j], tpltDicts[j], i, bchData.templates[j]);
+        
+        // Family -> containers hierarchy
+        int famCode = mFamilies.codes[i], ctnCode = mContainers.codes[i];
+        if (famCode >= mFamilyContainers.size())
+            mFamilyContainers.resize(famCode + 1);
+        QVector<BenchSubset> &famCtns = mFamilyContainers[famCode];
+        quint64 key = quint64(famCode) << 32 | quint32(ctnCode);
+        auto it = famCtnMap.constFind(key);
+        if (it == famCtnMap.constEnd()) {
+            it = famCtnMap.insert(key, famCtns.size());
+            famCtns.append( BenchSubset(mContainers.subsets[ctnCode].name) );
+        }
+        famCtns[it.value()].idxs.append(i);
+    }
+    
+    // Parameter values (once per distinct value)
+    auto parseValues = [](BenchDimension &dim) {
+        int parsed = dim.values.size();
+        dim.values.resize(dim.subsets.size());
+        for (int code=parsed; code<dim.subsets.size(); ++code)
+            dim.values[code] = BenchResults::parseParamValue(dim.subsets[code].name);
+        
+        dim.axisType = !dim.values.isEmpty() ? dim.values.front().type : ParamNameType;
+        for (const auto& value : std::as_const(dim.values))
+            if (dim.axisType != value.type)
+                dim.axisType = ParamNameType;
+    };
+    for (auto& dim : mArguments)
+        parseValues(dim);
+    for (auto& dim : mTemplates)
+        parseValues(dim);
+}
+
+/**************************************************************************************************/
+
+void BenchColumns::build(const QVector<BenchData> &benchmarks, quint64 revision)
+{
+    mSize = 0;
+    mAggregateRows.clear();
+    mHasAggregate.clear();
+    for (int col=0; col<MinRealColumn; ++col) {
+        mRepetitions[col].clear();
+        mRepetitionOffsets[col].clear();
+    }
+    update(benchmarks, 0, revision);
+    
+    for (int col=0; col<ColumnCount; ++col)
+        mColumns[col].squeeze();
+    mAggregateRows.squeeze();
+    mHasAggregate.squeeze();
+    for (int col=0; col<MinRealColumn; ++col) {
+        mRepetitions[col].squeeze();
+        mRepetitionOffsets[col].squeeze();
+    }
+}
+
+void BenchColumns::update(const QVector<BenchData> &benchmarks, int changedFrom, quint64 revision)
+{
+    int from = std::max(0, std::min(changedFrom, mSize));
+    
+    // Aggregate rows of kept benchmarks
+    int aggCount = mHasAggregate.size();
+    for (int i=from; i<mSize; ++i)
+        if (mAggregateRows[i] >= 0) --aggCount;
+    
+    // Their sorted repetitions (changed rows appended again by setRow, in order)
+    for (int col=0; col<MinRealColumn; ++col) {
+        mRepetitionOffsets[col].resize(aggCount + 1);
+        mRepetitions[col].resize(mRepetitionOffsets[col][aggCount]);
+    }
+    
+    // Aggregate rows of changed benchmarks
+    mSize = benchmarks.size();
+    mRevision = revision;
+    mAggregateRows.resize(mSize);
+    for (int i=from; i<mSize; ++i)
+        mAggregateRows[i] = benchmarks[i].aggregate_block.constData() != nullptr ? aggCount++ : -1;
+    
+    for (int col=0; col<ColumnCount; ++col)
+        mColumns[col].resize(col < MinRealColumn ? mSize : aggCount);
+    mHasAggregate.resize(aggCount);
+    
+    // Fill
+    for (int i=from; i<mSize; ++i)
+        setRow(i, benchmarks[i]);
+}
+
+void BenchColumns::setRow(int idx, const BenchData &bchData)
+{
+    // Default
+    mColumns[RealTimeColumn][idx]   = bchData.real_time_us;
+    mColumns[CpuTimeColumn][idx]    = bchData.cpu_time_us;
+    mColumns[IterationsColumn][idx] = bchData.iterations;
+    mColumns[KBytesColumn][idx]     = bchData.kbytes_sec_dflt;
+    mColumns[KItemsColumn][idx]     = bchData.kitems_sec_dflt;
+    
+    // Aggregate
+    int row = mAggregateRows[idx];
+    if (row < 0)
+        return;
+    const BenchAggregate &agg = bchData.aggregates();
+    mHasAggregate[row] = bchData.hasAggregate;
+    appendRepetitions(RealTimeColumn,   bchData.real_time);
+    appendRepetitions(CpuTimeColumn,    bchData.cpu_time);
+    appendRepetitions(IterationsColumn, QVector<double>());     // (empty range)
+    appendRepetitions(KBytesColumn,     bchData.kbytes_sec);
+    appendRepetitions(KItemsColumn,     bchData.kitems_sec);
+    
+    mColumns[MinRealColumn][row]      = agg.min_real;
+    mColumns[MinCpuColumn][row]       = agg.min_cpu;
+    mColumns[MinKBytesColumn][row]    = agg.min_kbytes;
+    mColumns[MinKItemsColumn][row]    = agg.min_kitems;
+    mColumns[MaxRealColumn][row]      = agg.max_real;
+    mColumns[MaxCpuColumn][row]       = agg.max_cpu;
+    mColumns[MaxKBytesColumn][row]    = agg.max_kbytes;
+    mColumns[MaxKItemsColumn][row]    = agg.max_kitems;
+    mColumns[MeanRealColumn][row]     = agg.mean_real;
+    mColumns[MeanCpuColumn][row]      = agg.mean_cpu;
+    mColumns[MeanKBytesColumn][row]   = agg.mean_kbytes;
+    mColumns[MeanKItemsColumn][row]   = agg.mean_kitems;
+    mColumns[MedianRealColumn][row]   = agg.median_real;
+    mColumns[MedianCpuColumn][row]    = agg.median_cpu;
+    mColumns[MedianKBytesColumn][row] = agg.median_kbytes;
+    mColumns[MedianKItemsColumn][row] = agg.median_kitems;
+    mColumns[StddevRealColumn][row]   = agg.stddev_real;
+    mColumns[StddevCpuColumn][row]    = agg.stddev_cpu;
+    mColumns[StddevKBytesColumn][row] = agg.stddev_kbytes;
+    mColumns[StddevKItemsColumn][row] = agg.stddev_kitems;
+    mColumns[CvRealColumn][row]       = agg.cv_real;
+    mColumns[CvCpuColumn][row]        = agg.cv_cpu;
+    mColumns[CvKBytesColumn][row]     = agg.cv_kbytes;
+    mColumns[CvKItemsColumn][row]     = agg.cv_kitems;
+}
+
+void BenchColumns::appendRepetitions(BenchColumn column, const QVector<double> &values)
+{
+    QVector<double> &repetitions = mRepetitions[column];
+    int begin = repetitions.size();
+    repetitions.append(values);
+    std::sort(repetitions.begin() + begin, repetitions.end());
+    mRepetitionOffsets[column].append( repetitions.size() );
+}
+
+/**************************************************************************************************
+*
+* Memory usage
+*
+**************************************************************************************************/
+
+// Heap array header (Qt 6 QArrayData)
+static const qint64 array_header = 16;
+
+template<typename T>
+static qint64 vectorMemory(const QVector<T> &vec)
+{
+    return vec.capacity() > 0 ? array_header + vec.capacity() * static_cast<qint64>(sizeof(T)) : 0;
+}
+
+static qint64 stringMemory(const QString &str)
+{
+    return str.capacity() > 0 ? array_header + (str.capacity() + 1) * 2 : 0;
+}
+
+static qint64 byteArrayMemory(const QByteArray &bytes)
+{
+    return bytes.capacity() > 0 ? array_header + bytes.capacity() + 1 : 0;
+}
+
+// Buckets (two per capacity, one offset byte each) and nodes (keys/values content excluded)
+template<typename K, typename V>
+static qint64 hashMemory(const QHash<K, V> &hash)
+{
+    return hash.capacity() > 0 ? hash.capacity() * 2 + hash.size() * static_cast<qint64>(sizeof(K) + sizeof(V)) : 0;
+}
+
+static qint64 subsetsMemory(const QVector<BenchSubset> &subsets)
+{
+    qint64 bytes = vectorMemory(subsets);
+    for (const auto& subset : subsets)
+        bytes += vectorMemory(subset.idxs);
+    return bytes;
+}
+
+static qint64 dimensionMemory(const BenchDimension &dim)
+{
+    return subsetsMemory(dim.subsets) + vectorMemory(dim.codes) + vectorMemory(dim.values);
+}
+
+/**************************************************************************************************/
+
+qint64 StringPool::memorySize() const
+{
+    // Ids keys share pooled strings
+    qint64 bytes = vectorMemory(mStrings) + hashMemory(mIds) + hashMemory(mUtf8Ids);
+    for (const auto& str : mStrings)
+        bytes += stringMemory(str);
+    for (auto it = mUtf8Ids.cbegin(); it != mUtf8Ids.cend(); ++it)
+        bytes += byteArrayMemory(it.key());
+    
+    return bytes;
+}
+
+qint64 BenchColumns::memorySize() const
+{
+    qint64 bytes = vectorMemory(mAggregateRows) + vectorMemory(mHasAggregate);
+    for (int col=0; col<ColumnCount; ++col)
+        bytes += vectorMemory(mColumns[col]);
+    for (int col=0; col<MinRealColumn; ++col)
+        bytes += vectorMemory(mRepetitions[col]) + vectorMemory(mRepetitionOffsets[col]);
+    
+    return bytes;
+}
+
+qint64 BenchDimensions::memorySize() const
+{
+    qint64 bytes = dimensionMemory(mFamilies) + dimensionMemory(mContainers) + dimensionMemory(mBaseNames);
+    bytes += vectorMemory(mFamilyContainers);
+    for (const auto& containers : mFamilyContainers)
+        bytes += subsetsMemory(containers);
+    bytes += vectorMemory(mArguments) + vectorMemory(mTemplates);
+    for (const auto& dim : mArguments)
+        bytes += dimensionMemory(dim);
+    for (const auto& dim : mTemplates)
+        bytes += dimensionMemory(dim);
+    
+    return bytes;
+}
+
+qint64 BenchNameIndex::memorySize() const
+{
+    return hashMemory(mIndexes);
+}
+
+BenchMemory BenchResults::memoryUsage() const
+{
+    BenchMemory usage;
+    
+    // Buffers shared by benchmarks (e.g. copied aggregate blocks or lists)
+    QSet<const void*> counted;
+    auto once = [&counted](const void *data) -> bool {
+        if (data == nullptr || counted.contains(data))
+            return false;
+        counted.insert(data);
+        return true;
+    };
+    // Strings not pooled (e.g. renamed when merged)
+    auto unpooledMemory = [this, &once](const QString &str) -> qint64 {
+        int id = strings.id(str);
+        if (id >= 0 && strings.string(id).constData() == str.constData())
+            return 0;
+        return once(str.constData()) ? stringMemory(str) : 0;
+    };
+    
+    usage.benchmarks = vectorMemory(benchmarks);
+    for (const auto& bchData : benchmarks)
+    {
+        for (const QVector<double>* vec : {&bchData.real_time, &bchData.cpu_time,
+                                          &bchData.kbytes_sec, &bchData.kitems_sec})
+            if ( once(vec->constData()) )
+                usage.repetitions += vectorMemory(*vec);
+        
+        const BenchAggregate *agg = bchData.aggregate_block.constData();
+        if ( once(agg) )
+            usage.aggregates += static_cast<qint64>(sizeof(BenchAggregate)) + vectorMemory(agg->custom);
+        
+        for (const QString* str : {&bchData.name, &bchData.run_name, &bchData.run_type,
+                                   &bchData.base_name, &bchData.family, &bchData.container})
+            usage.strings += unpooledMemory(*str);
+        for (const QStringList* list : {&bchData.arguments, &bchData.templates}) {
+            if ( once(list->constData()) )
+                usage.strings += vectorMemory(*list);
+            for (const auto& str : *list)
+                usage.strings += unpooledMemory(str);
+        }
+    }
+    usage.strings += strings.memorySize();
+    
+    // Derived data and indexes
+    usage.derived = columns.memorySize() + dimensions.memorySize();
+    usage.indexes = names.memorySize() + hashMemory(suffixes);
+    for (auto it = suffixes.cbegin(); it != suffixes.cend(); ++it)
+        usage.indexes += unpooledMemory(it.key());
+    usage.meta = vectorMemory(meta.customAggregates) + vectorMemory(meta.percentAggregates);
+    
+    return usage;
+}
@@ -0,0 +1,477 @@
+// Copyright 2019 Guillaume AUJAY. All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "chart_data.h"
+
+#include <QDebug>
+
+#include <utility>
+
+
+static inline bool isCanceled(const QAtomicInt *canceled)
+{
+    return canceled != nullptr && canceled->loadRelaxed() != 0;
+}
+
+// Axis title of X/Z-parameter (custom data name for templates, if any)
+static QString paramTitle(PlotParamType type, int idx, const QString &custDataName = QString())
+{
+    if (type == PlotArgumentType)
+        return "Argument " + QString::number(idx+1);
+    if (type == PlotTemplateType)
+        return !custDataName.isEmpty() ? custDataName : "Template " + QString::number(idx+1);
+    return QString();
+}
+
+// Keep longest labels if compatible, single empty label otherwise (collision)
+static void mergeLabels(QStringList &labels, const QStringList &newLabels, bool first)
+{
+    if (first)
+        labels = newLabels;
+    else if ( commonPartEqual(labels, newLabels) ) {
+        if (labels.size() < newLabels.size())
+            labels = newLabels;
+    }
+    else
+        labels = QStringList("");
+}
+
+// Values of X/Z-parameter (read directly if all of same type, classified one by one otherwise)
+class ParamAxis
+{
+public:
+    ParamAxis(const BenchResults &bchResults, PlotParamType type, int idx)
+        : mBchResults(bchResults), mIsArgument(type == PlotArgumentType), mIdx(idx)
+    {
+        if (type == PlotArgumentType || type == PlotTemplateType)
+            mAxisType = bchResults.getParamAxisType(mIsArgument, idx, mCustDataName);
+    }
+    
+    double value(int benchIdx, double &fallbackIdx)
+    {
+        if (mAxisType != ParamNameType)
+            return mBchResults.getParamNumber(mIsArgument, benchIdx, mIdx);
+        return mBchResults.getParamValue(mIsArgument, benchIdx, mIdx, mCustDataName, mCustDataAxis, fallbackIdx);
+    }
+    
+    const QString& custDataName() const { return mCustDataName; }
+    
+private:
+    const BenchResults &mBchResults;
+    bool mIsArgument;
+    int mIdx;
+    ParamValueType mAxisType = ParamNameType;
+    bool mCustDataAxis = true;
+    QString mCustDataName;
+};
+
+static void initBase(ChartDataBase &data, const BenchResults &bchResults, const PlotParams &plotParams)
+{
+    data.timeUnit = bchResults.meta.time_unit;
+    data.yTitle   = getYPlotName(plotParams.yType, bchResults.meta.time_unit);
+}
+
+/**************************************************************************************************/
+
+LineChartData ChartData::computeLines(const BenchResults &bchResults, const QVector<int> &bchIdxs,
+                                      const PlotParams &plotParams, const QAtomicInt *canceled)
+{
+    LineChartData data;
+    initBase(data, bchResults, plotParams);
+    
+    // X: argumentA or templateB
+    // Y: time/iter/bytes/items (not name dependent)
+    // Line: one per benchmark % X-param
+    QVector<BenchSubset> bchSubsets = bchResults.groupParam(plotParams.xType == PlotArgumentType,
+                                                            bchIdxs, plotParams.xIdx, "X");
+    ParamAxis xAxis(bchResults, plotParams.xType, plotParams.xIdx);
+    for (const auto& bchSubset : std::as_const(bchSubsets))
+    {
+        if ( isCanceled(canceled) )
+            return data;
+        
+        // Ignore single point lines
+        if (bchSubset.idxs.size() < 2) {
+            qWarning() << "Not enough points to trace line for: " << bchSubset.name;
+            continue;
+        }
+        
+        LineSeriesData series;
+        series.name = bchSubset.name;
+        series.points.reserve( bchSubset.idxs.size() );
+        
+        double xFallback = 0.;
+        for (int idx : bchSubset.idxs)
+        {
+            double xVal = xAxis.value(idx, xFallback);
+            series.points.append( QPointF(xVal, getYPlotValue(bchResults, idx, plotParams.yType)) );
+        }
+        data.series.append( std::move(series) );
+    }
+    data.xTitle = paramTitle(plotParams.xType, plotParams.xIdx, xAxis.custDataName());
+    
+    return data;
+}
+
+/**************************************************************************************************/
+
+BarChartData ChartData::computeBars(const BenchResults &bchResults, const QVector<int> &bchIdxs,
+                                    const PlotParams &plotParams, const QAtomicInt *canceled)
+{
+    BarChartData data;
+    initBase(data, bchResults, plotParams);
+    data.xTitle = paramTitle(plotParams.xType, plotParams.xIdx);
+    
+    // X: argumentA or templateB
+    // Y: time/iter/bytes/items (not name dependent)
+    // Bar: one per benchmark % X-param
+    QVector<BenchSubset> bchSubsets = bchResults.groupParam(plotParams.xType == PlotArgumentType,
+                                                            bchIdxs, plotParams.xIdx, "X");
+    if ( bchSubsets.isEmpty() )
+        qWarning() << "No compatible series to display";
+    
+    for (const auto& bchSubset : std::as_const(bchSubsets))
+    {
+        if ( isCanceled(canceled) )
+            return data;
+        
+        // Ignore empty set
+        if ( bchSubset.idxs.isEmpty() ) {
+            qWarning() << "No X-value to trace bar for:" << bchSubset.name;
+            continue;
+        }
+        
+        BarSetData set;
+        set.name = bchSubset.name;
+        set.values.reserve( bchSubset.idxs.size() );
+        
+        QStringList colLabels;
+        for (int idx : bchSubset.idxs)
+        {
+            colLabels.append( bchResults.getParamName(plotParams.xType == PlotArgumentType, idx, plotParams.xIdx) );
+            set.values.append( getYPlotValue(bchResults, idx, plotParams.yType) );
+        }
+        // Column labels (only if no collision)
+        mergeLabels(data.categories, colLabels, data.sets.isEmpty());
+        data.sets.append( std::move(set) );
+    }
+    
+    return data;
+}
+
+/**************************************************************************************************/
+
+BoxChartData ChartData::computeBoxes(const BenchResults &bchResults, const QVector<int> &bchIdxs,
+                                     const PlotParams &plotParams, const QAtomicInt *canceled)
+{
+    BoxChartData data;
+    initBase(data, bchResults, plotParams);
+    data.xTitle = paramTitle(plotParams.xType, plotParams.xIdx);
+    
+    // X: argumentA or templateB
+    // Y: time/iter/bytes/items (not name dependent)
+    // Box: one per benchmark % X-param
+    QVector<BenchSubset> bchSubsets = bchResults.groupParam(plotParams.xType == PlotArgumentType,
+                                                            bchIdxs, plotParams.xIdx, "X");
+    for (const auto& bchSubset : std::as_const(bchSubsets))
+    {
+        if ( isCanceled(canceled) )
+            return data;
+        
+        BoxSeriesData series;
+        series.name = bchSubset.name;
+        series.boxes.reserve( bchSubset.idxs.size() );
+        
+        for (int idx : bchSubset.idxs)
+        {
+            series.boxes.append({ bchResults.getParamName(plotParams.xType == PlotArgumentType, idx, plotParams.xIdx),
+                                  getYPlotStats(bchResults, idx, plotParams.yType) });
+        }
+        data.series.append( std::move(series) );
+    }
+    
+    return data;
+}
+
+/**************************************************************************************************/
+
+Bars3DChartData ChartData::compute3DBars(const BenchResults &bchResults, const QVector<int> &bchIdxs,
+                                         const PlotParams &plotParams, const QAtomicInt *canceled)
+{
+    Bars3DChartData data;
+    initBase(data, bchResults, plotParams);
+    data.xTitle = paramTitle(plotParams.xType, plotParams.xIdx);
+    data.zTitle = paramTitle(plotParams.zType, plotParams.zIdx);
+    
+    // X: argumentA or templateB
+    // Y: time/iter/bytes/items (not name dependent)
+    // Z: argumentC or templateD (with C!=A, D!=B)
+    bool hasZParam = plotParams.zType != PlotEmptyType;
+    
+    //
+    // No Z-param -> one row per benchmark type
+    if (!hasZParam)
+    {
+        Bars3DSeriesData series;
+        
+        QVector<BenchSubset> bchSubsets = bchResults.groupParam(plotParams.xType == PlotArgumentType,
+                                                                bchIdxs, plotParams.xIdx, "X");
+        for (const auto& bchSubset : std::as_const(bchSubsets))
+        {
+            if ( isCanceled(canceled) )
+                return data;
+            
+            // One row per benchmark * X-group
+            QVector<double> row;
+            row.reserve( bchSubset.idxs.size() );
+            
+            QStringList colLabels;
+            for (int idx : bchSubset.idxs)
+            {
+                colLabels.append( bchResults.getParamName(plotParams.xType == PlotArgumentType, idx, plotParams.xIdx) );
+                row.append( getYPlotValue(bchResults, idx, plotParams.yType) );
+            }
+            // Column labels (only if no collision)
+            mergeLabels(series.columnLabels, colLabels, series.rows.isEmpty());
+            series.rows.append( std::move(row) );
+            series.rowLabels.append(bchSubset.name);
+        }
+        data.series.append( std::move(series) );
+    }
+    //
+    // Z-param -> one series per benchmark, one row per Z, one column per X
+    else
+    {
+        // Initial segmentation by 'full name % param1 % param2' (group benchmarks)
+        const auto bchNames = bchResults.segment2DNames(bchIdxs,
+                                                        plotParams.xType == PlotArgumentType, plotParams.xIdx,
+                                                        plotParams.zType == PlotArgumentType, plotParams.zIdx);
+        QStringList prevRowLabels, prevColLabels;
+        bool sameRowLabels = true, sameColLabels = true;
+        for (const auto& bchName : bchNames)
+        {
+            if ( isCanceled(canceled) )
+                return data;
+            
+            // One series (i.e. color) per 2D name
+            Bars3DSeriesData series;
+            series.name = bchName.name;
+            
+            // Segment: one sub per Z-param from 2D names
+            QVector<BenchSubset> bchZSubs = bchResults.segmentParam(plotParams.zType == PlotArgumentType,
+                                                                    bchName.idxs, plotParams.zIdx);
+            QStringList curRowLabels;
+            for (const auto& bchZSub : std::as_const(bchZSubs))
+            {
+                curRowLabels.append(bchZSub.name);
+                
+                // Group: one column per X-param
+                QVector<BenchSubset> bchSubsets = bchResults.groupParam(plotParams.xType == PlotArgumentType,
+                                                                        bchZSub.idxs, plotParams.xIdx, "X");
+                Q_ASSERT(bchSubsets.size() == 1);
+                if (bchSubsets.empty()) {
+                    qWarning() << "Missing X-parameter subset for Z-row: " << bchZSub.name;
+                    break;
+                }
+                const auto& bchSubset = bchSubsets[0];
+                
+                // Y-values on row
+                QVector<double> row;
+                row.reserve( bchSubset.idxs.size() );
+                QStringList curColLabels;
+                for (int idx : bchSubset.idxs)
+                {
+                    curColLabels.append( bchResults.getParamName(plotParams.xType == PlotArgumentType,
+                                                                 idx, plotParams.xIdx) );
+                    row.append( getYPlotValue(bchResults, idx, plotParams.yType) );
+                }
+                series.rows.append( std::move(row) );
+                
+                // Check column labels collisions
+                if (sameColLabels) {
+                    mergeLabels(prevColLabels, curColLabels, prevColLabels.isEmpty());
+                    sameColLabels = prevColLabels != QStringList("");
+                }
+            }
+            // Check row labels collisions
+            if (sameRowLabels) {
+                mergeLabels(prevRowLabels, curRowLabels, prevRowLabels.isEmpty());
+                sameRowLabels = prevRowLabels != QStringList("");
+            }
+            data.series.append( std::move(series) );
+        }
+        
+        // Same row/column labels for all series (empty if collisions)
+        for (auto& series : data.series) {
+            series.columnLabels = sameColLabels ? prevColLabels : QStringList("");
+            series.rowLabels    = sameRowLabels ? prevRowLabels : QStringList("");
+        }
+    }
+    
+    return data;
+}
+
+/**************************************************************************************************/
+
+// Rows of same size, with 2 columns at least
+static bool checkSurfaceRows(const QVector<BenchSubset> &bchSubsets, const QString &seriesName)
+{
+    bool symOK = true, minOK = true;
+    QString culpritName;
+    int refSize = bchSubsets.empty() ? 0 : bchSubsets[0].idxs.size();
+    for (int i = 0; symOK && minOK && i < bchSubsets.size(); ++i) {
+        symOK = bchSubsets[i].idxs.size() == refSize;
+        minOK = bchSubsets[i].idxs.size() >= 2;
+        if (!symOK || !minOK)
+            culpritName = bchSubsets[i].name;
+    }
+    if ( !seriesName.isEmpty() )
+        culpritName = seriesName + " [Z=" + culpritName + "]";
+    
+    // Ignore asymmetrical series
+    if (!symOK)
+        qWarning() << "Inconsistent number of X-values between benchmarks to trace surface for: " << culpritName;
+    // Ignore single-row series
+    else if (!minOK)
+        qWarning() << "Not enough X-values to trace surface for: " << culpritName;
+    
+    return symOK && minOK;
+}
+
+Surface3DChartData ChartData::compute3DSurface(const BenchResults &bchResults, const QVector<int> &bchIdxs,
+                                               const PlotParams &plotParams, const QAtomicInt *canceled)
+{
+    Surface3DChartData data;
+    initBase(data, bchResults, plotParams);
+    
+    // X: argumentA or templateB
+    // Y: time/iter/bytes/items (not name dependent)
+    // Z: argumentC or templateD (with C!=A, D!=B)
+    ParamAxis xAxis(bchResults, plotParams.xType, plotParams.xIdx);
+    ParamAxis zAxis(bchResults, plotParams.zType, plotParams.zIdx);
+    bool hasZParam = plotParams.zType != PlotEmptyType;
+    
+    //
+    // No Z-param -> one row per benchmark type
+    if (!hasZParam)
+    {
+        // Segment per X-param
+        QVector<BenchSubset> bchSubsets = bchResults.groupParam(plotParams.xType == PlotArgumentType,
+                                                                bchIdxs, plotParams.xIdx, "X");
+        if ( checkSurfaceRows(bchSubsets, "") )
+        {
+            Surface3DSeriesData series;
+            double zFallback = 0.;
+            for (const auto& bchSubset : std::as_const(bchSubsets))
+            {
+                if ( isCanceled(canceled) )
+                    return data;
+                
+                // One row per X-group
+                QVector<QVector3D> row;
+                row.reserve( bchSubset.idxs.size() );
+                
+                double xFallback = 0.;
+                for (int idx : bchSubset.idxs)
+                {
+                    double xVal = xAxis.value(idx, xFallback);
+                    double yVal = getYPlotValue(bchResults, idx, plotParams.yType);
+                    row.append( QVector3D(xVal, yVal, zFallback) );
+                }
+                series.rows.append( std::move(row) );
+                
+                ++zFallback;
+            }
+            if ( !series.rows.isEmpty() )
+                data.series.append( std::move(series) );
+        }
+    }
+    //
+    // Z-param -> one series per benchmark type
+    else
+    {
+        // Initial segmentation by 'full name % param1 % param2' (group benchmarks)
+        const auto bchNames = bchResults.segment2DNames(bchIdxs,
+                                                        plotParams.xType == PlotArgumentType, plotParams.xIdx,
+                                                        plotParams.zType == PlotArgumentType, plotParams.zIdx);
+        for (const auto& bchName : bchNames)
+        {
+            if ( isCanceled(canceled) )
+                return data;
+            
+            // One subset per Z-param from 2D-names
+            QVector<BenchSubset> bchZSubs = bchResults.segmentParam(plotParams.zType == PlotArgumentType,
+                                                                    bchName.idxs, plotParams.zIdx);
+            // Ignore incompatible series
+            if ( bchZSubs.isEmpty() ) {
+                qWarning() << "No Z-value to trace surface for other benchmarks";
+                continue;
+            }
+            if ( !checkSurfaceRows(bchZSubs, bchName.name) )
+                continue;
+            
+            // One series (i.e. color) per 2D-name
+            Surface3DSeriesData series;
+            series.name = bchName.name;
+            double zFallback = 0.;
+            for (const auto& bchZSub : std::as_const(bchZSubs))
+            {
+                double zVal = zAxis.value(bchZSub.idxs.front(), zFallback);
+                
+                // One row per Z-param from 2D-names
+                QVector<QVector3D> row( bchZSub.idxs.size() );
+                
+                // One subset per X-param from Z-Subset
+                QVector<BenchSubset> bchSubsets = bchResults.groupParam(plotParams.xType == PlotArgumentType,
+                                                                        bchZSub.idxs, plotParams.xIdx, "X");
+                Q_ASSERT(bchSubsets.size() <= 1);
+                for (const auto& bchSubset : std::as_const(bchSubsets))
+                {
+                    int index = 0;
+                    double xFallback = 0.;
+                    for (int idx : bchSubset.idxs)
+                    {
+                        double xVal = xAxis.value(idx, xFallback);
+                        double yVal = getYPlotValue(bchResults, idx, plotParams.yType);
+                        row[index++] = QVector3D(xVal, yVal, zVal);
+                    }
+                }
+                series.rows.append( std::move(row) );
+            }
+            data.series.append( std::move(series) );
+        }
+    }
+    
+    data.xTitle = paramTitle(plotParams.xType, plotParams.xIdx, xAxis.custDataName());
+    data.zTitle = paramTitle(plotParams.zType, plotParams.zIdx, zAxis.custDataName());
+    if ( data.series.isEmpty() )
+        qWarning() << "No compatible series to display";
+    
+    return data;
+}
+
+/**************************************************************************************************/
+
+double ChartData::timeFactor(const QString &timeUnit, PlotValueType yType)
+{
+    if ( !isYTimeBased(yType) )
+        return 1.;
+    if (timeUnit == "ns")
+        return 1000.;
+    if (timeUnit == "ms")
+        return 0.001;
+    
+    return 1.;
+}
@@ -18,6 +18,7 @@
 #include "plot_parameters.h"
 #include "benchmark_results.h"
 #include "result_parser.h"
+#include "result_cache.h"
 
 #include "plotter_linechart.h"
 #include "plotter_barchart.h"
@@ -37,6 +38,7 @@ const char* cy_name = "chart-y";
 const char* cz_name = "chart-z";
 const char* fa_name = "append";
 const char* fo_name = "overwrite";
+const char* cb_name = "cache-budget";
 
 
 CommandLineHandler::CommandLineHandler()
@@ -70,6 +72,10 @@ CommandLineHandler::CommandLineHandler()
     QCommandLineOption overwriteOption(QStringList() << "ow" << fo_name,
                "Files to append by overwriting (uses ';' as separator)", "files...");
     mParser.addOption(overwriteOption);
+    
+    QCommandLineOption cacheBudgetOption(QStringList() << "cb" << cb_name,
+               "Memory for parsed files kept between reloads (in MB, default 256)", "mb");
+    mParser.addOption(cacheBudgetOption);
 }
 
 bool CommandLineHandler::process(const QApplication& app)
@@ -77,6 +83,17 @@ bool CommandLineHandler::process(const QApplication& app)
     // Process
     mParser.process(app);
     
+    // Parsed files kept in memory (any mode)
+    if ( mParser.isSet(cb_name) )
+    {
+        bool isNumber = false;
+        qint64 budget = mParser.value(cb_name).toLongLong(&isNumber);
+        if (isNumber && budget >= 0)
+            ResultCache::setMemoryBudget(budget << 20);
+        else
+            qWarning() << "[CmdLine] Invalid cache budget:" << mParser.value(cb_name);
+    }
+    
     const QStringList args = mParser.positionalArguments();
     
     if ( args.empty() )
@@ -84,15 +101,6 @@ bool CommandLineHandler::process(const QApplication& app)
     else if ( args.size() > 1)
         qWarning() << "[CmdLine] Ignoring additional arguments after first one";
     
-    // Parse results
-    QString errorMsg;
-    BenchResults bchResults = ResultParser::parseJsonFile( args[0], errorMsg);
-    
-    if ( bchResults.benchmarks.isEmpty() ) {
-        qCritical() << "[CmdLine] Error parsing file: " << args[0] << " -> " << errorMsg;
-        return true;
-    }
-    
     // Get params
     QString chartType = mParser.value(ct_name).toLower();
     QString chartX    = mParser.value(cx_name).toLower();
@@ -101,12 +109,7 @@ bool CommandLineHandler::process(const QApplication& app)
     QString apFiles   = mParser.value(fa_name);
     QString owFiles   = mParser.value(fo_name);
     
-    //
-    // Parse params
-    PlotParams plotParams;
-    
     // Append files
-    bool multiFiles = false;
     QVector<FileReload> addFilenames;
     if ( !apFiles.isEmpty() )
     {
@@ -114,17 +117,7 @@ bool CommandLineHandler::process(const QApplication& app)
         for (const auto& fileName : std::as_const(apList))
         {
             if ( QFile::exists(fileName) )
-            {
-                QString errorMsg;
-                BenchResults newResults = ResultParser::parseJsonFile(fileName, errorMsg);
-                if (newResults.benchmarks.size() <= 0) {
-                    qCritical() << "[CmdLine] Error parsing append file: " << fileName << " -> " << errorMsg;
-                    return true;
-                }
-                bchResults.appendResults(newResults);
-                multiFiles = true;
                 addFilenames.append( {fileName, true} );
-            }
         }
     }
     // Overwrite files
@@ -134,19 +127,32 @@ bool CommandLineHandler::process(const QApplication& app)
         for (const auto& fileName : std::as_const(owList))
         {
             if ( QFile::exists(fileName) )
-            {
-                QString errorMsg;
-                BenchResults newResults = ResultParser::parseJsonFile(fileName, errorMsg);
-                if (newResults.benchmarks.size() <= 0) {
-                    qCritical() << "[CmdLine] Error parsing overwrite file: " << fileName << " -> " << errorMsg;
-                    return true;
-                }
-                bchResults.overwriteResults(newResults);
-                multiFiles = true;
                 addFilenames.append( {fileName, false} );
-            }
         }
     }
+    bool multiFiles = !addFilenames.isEmpty();
+    
+    // Parse results (all files at once, incomplete files accepted)
+    QString errorMsg;
+    int errorIdx = -1;
+    ParseReport report;
+    BenchResults bchResults = ResultParser::loadJsonFiles(args[0], addFilenames, errorMsg, errorIdx, &report);
+    
+    if ( bchResults.benchmarks.isEmpty() ) {
+        if (errorIdx < 0)
+            qCritical() << "[CmdLine] Error parsing file: " << args[0] << " -> " << errorMsg;
+        else if (addFilenames[errorIdx].isAppend)
+            qCritical() << "[CmdLine] Error parsing append file: " << addFilenames[errorIdx].filename << " -> " << errorMsg;
+        else
+            qCritical() << "[CmdLine] Error parsing overwrite file: " << addFilenames[errorIdx].filename << " -> " << errorMsg;
+        return true;
+    }
+    if (report.isTruncated)
+        qWarning() << "[CmdLine] Incomplete results file(s), skipped bytes:" << report.skippedBytes;
+    
+    //
+    // Parse params
+    PlotParams plotParams;
     
     
     // Chart-type
@@ -289,13 +295,14 @@ bool CommandLineHandler::process(const QApplication& app)
     if (multiFiles) fileName += " + ...";
     
     const auto& bchIdxs = bchResults.segmentAll();
+    BenchSnapshot bchSnapshot = makeSnapshot( std::move(bchResults) );
     
     switch (plotParams.type)
     {
         case ChartLineType:
         case ChartSplineType:
         {
-            PlotterLineChart *plotLines = new PlotterLineChart(bchResults, bchIdxs,
+            PlotterLineChart *plotLines = new PlotterLineChart(bchSnapshot, bchIdxs,
                                                                plotParams, fileName, addFilenames);
             plotLines->show();
             break;
@@ -303,28 +310,28 @@ bool CommandLineHandler::process(const QApplication& app)
         case ChartBarType:
         case ChartHBarType:
         {
-            PlotterBarChart *plotBars = new PlotterBarChart(bchResults, bchIdxs,
-                                                             plotParams, fileName, addFilenames);
+            PlotterBarChart *plotBars = new PlotterBarChart(bchSnapshot, bchIdxs,
+                                                            plotParams, fileName, addFilenames);
             plotBars->show();
             break;
         }
         case ChartBoxType:
         {
-            PlotterBoxChart *plotBoxes = new PlotterBoxChart(bchResults, bchIdxs,
+            PlotterBoxChart *plotBoxes = new PlotterBoxChart(bchSnapshot, bchIdxs,
                                                              plotParams, fileName, addFilenames);
             plotBoxes->show();
             break;
         }
         case Chart3DBarsType:
         {
-            Plotter3DBars *plot3DBars = new Plotter3DBars(bchResults, bchIdxs,
+            Plotter3DBars *plot3DBars = new Plotter3DBars(bchSnapshot, bchIdxs,
                                                           plotParams, fileName, addFilenames);
             plot3DBars->show();
             break;
         }
         case Chart3DSurfaceType:
         {
-            Plotter3DSurface *plot3DSurface = new Plotter3DSurface(bchResults, bchIdxs,
+            Plotter3DSurface *plot3DSurface = new Plotter3DSurface(bchSnapshot, bchIdxs,
                                                                    plotParams, fileName, addFilenames);
             plot3DSurface->show();
             break;
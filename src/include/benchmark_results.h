@@ -16,6 +16,12 @@
 #ifndef BENCHMARK_DATA_H
 #define BENCHMARK_DATA_H
 
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QHash>
+#include <QSharedData>
+#include <QSharedDataPointer>
+#include <QSharedPointer>
 #include <QString>
 #include <QStringList>
 #include <QVector>
@@ -54,6 +60,80 @@ struct BenchContext {
     QVector<BenchCache> caches;
 };
 
+// Time units
+enum BenchTimeUnit : quint8 {
+    NanoSecondUnit, MicroSecondUnit, MilliSecondUnit, SecondUnit
+};
+
+// Time unit from name (micro-seconds if unknown)
+inline BenchTimeUnit toTimeUnit(QByteArrayView name)
+{
+    if (name == "ns") return NanoSecondUnit;
+    if (name == "ms") return MilliSecondUnit;
+    if (name == "s")  return SecondUnit;
+    return MicroSecondUnit;
+}
+
+// Time unit name
+inline const char* timeUnitName(BenchTimeUnit unit)
+{
+    switch (unit)
+    {
+        case NanoSecondUnit:  return "ns";
+        case MicroSecondUnit: return "us";
+        case MilliSecondUnit: return "ms";
+        case SecondUnit:      return "s";
+    }
+    return "us";
+}
+
+// Factor to micro-seconds
+inline double timeUnitFactorUs(BenchTimeUnit unit)
+{
+    switch (unit)
+    {
+        case NanoSecondUnit:  return 0.001;
+        case MicroSecondUnit: return 1.;
+        case MilliSecondUnit: return 1000.;
+        case SecondUnit:      return 1000000.;
+    }
+    return 1.;
+}
+
+// User-defined aggregate names (e.g. "p99" from ComputeStatistics)
+// Note: ids are process-wide, so they stay valid across reloads and merges
+class AggregateNames {
+public:
+    // Id of name (added if new)
+    static int id(const QString &name);
+    // Name of id (empty if unknown)
+    static QString name(int id);
+};
+
+// User-defined aggregate values (durations in us, or percents, see BenchMeta)
+struct BenchCustomAggregate {
+    int id;     // see AggregateNames
+    double real, cpu, kbytes, kitems;
+};
+
+// Benchmark Aggregate (all durations in us/cv in %)
+struct BenchAggregate : public QSharedData {
+    double min_real = 0, min_cpu = 0, min_kbytes = 0, min_kitems = 0;
+    double max_real = 0, max_cpu = 0, max_kbytes = 0, max_kitems = 0;
+    double mean_real = 0, mean_cpu = 0, mean_kbytes = 0, mean_kitems = 0;
+    double median_real = 0, median_cpu = 0, median_kbytes = 0, median_kitems = 0;
+    double stddev_real = 0, stddev_cpu = 0, stddev_kbytes = 0, stddev_kitems = 0;
+    double cv_real = -1, cv_cpu = -1, cv_kbytes = -1, cv_kitems = -1;
+    
+    // User-defined (sorted by id)
+    QVector<BenchCustomAggregate> custom;
+    
+    // Find user-defined aggregate (nullptr if none)
+    const BenchCustomAggregate* findCustom(int id) const;
+    // Add or replace user-defined aggregate
+    void setCustom(const BenchCustomAggregate &value);
+};
+
 // Benchmark Data
 struct BenchData {
     // Iterations
@@ -64,20 +144,26 @@ struct BenchData {
     int repetition_index;
     int threads;
     int iterations;
-    QString time_unit;
+    BenchTimeUnit time_unit = NanoSecondUnit;
+    bool hasAggregate = false;  // (packed with time unit)
     QVector<double> real_time; // One per iteration
     QVector<double> cpu_time;
     QVector<double> kbytes_sec;
     QVector<double> kitems_sec;
     
-    // Aggregate (all durations in us/cv in %)
-    bool hasAggregate = false;
-    double min_real, min_cpu, min_kbytes, min_kitems;
-    double max_real, max_cpu, max_kbytes, max_kitems;
-    double mean_real, mean_cpu, mean_kbytes, mean_kitems;
-    double median_real, median_cpu, median_kbytes, median_kitems;
-    double stddev_real, stddev_cpu, stddev_kbytes, stddev_kitems;
-    double cv_real = -1, cv_cpu = -1, cv_kbytes = -1, cv_kitems = -1;
+    // Aggregate (separate block, only allocated once written)
+    const BenchAggregate& aggregates() const
+    {
+        static const BenchAggregate noAggregate;
+        return aggregate_block.constData() != nullptr ? *aggregate_block.constData() : noAggregate;
+    }
+    BenchAggregate& editAggregates()
+    {
+        if (aggregate_block.constData() == nullptr)
+            aggregate_block = new BenchAggregate;
+        return *aggregate_block;
+    }
+    QSharedDataPointer<BenchAggregate> aggregate_block;
     
     // Meta
     // Note: JOMT format = "JOMT_FamilyName_ContainerName<templates>/params
@@ -111,6 +197,200 @@ struct BenchMeta {
     bool hasBytesSec = false, hasItemsSec = false;
     int maxArguments = 0, maxTemplates = 0;
     QString time_unit;  // if same for all, otherwise "us" as default
+    QVector<int> customAggregates;  // user-defined aggregate ids (in parsing order)
+    QVector<int> percentAggregates; // user-defined aggregate ids with values in percent (aggregate unit)
+};
+
+//
+// StringPool
+// Interned benchmark strings (equal values share one buffer and one id)
+class StringPool {
+public:
+    // Pooled copy of value (added if new)
+    QString intern(const QString &value);
+    // Pooled copy of utf8 value (only decoded if new)
+    QString intern(QByteArrayView utf8);
+    // Pooled copy of each list element
+    QStringList intern(const QStringList &values);
+    // Pool all strings of benchmark
+    void intern(BenchData &bchData);
+    
+    // Id of pooled string (-1 if not pooled)
+    int id(const QString &value) const { return mIds.value(value, -1); }
+    const QString& string(int id) const { return mStrings[id]; }
+    
+    int size() const { return mStrings.size(); }
+    void clear();
+    
+    // Approximate heap usage (pooled strings and lookup hashes)
+    qint64 memorySize() const;
+    
+private:
+    int add(const QString &value);
+    
+    QVector<QString> mStrings;
+    QHash<QString, int> mIds;
+    QHash<QByteArray, int> mUtf8Ids;
+};
+
+// Metric columns
+enum BenchColumn {
+    RealTimeColumn, CpuTimeColumn, IterationsColumn, KBytesColumn, KItemsColumn,   // default values
+    MinRealColumn,    MinCpuColumn,    MinKBytesColumn,    MinKItemsColumn,
+    MaxRealColumn,    MaxCpuColumn,    MaxKBytesColumn,    MaxKItemsColumn,
+    MeanRealColumn,   MeanCpuColumn,   MeanKBytesColumn,   MeanKItemsColumn,
+    MedianRealColumn, MedianCpuColumn, MedianKBytesColumn, MedianKItemsColumn,
+    StddevRealColumn, StddevCpuColumn, StddevKBytesColumn, StddevKItemsColumn,
+    CvRealColumn,     CvCpuColumn,     CvKBytesColumn,     CvKItemsColumn,
+    ColumnCount
+};
+
+//
+// BenchColumns
+// Columnar benchmark metrics (one contiguous array per metric):
+// default values for all benchmarks, aggregate values only for benchmarks having an aggregate block
+// (repetitions of those also copied, sorted for quartiles)
+class BenchColumns {
+public:
+    // Built for given results revision
+    void build(const QVector<BenchData> &benchmarks, quint64 revision);
+    // Rebuilt from first changed benchmark (earlier ones unchanged since last build/update)
+    void update(const QVector<BenchData> &benchmarks, int changedFrom, quint64 revision);
+    
+    int size() const { return mSize; }
+    quint64 revision() const { return mRevision; }
+    // Approximate heap usage
+    qint64 memorySize() const;
+    
+    // Value of benchmark (same as BenchData if no aggregate block)
+    double value(BenchColumn column, int idx) const
+    {
+        if (column < MinRealColumn)
+            return mColumns[column][idx];
+        int row = mAggregateRows[idx];
+        return row >= 0 ? mColumns[column][row] : (column >= CvRealColumn ? -1. : 0.);
+    }
+    bool hasAggregate(int idx) const
+    {
+        int row = mAggregateRows[idx];
+        return row >= 0 && mHasAggregate[row] != 0;
+    }
+    
+    // Sorted repetitions of default metric column (all benchmarks in one buffer, none for iterations)
+    const QVector<double>& sortedRepetitions(BenchColumn column) const { return mRepetitions[column]; }
+    // Range of benchmark in sorted repetitions (empty if no aggregate block)
+    void repetitionRange(BenchColumn column, int idx, int &begin, int &end) const
+    {
+        int row = mAggregateRows[idx];
+        begin = row >= 0 ? mRepetitionOffsets[column][row] : 0;
+        end   = row >= 0 ? mRepetitionOffsets[column][row + 1] : 0;
+    }
+    
+private:
+    void setRow(int idx, const BenchData &bchData);
+    void appendRepetitions(BenchColumn column, const QVector<double> &values);
+    
+    int mSize = 0;
+    quint64 mRevision = ~quint64(0);        // not built
+    QVector<double> mColumns[ColumnCount];  // indexed like benchmarks (default), or by aggregate row
+    QVector<int> mAggregateRows;            // indexed like benchmarks (-1 if no aggregate block)
+    QVector<char> mHasAggregate;            // by aggregate row
+    QVector<double> mRepetitions[MinRealColumn];        // by default column, one sorted range per aggregate row
+    QVector<int> mRepetitionOffsets[MinRealColumn];     // range starts by aggregate row (and end of last one)
+};
+
+// Parameter value types
+enum ParamValueType {
+    ParamNumberType,    // number
+    ParamDataSizeType,  // custom data size (JOMT specific)
+    ParamNameType       // other (incremented fallback)
+};
+
+// Pre-parsed parameter value
+struct BenchParamValue {
+    ParamValueType type = ParamNameType;
+    double value = 0.;  // if number or data size
+};
+
+// Dictionary-encoded name component (value code per benchmark, -1 if absent)
+struct BenchDimension {
+    QVector<BenchSubset> subsets;       // indexed by code (value and all its benchmarks)
+    QVector<int> codes;                 // indexed like benchmarks
+    QVector<BenchParamValue> values;    // indexed by code (arguments/templates only)
+    ParamValueType axisType = ParamNameType;    // common to all values (otherwise name type)
+};
+
+//
+// BenchDimensions
+// Families, containers, base names, arguments and templates (per position) as small integer codes,
+// with their subsets over all benchmarks
+class BenchDimensions {
+public:
+    // Built for given results revision
+    void build(const QVector<BenchData> &benchmarks, quint64 revision);
+    // Rebuilt from first changed benchmark (earlier ones unchanged since last build/update)
+    void update(const QVector<BenchData> &benchmarks, int changedFrom, quint64 revision);
+    
+    int size() const { return mSize; }
+    quint64 revision() const { return mRevision; }
+    // Approximate heap usage (subset names shared with pooled strings, not counted)
+    qint64 memorySize() const;
+    
+    const BenchDimension& families() const   { return mFamilies; }
+    const BenchDimension& containers() const { return mContainers; }
+    const BenchDimension& baseNames() const  { return mBaseNames; }
+    
+    // Containers subsets of family
+    const QVector<BenchSubset>& familyContainers(int familyCode) const { return mFamilyContainers[familyCode]; }
+    
+    int argumentCount() const { return mArguments.size(); }
+    const BenchDimension& argument(int argIdx) const { return mArguments[argIdx]; }
+    
+    int templateCount() const { return mTemplates.size(); }
+    const BenchDimension& templateParam(int tpltIdx) const { return mTemplates[tpltIdx]; }
+    
+private:
+    int mSize = 0;
+    quint64 mRevision = ~quint64(0);    // not built
+    BenchDimension mFamilies, mContainers, mBaseNames;
+    QVector<QVector<BenchSubset>> mFamilyContainers;
+    QVector<BenchDimension> mArguments;
+    QVector<BenchDimension> mTemplates;
+};
+
+//
+// BenchNameIndex
+// Benchmark name to index (first one if duplicated)
+class BenchNameIndex {
+public:
+    void build(const QVector<BenchData> &benchmarks);
+    
+    // Number of indexed benchmarks
+    int size() const { return mSize; }
+    // Approximate heap usage (names shared with benchmarks, not counted)
+    qint64 memorySize() const;
+    
+    int indexOf(const QString &name) const { return mIndexes.value(name, -1); }
+    bool contains(const QString &name) const { return mIndexes.contains(name); }
+    // Index next benchmark
+    void append(const QString &name);
+    
+private:
+    int mSize = 0;
+    QHash<QString, int> mIndexes;
+};
+
+// Heap usage by category (bytes)
+struct BenchMemory {
+    qint64 benchmarks = 0;      // BenchData array
+    qint64 repetitions = 0;
+    qint64 aggregates = 0;      // aggregate blocks
+    qint64 strings = 0;         // string pool, strings not pooled and parameter lists
+    qint64 derived = 0;         // metric columns and dimensions
+    qint64 indexes = 0;         // name index and rename suffixes
+    qint64 meta = 0;
+    
+    qint64 total() const { return benchmarks + repetitions + aggregates + strings + derived + indexes + meta; }
 };
 
 //
@@ -122,6 +402,13 @@ struct BenchResults {
     BenchMeta meta;
     BenchContext context;
     QVector<BenchData> benchmarks;
+    BenchColumns columns;       // updated after parsing/merging
+    BenchDimensions dimensions; // updated after parsing/merging
+    StringPool strings;         // shared by benchmarks strings
+    BenchNameIndex names;       // updated when merging
+    QHash<QString, int> suffixes;   // last suffix used per original name when renaming (merging)
+    quint64 version = 0;        // set when published as snapshot
+    quint64 revision = 0;       // incremented when benchmarks change (derived data built for one revision)
     
     
     /*
@@ -146,6 +433,11 @@ struct BenchResults {
     // Convert parameter name to value (check special names, use incremented fallback if all else fail)
     static double getParamValue(const QString &name, QString &custDataName,
                                 bool &custDataAxis, double &fallbackIdx);
+    // Same for pre-parsed parameter value
+    static double getParamValue(const BenchParamValue &param, QString &custDataName,
+                                bool &custDataAxis, double &fallbackIdx);
+    // Parse parameter name once
+    static BenchParamValue parseParamValue(const QString &name);
     
     /*
      * Member functions
@@ -198,14 +490,43 @@ struct BenchResults {
     QString getBenchName(int index) const;
     // Get Argument/Template name
     QString getParamName(bool isArgument, int benchIdx, int paramIdx) const;
+    // Get Argument/Template value (pre-parsed, see getParamValue())
+    double getParamValue(bool isArgument, int benchIdx, int paramIdx, QString &custDataName,
+                         bool &custDataAxis, double &fallbackIdx) const;
+    // Get Argument/Template axis type (common to all values, name type if mixed or not parsed yet)
+    ParamValueType getParamAxisType(bool isArgument, int paramIdx, QString &custDataName) const;
+    // Get Argument/Template number or data size (axis of same type only, see getParamAxisType())
+    double getParamNumber(bool isArgument, int benchIdx, int paramIdx) const;
     
     //
-    // Merge results (rename BenchData if already exists)
-    void appendResults(const BenchResults &bchRes);
-    // Merge results (overwrite BenchData if already exists)
-    void overwriteResults(const BenchResults &bchRes);
+    // Merge results (rename BenchData if already exists, moved from bchRes)
+    // Note: disable update when merging several results, then call updateDerived() once
+    void appendResults(BenchResults &&bchRes, bool update = true);
+    // Merge results (overwrite BenchData if already exists, moved from bchRes)
+    void overwriteResults(BenchResults &&bchRes, bool update = true);
+    
+    // Pool strings of all benchmarks (e.g. after external construction)
+    void internStrings();
+    // Rebuild metric columns and dimensions from benchmarks
+    void updateDerived();
+    // Update metric columns, dimensions (and names if indexed) from first changed benchmark
+    // (derived data of earlier ones must be up to date, e.g. resumed parsing)
+    void updateDerived(int changedFrom);
+    // Columns built for current benchmarks
+    bool hasColumns() const { return columns.revision() == revision && columns.size() == benchmarks.size(); }
+    // Dimensions built for current benchmarks
+    bool hasDimensions() const { return dimensions.revision() == revision && dimensions.size() == benchmarks.size(); }
     
+    // Approximate heap usage of benchmarks and derived data, from capacities (shared buffers counted once)
+    BenchMemory memoryUsage() const;
+    qint64 memorySize() const { return memoryUsage().total(); }
 };
 
+// Immutable results shared by selector and plot windows (never modified once published)
+typedef QSharedPointer<const BenchResults> BenchSnapshot;
+
+// Snapshot of results (moved, with new version greater than all previous ones)
+BenchSnapshot makeSnapshot(BenchResults &&bchResults);
+
 
 #endif // BENCHMARK_DATA_H
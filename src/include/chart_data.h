@@ -0,0 +1,122 @@
+// Copyright 2019 Guillaume AUJAY. All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef CHART_DATA_H
+#define CHART_DATA_H
+
+#include "benchmark_results.h"
+#include "plot_parameters.h"
+
+#include <QAtomicInt>
+#include <QPointF>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QVector3D>
+
+
+// Common to all charts (time based Y-values in us, converted by plotters)
+struct ChartDataBase {
+    QString timeUnit;                   // of results (initially displayed)
+    QString xTitle, yTitle, zTitle;     // empty if no title
+};
+
+//
+// Lines: one series per benchmark % X-param (2 points at least)
+struct LineSeriesData {
+    QString name;
+    QVector<QPointF> points;
+};
+struct LineChartData : ChartDataBase {
+    QVector<LineSeriesData> series;
+};
+
+//
+// Bars: one set per benchmark % X-param, one column per X-value
+struct BarSetData {
+    QString name;
+    QVector<double> values;
+};
+struct BarChartData : ChartDataBase {
+    QVector<BarSetData> sets;
+    QStringList categories;             // single empty label if sets have different columns
+};
+
+//
+// Boxes: one series per benchmark % X-param, one box per X-value
+struct BoxData {
+    QString name;
+    BenchYStats stats;
+};
+struct BoxSeriesData {
+    QString name;
+    QVector<BoxData> boxes;
+};
+struct BoxChartData : ChartDataBase {
+    QVector<BoxSeriesData> series;
+};
+
+//
+// 3D Bars: single series with one row per benchmark (no Z-param),
+// or one series per benchmark with one row per Z-value
+struct Bars3DSeriesData {
+    QString name;                       // empty if single series
+    QVector<QVector<double>> rows;
+    QStringList rowLabels, columnLabels;
+};
+struct Bars3DChartData : ChartDataBase {
+    QVector<Bars3DSeriesData> series;
+};
+
+//
+// 3D Surface: single series with one row per benchmark (no Z-param),
+// or one series per benchmark with one row per Z-value
+struct Surface3DSeriesData {
+    QString name;                       // empty if single series
+    QVector<QVector<QVector3D>> rows;
+};
+struct Surface3DChartData : ChartDataBase {
+    QVector<Surface3DSeriesData> series;
+};
+
+
+//
+// ChartData
+// Chart values computed from results, without any graphics object (can run in worker threads)
+// Computation stops early if 'canceled' is set (partial data to be discarded)
+class ChartData
+{
+public:
+    static LineChartData computeLines(const BenchResults &bchResults, const QVector<int> &bchIdxs,
+                                      const PlotParams &plotParams, const QAtomicInt *canceled = nullptr);
+    
+    static BarChartData computeBars(const BenchResults &bchResults, const QVector<int> &bchIdxs,
+                                    const PlotParams &plotParams, const QAtomicInt *canceled = nullptr);
+    
+    static BoxChartData computeBoxes(const BenchResults &bchResults, const QVector<int> &bchIdxs,
+                                     const PlotParams &plotParams, const QAtomicInt *canceled = nullptr);
+    
+    static Bars3DChartData compute3DBars(const BenchResults &bchResults, const QVector<int> &bchIdxs,
+                                         const PlotParams &plotParams, const QAtomicInt *canceled = nullptr);
+    
+    static Surface3DChartData compute3DSurface(const BenchResults &bchResults, const QVector<int> &bchIdxs,
+                                               const PlotParams &plotParams, const QAtomicInt *canceled = nullptr);
+    
+    // Factor converting Y-values from us to 'timeUnit' (1 if not time based)
+    static double timeFactor(const QString &timeUnit, PlotValueType yType);
+};
+
+
+#endif // CHART_DATA_H
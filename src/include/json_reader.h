@@ -0,0 +1,125 @@
+// Copyright 2019 Guillaume AUJAY. All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef JSON_READER_H
+#define JSON_READER_H
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QString>
+#include <QVector>
+
+class QIODevice;
+
+
+//
+// JsonReader
+// Pull (SAX-style) json tokenizer, reading device by chunks or parsing memory directly
+class JsonReader
+{
+public:
+    enum Token {
+        Invalid,
+        BeginObject, EndObject,
+        BeginArray,  EndArray,
+        Name, String, Number, Bool, Null,
+        EndDocument
+    };
+    
+    // At most 'maxSize' bytes read from device if given (e.g. size of a file still written)
+    explicit JsonReader(QIODevice *device, qint64 chunkSize = 1 << 20, qint64 maxSize = -1);
+    // Data must outlive reader (e.g. mapped file)
+    JsonReader(const char *data, qint64 size);
+    
+    // Read next token (Invalid on error, sticky)
+    Token readNext();
+    Token token() const { return mToken; }
+    
+    // Resume inside an array of root object, from input 'offset'
+    // ('hasValues' if array already had values before offset)
+    void resumeInArray(qint64 offset, bool hasValues);
+    
+    // Skip children of current BeginObject/BeginArray (no-op for other tokens)
+    bool skipCurrent();
+    // Skip value following current Name
+    bool skipValue() { return readNext() != Invalid && skipCurrent(); }
+    
+    // Current Name/String (escapes resolved)
+    bool isName(const char *name) const;
+    QString stringValue() const { return QString::fromUtf8(mValueData, mValueSize); }
+    // Current Number/Bool
+    double numberValue(bool *ok = nullptr) const;
+    bool boolValue() const { return mBool; }
+    
+    // Raw bytes of current Name/String/Number, valid until next read,
+    // or as long as input memory if stable (no copy was needed)
+    QByteArrayView valueView() const { return QByteArrayView(mValueData, mValueSize); }
+    bool isValueStable() const { return mValueStable; }
+    
+    // State
+    int depth() const { return mStack.size(); }
+    qint64 offset() const { return mBase + mPos; }
+    bool hasError() const { return !mError.isEmpty(); }
+    const QString& errorString() const { return mError; }
+    // Error only due to missing input (e.g. file truncated while written), not invalid syntax
+    bool isEndOfData() const { return mEndOfData; }
+    
+private:
+    enum LevelState { Start, AfterComma, AfterName, AfterValue };
+    struct Level {
+        bool isObject;
+        LevelState state;
+    };
+    
+    bool fill();
+    bool skipWhitespace();
+    bool getChar(char &c);
+    
+    Token readValue();
+    Token closeLevel(char c);
+    bool readString();
+    bool readEscape();
+    bool readNumber();
+    bool readLiteral(const char *literal);
+    
+    void setValue(const char *data, qint64 size, bool stable);
+    Token setToken(Token token) { mToken = token; return token; }
+    Token setError(const QString &error, bool endOfData = false);
+    
+private:
+    // Input
+    QIODevice *mDevice;
+    QByteArray mBuffer;
+    const char *mData;
+    qint64 mPos  = 0;   // in buffer
+    qint64 mEnd  = 0;   // in buffer
+    qint64 mBase = 0;   // offset of buffer in device
+    qint64 mDeviceLeft; // bytes still allowed from device (-1 if unbounded)
+    
+    // Parsing
+    QVector<Level> mStack;
+    bool mRootDone = false;
+    Token mToken = Invalid;
+    QByteArray mValue;  // when not a view on input
+    const char *mValueData = nullptr;
+    qint64 mValueSize = 0;
+    bool mValueStable = false;
+    bool mBool = false;
+    QString mError;
+    bool mEndOfData = false;
+};
+
+
+#endif // JSON_READER_H
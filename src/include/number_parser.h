@@ -0,0 +1,37 @@
+// Copyright 2019 Guillaume AUJAY. All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef NUMBER_PARSER_H
+#define NUMBER_PARSER_H
+
+#include <QtGlobal>
+
+
+//
+// NumberParser
+// Correctly rounded json number parsing (Clinger fast path, then Eisel-Lemire, then Qt)
+class NumberParser
+{
+public:
+    // Whole input must be a json number
+    static bool parseDouble(const char *data, qint64 size, double &value);
+    
+private:
+    // Exact decimal w * 10^q, false if not decidable
+    static bool computeDouble(quint64 w, qint64 q, bool negative, double &value);
+};
+
+
+#endif // NUMBER_PARSER_H
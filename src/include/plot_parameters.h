@@ -44,12 +44,16 @@ enum PlotParamType {
 };
 
 // Y-value types
-enum PlotValueType {
+enum PlotValueType : int {
     CpuTimeType,  CpuTimeMinType,  CpuTimeMeanType,  CpuTimeMedianType,  CpuTimeStddevType,  CpuTimeCvType,
     RealTimeType, RealTimeMinType, RealTimeMeanType, RealTimeMedianType, RealTimeStddevType, RealTimeCvType,
     IterationsType,
     BytesType, BytesMinType, BytesMeanType, BytesMedianType, BytesStddevType, BytesCvType,
-    ItemsType, ItemsMinType, ItemsMeanType, ItemsMedianType, ItemsStddevType, ItemsCvType
+    ItemsType, ItemsMinType, ItemsMeanType, ItemsMedianType, ItemsStddevType, ItemsCvType,
+    // Unknown (e.g. user-defined aggregate of unsupported metric)
+    UnknownValueType = -1,
+    // User-defined aggregates (see customAggregateType)
+    CustomAggregateType = 0x100
 };
 
 // Y-value stats
@@ -75,10 +79,21 @@ struct PlotParams {
  */
 // Get Y-value according to type
 double getYPlotValue(const BenchData &bchData, PlotValueType yType);
+// Get Y-value according to type (from results columns)
+double getYPlotValue(const BenchResults &bchResults, int idx, PlotValueType yType);
 
 // Get Y-name according to type
 QString getYPlotName(PlotValueType yType, QString timeUnit = "us");
 
+// Get Y-value type of user-defined aggregate for metric (i.e. CpuTimeType, RealTimeType, BytesType or ItemsType,
+// or their cv type for aggregates in percent), UnknownValueType if unsupported metric or unknown aggregate
+PlotValueType customAggregateType(PlotValueType metric, int aggregateId);
+// Check Y-value type is a user-defined aggregate
+bool isCustomAggregate(PlotValueType yType);
+// Get metric and aggregate id of user-defined aggregate type
+PlotValueType customAggregateMetric(PlotValueType yType);
+int customAggregateId(PlotValueType yType);
+
 // Convert time value to micro-seconds
 double normalizeTimeUs(const BenchData &bchData, double value);
 
@@ -86,10 +101,12 @@ double normalizeTimeUs(const BenchData &bchData, double value);
 bool isYTimeBased(PlotValueType yType);
 
 // Find median in vector subpart
-double findMedian(QVector<double> sorted, int begin, int end);
+double findMedian(const QVector<double> &sorted, int begin, int end);
 
 // Get Y-value statistics (for Box chart)
 BenchYStats getYPlotStats(BenchData &bchData, PlotValueType yType);
+// Get Y-value statistics (from results columns, repetitions already sorted)
+BenchYStats getYPlotStats(const BenchResults &bchResults, int idx, PlotValueType yType);
 
 // Compare first common elements of string lists
 bool commonPartEqual(const QStringList &listA, const QStringList &listB);
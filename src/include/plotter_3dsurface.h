@@ -17,12 +17,14 @@
 #define PLOTTER_3DSURFACE_H
 
 #include "plot_parameters.h"
+#include "chart_data.h"
 #include "series_dialog.h"
 
 #include <QWidget>
 #include <QVector>
 #include <QString>
-#include <QFileSystemWatcher>
+#include <QFutureWatcher>
+#include <QSharedPointer>
 
 namespace Ui {
 class Plotter3DSurface;
@@ -37,16 +39,19 @@ class Plotter3DSurface : public QWidget
     Q_OBJECT
     
 public:
-    explicit Plotter3DSurface(const BenchResults &bchResults, const QVector<int> &bchIdxs,
+    explicit Plotter3DSurface(const BenchSnapshot &bchResults, const QVector<int> &bchIdxs,
                               const PlotParams &plotParams, const QString &filename,
                               const QVector<FileReload>& addFilenames, QWidget *parent = nullptr);
     ~Plotter3DSurface();
 
 private:
     void connectUI();
-    void setupChart(const BenchResults &bchResults, const QVector<int> &bchIdxs, const PlotParams &plotParams, bool init = true);
+    void computeChart();
+    void setupChart(const Surface3DChartData &chartData, bool init = true);
+    bool reconcileChart(const Surface3DChartData &chartData, QString &errorMsg);
     void setupOptions(bool init = true);
     void loadConfig(bool init);
+    void applySeriesConfig(int from = 0);
     void saveConfig();
 
 public slots:
@@ -73,8 +78,9 @@ public slots:
     void onSpinMTicksChanged(int i);
 
     void onCheckAutoReload(int state);
-    void onAutoReload(const QString &path);
     void onReloadClicked();
+    void onResultsPublished(const QString &sourceKey, const BenchSnapshot &bchResults);
+    void onChartComputed();
     void onSnapshotClicked();
 
 
@@ -99,15 +105,19 @@ private:
     void setupGradients();
     
     Ui::Plotter3DSurface *ui;
-    Q3DSurface *mSurface;
+    Q3DSurface *mSurface = nullptr;
     
+    BenchSnapshot mBchResults;
     QVector<int> mBenchIdxs;
     const PlotParams mPlotParams;
     const QString mOrigFilename;
     const QVector<FileReload> mAddFilenames;
+    const QString mSourceKey;
     const bool mAllIndexes;
     
-    QFileSystemWatcher mWatcher;
+    QFutureWatcher<Surface3DChartData> mChartWatcher;
+    QSharedPointer<QAtomicInt> mChartCanceled;  // of running computation
+    
     SeriesMapping mSeriesMapping;
     double mCurrentTimeFactor;      // from us
     ValAxisParam mAxesParams[3];
@@ -17,12 +17,14 @@
 #define PLOTTER_BARCHART_H
 
 #include "plot_parameters.h"
+#include "chart_data.h"
 #include "series_dialog.h"
 
 #include <QWidget>
 #include <QVector>
 #include <QString>
-#include <QFileSystemWatcher>
+#include <QFutureWatcher>
+#include <QSharedPointer>
 
 namespace Ui {
 class PlotterBarChart;
@@ -37,16 +39,19 @@ class PlotterBarChart : public QWidget
     Q_OBJECT
     
 public:
-    explicit PlotterBarChart(const BenchResults &bchResults, const QVector<int> &bchIdxs,
+    explicit PlotterBarChart(const BenchSnapshot &bchResults, const QVector<int> &bchIdxs,
                              const PlotParams &plotParams, const QString &filename,
                              const QVector<FileReload>& addFilenames, QWidget *parent = nullptr);
     ~PlotterBarChart();
 
 private:
     void connectUI();
-    void setupChart(const BenchResults &bchResults, const QVector<int> &bchIdxs, const PlotParams &plotParams, bool init = true);
+    void computeChart();
+    void setupChart(const BarChartData &chartData, bool init = true);
+    bool reconcileChart(const BarChartData &chartData, QString &errorMsg);
     void setupOptions(bool init = true);
     void loadConfig(bool init);
+    void applySeriesConfig(int from = 0);
     void saveConfig();
 
 public slots:
@@ -82,8 +87,9 @@ public slots:
     void onSpinMTicksChanged(int i);
     
     void onCheckAutoReload(int state);
-    void onAutoReload(const QString &path);
     void onReloadClicked();
+    void onResultsPublished(const QString &sourceKey, const BenchSnapshot &bchResults);
+    void onChartComputed();
     void onSnapshotClicked();
     
     
@@ -99,13 +105,17 @@ private:
     Ui::PlotterBarChart *ui;
     QChartView *mChartView = nullptr;
     
+    BenchSnapshot mBchResults;
     QVector<int> mBenchIdxs;
     const PlotParams mPlotParams;
     const QString mOrigFilename;
     const QVector<FileReload> mAddFilenames;
+    const QString mSourceKey;
     const bool mAllIndexes;
     
-    QFileSystemWatcher mWatcher;
+    QFutureWatcher<BarChartData> mChartWatcher;
+    QSharedPointer<QAtomicInt> mChartCanceled;  // of running computation
+    
     SeriesMapping mSeriesMapping;
     double mCurrentTimeFactor;      // from us
     AxisParam mAxesParams[2];
@@ -17,12 +17,14 @@
 #define PLOTTER_BOXCHART_H
 
 #include "plot_parameters.h"
+#include "chart_data.h"
 #include "series_dialog.h"
 
 #include <QWidget>
 #include <QVector>
 #include <QString>
-#include <QFileSystemWatcher>
+#include <QFutureWatcher>
+#include <QSharedPointer>
 
 namespace Ui {
 class PlotterBoxChart;
@@ -37,16 +39,19 @@ class PlotterBoxChart : public QWidget
     Q_OBJECT
     
 public:
-    explicit PlotterBoxChart(BenchResults &bchResults, const QVector<int> &bchIdxs,
+    explicit PlotterBoxChart(const BenchSnapshot &bchResults, const QVector<int> &bchIdxs,
                              const PlotParams &plotParams, const QString &filename,
                              const QVector<FileReload>& addFilenames, QWidget *parent = nullptr);
     ~PlotterBoxChart();
 
 private:
     void connectUI();
-    void setupChart(BenchResults &bchResults, const QVector<int> &bchIdxs, const PlotParams &plotParams, bool init = true);
+    void computeChart();
+    void setupChart(const BoxChartData &chartData, bool init = true);
+    bool reconcileChart(const BoxChartData &chartData, QString &errorMsg);
     void setupOptions(bool init = true);
     void loadConfig(bool init);
+    void applySeriesConfig(int from = 0);
     void saveConfig();
 
 public slots:
@@ -80,8 +85,9 @@ public slots:
     void onSpinMTicksChanged(int i);
     
     void onCheckAutoReload(int state);
-    void onAutoReload(const QString &path);
     void onReloadClicked();
+    void onResultsPublished(const QString &sourceKey, const BenchSnapshot &bchResults);
+    void onChartComputed();
     void onSnapshotClicked();
     
     
@@ -97,13 +103,17 @@ private:
     Ui::PlotterBoxChart *ui;
     QChartView *mChartView = nullptr;
     
+    BenchSnapshot mBchResults;
     QVector<int> mBenchIdxs;
     const PlotParams mPlotParams;
     const QString mOrigFilename;
     const QVector<FileReload> mAddFilenames;
+    const QString mSourceKey;
     const bool mAllIndexes;
     
-    QFileSystemWatcher mWatcher;
+    QFutureWatcher<BoxChartData> mChartWatcher;
+    QSharedPointer<QAtomicInt> mChartCanceled;  // of running computation
+    
     SeriesMapping mSeriesMapping;
     double mCurrentTimeFactor;      // from us
     AxisParam mAxesParams[2];
@@ -17,12 +17,14 @@
 #define PLOTTER_LINECHART_H
 
 #include "plot_parameters.h"
+#include "chart_data.h"
 #include "series_dialog.h"
 
 #include <QWidget>
 #include <QVector>
 #include <QString>
-#include <QFileSystemWatcher>
+#include <QFutureWatcher>
+#include <QSharedPointer>
 
 namespace Ui {
 class PlotterLineChart;
@@ -37,16 +39,19 @@ class PlotterLineChart : public QWidget
     Q_OBJECT
     
 public:
-    explicit PlotterLineChart(const BenchResults &bchResults, const QVector<int> &bchIdxs,
+    explicit PlotterLineChart(const BenchSnapshot &bchResults, const QVector<int> &bchIdxs,
                               const PlotParams &plotParams, const QString &filename,
                               const QVector<FileReload>& addFilenames, QWidget *parent = nullptr);
     ~PlotterLineChart();
 
 private:
     void connectUI();
-    void setupChart(const BenchResults &bchResults, const QVector<int> &bchIdxs, const PlotParams &plotParams, bool init = true);
+    void computeChart();
+    void setupChart(const LineChartData &chartData, bool init = true);
+    bool reconcileChart(const LineChartData &chartData, QString &errorMsg);
     void setupOptions(bool init = true);
     void loadConfig(bool init);
+    void applySeriesConfig(int from = 0);
     void saveConfig();
 
 public slots:
@@ -78,8 +83,9 @@ public slots:
     void onSpinMTicksChanged(int i);
     
     void onCheckAutoReload(int state);
-    void onAutoReload(const QString &path);
     void onReloadClicked();
+    void onResultsPublished(const QString &sourceKey, const BenchSnapshot &bchResults);
+    void onChartComputed();
     void onSnapshotClicked();
     
     
@@ -97,13 +103,17 @@ private:
     Ui::PlotterLineChart *ui;
     QChartView *mChartView = nullptr;
     
+    BenchSnapshot mBchResults;
     QVector<int> mBenchIdxs;
     const PlotParams mPlotParams;
     const QString mOrigFilename;
     const QVector<FileReload> mAddFilenames;
+    const QString mSourceKey;
     const bool mAllIndexes;
     
-    QFileSystemWatcher mWatcher;
+    QFutureWatcher<LineChartData> mChartWatcher;
+    QSharedPointer<QAtomicInt> mChartCanceled;  // of running computation
+    
     SeriesMapping mSeriesMapping;
     double mCurrentTimeFactor;      // from us
     ValAxisParam mAxesParams[2];
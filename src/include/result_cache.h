@@ -0,0 +1,72 @@
+// Copyright 2019 Guillaume AUJAY. All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef RESULT_CACHE_H
+#define RESULT_CACHE_H
+
+#include "benchmark_results.h"
+
+#include <QString>
+
+class QFile;
+class ParseProgress;
+
+
+// Source file identity
+struct FileFingerprint {
+    QString path;       // absolute
+    qint64 size  = 0;
+    qint64 mtime = 0;   // ms since epoch
+    quint64 hash = 0;   // content
+    
+    bool isValid() const { return !path.isEmpty(); }
+};
+
+//
+// ResultCache
+// Binary cache of parsed results (in settings folder, least recently used pruned), validated against source file
+// Last results of each file also kept in memory (thread-safe LRU, within budget)
+class ResultCache
+{
+public:
+    // Enabled by default (disabled for parsing benchmarks)
+    static void setEnabled(bool enabled);
+    static bool isEnabled();
+    
+    // Folder of cache files (settings subfolder by default, e.g. temporary one for benchmarks)
+    static void setFolder(const QString &folder);
+    static QString folder();
+    
+    // Memory used by in-process results (estimate, least recently used dropped first)
+    static void setMemoryBudget(qint64 bytes);
+    static qint64 memoryBudget();
+    
+    // Identify opened source file (content hashed, invalid if unreadable or canceled)
+    static FileFingerprint fingerprint(QFile &file, ParseProgress *progress = nullptr);
+    
+    // Load cached results if source file didn't change (from memory first)
+    static bool load(const FileFingerprint &source, BenchResults &bchResults);
+    // Save results parsed from source file (to memory, and file unless already up to date)
+    static bool save(const FileFingerprint &source, const BenchResults &bchResults);
+    
+    // Cache file associated to source file
+    static QString cachePath(const QString &sourcePath);
+    
+    // Fast 64-bit hash (not cryptographic)
+    static quint64 hashBytes(const char *data, qint64 size, quint64 seed = 0);
+};
+
+
+#endif // RESULT_CACHE_H
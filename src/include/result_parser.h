@@ -18,11 +18,91 @@
 
 #include "benchmark_results.h"
 
+#include <QHash>
+#include <QAtomicInteger>
+
+struct FileFingerprint;
+
+// Benchmark index by run name (filled while parsing)
+typedef QHash<QString, int> BenchIndex;
+
+// Recovery report (for truncated files, e.g. benchmarks still running)
+struct ParseReport
+{
+    bool isTruncated = false;   // parsed up to last complete benchmark (end of data missing)
+    qint64 parsedBytes = 0;
+    qint64 skippedBytes = 0;    // incomplete trailing data
+};
+
+// Progress of parsing running in other threads (shared by concurrently parsed files)
+class ParseProgress
+{
+public:
+    qint64 totalBytes() const  { return mTotalBytes.loadRelaxed(); }
+    qint64 parsedBytes() const { return mParsedBytes.loadRelaxed(); }
+    void addTotal(qint64 bytes)  { mTotalBytes.fetchAndAddRelaxed(bytes); }
+    void addParsed(qint64 bytes) { mParsedBytes.fetchAndAddRelaxed(bytes); }
+    
+    // Parsing stops after current benchmark (or hashed chunk), failing with empty results
+    void cancel() { mCanceled.storeRelaxed(1); }
+    bool isCanceled() const { return mCanceled.loadRelaxed() != 0; }
+    
+private:
+    QAtomicInteger<qint64> mTotalBytes  = 0;
+    QAtomicInteger<qint64> mParsedBytes = 0;
+    QAtomicInt mCanceled = 0;
+};
+
+// Incremental parsing state (for files growing while benchmarks run)
+struct ParseState
+{
+    QString filename;
+    qint64 fileSize = 0;
+    qint64 offset = 0;          // after last complete benchmark (or benchmarks array start)
+    bool hasBenchmarks = false; // array has benchmarks before offset
+    bool isTruncated = false;   // data missing after offset (invalid data is an error)
+    bool isComplete = false;    // whole document parsed
+    
+    // Unchanged data check
+    qint64 headSize = 0;        // up to benchmarks array start
+    size_t headHash = 0;
+    QByteArray tail;            // bytes before offset
+    
+    BenchIndex bchIndex;
+    int changedFrom = 0;        // first benchmark added or merged into by last parsing
+    bool isUnchanged = false;   // last parsing found same data (nothing parsed)
+    ParseReport report;
+};
+
 
 class ResultParser
 {
 public:
-    static BenchResults parseJsonFile(const QString &filename, QString& errorMsg);
+    // Recovery mode if 'report' given (truncated file accepted up to last complete benchmark,
+    // file read by chunks as it may still be written, 'source' fingerprint reused if file didn't change since)
+    static BenchResults parseJsonFile(const QString &filename, QString& errorMsg, ParseReport *report = nullptr,
+                                      ParseProgress *progress = nullptr, const FileFingerprint *source = nullptr);
+    
+    // Parse only benchmarks appended since previous call and merge them into 'bchResults'
+    // (whole file parsed again if rewritten, incomplete trailing data ignored until completed)
+    // File read by chunks up to its current size, never mapped (may be truncated while reading)
+    // If canceled or invalid, 'bchResults' and 'state' may hold part of the new benchmarks and should be discarded
+    // 'source' fingerprint reused for results cache if file didn't change since (not hashed again)
+    static bool parseJsonFileIncremental(const QString &filename, BenchResults &bchResults,
+                                         ParseState &state, QString& errorMsg, ParseProgress *progress = nullptr,
+                                         const FileFingerprint *source = nullptr);
+    
+    // Parse files concurrently (results and errors in same order, optional fingerprints too)
+    static QVector<BenchResults> parseJsonFiles(const QStringList &filenames, QStringList& errorMsgs,
+                                                QVector<ParseReport> *reports = nullptr, ParseProgress *progress = nullptr,
+                                                const QVector<FileFingerprint> *sources = nullptr);
+    
+    // Load original file with additional ones (parsed concurrently, merged in order)
+    // Unchanged files taken from results cache, so reloading after one file changed only parses that one
+    // On error, returns empty results with index of failing file in 'addFilenames' (-1 if original)
+    static BenchResults loadJsonFiles(const QString &filename, const QVector<FileReload> &addFilenames,
+                                      QString& errorMsg, int& errorIdx, ParseReport *report = nullptr,
+                                      ParseProgress *progress = nullptr, const QVector<FileFingerprint> *sources = nullptr);
 };
 
 
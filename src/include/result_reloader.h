@@ -0,0 +1,130 @@
+// Copyright 2019 Guillaume AUJAY. All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#ifndef RESULT_RELOADER_H
+#define RESULT_RELOADER_H
+
+#include "benchmark_results.h"
+#include "result_parser.h"
+#include "result_cache.h"
+
+#include <QHash>
+#include <QObject>
+#include <QPointer>
+#include <QSet>
+#include <QSharedPointer>
+#include <QString>
+#include <QVector>
+#include <QFileSystemWatcher>
+#include <QFutureWatcher>
+#include <QTimer>
+
+class QWidget;
+
+
+//
+// ResultReloader
+// Watches and reloads origin files once for all windows showing them (GUI thread only)
+// Changes are coalesced until files are stable, and skipped if files (or content) didn't change
+// New results are published with ResultSnapshots
+class ResultReloader : public QObject
+{
+    Q_OBJECT
+    
+public:
+    static ResultReloader* instance();
+    
+    // Auto-reload origin files for window (until unwatched or destroyed, one origin per window)
+    void watch(QObject *window, const QString &filename, const QVector<FileReload> &addFilenames);
+    void unwatch(QObject *window);
+    
+    // Reload origin files in a worker thread (again when done if already running)
+    // Errors and incomplete files reported to requester if any (logged otherwise)
+    // Parsing progress reported to and canceled with given progress if any
+    void reload(const QString &filename, const QVector<FileReload> &addFilenames, QWidget *requester = nullptr,
+                const QSharedPointer<ParseProgress> &progress = {});
+    
+    // Reload running, or pending to run again
+    bool isReloading(const QString &sourceKey) const;
+    
+    // Results just loaded from single file (next reload only parses appended data)
+    void setLoaded(const QString &filename, const BenchSnapshot &bchResults, const ParseState &parseState);
+    
+signals:
+    // Reload done (after publication if valid)
+    void reloadFinished(const QString &sourceKey, bool isValid, const ParseReport &report);
+    
+private slots:
+    void onFileChanged(const QString &path);
+    void onSettleTimeout();
+    void onWindowDestroyed(QObject *window);
+    
+private:
+    struct ReloadResult {
+        BenchResults bchResults;
+        ParseState parseState;
+        ParseReport report;
+        QString errorMsg;
+        int errorIdx = -1;
+        bool isValid = false;
+        bool isCanceled = false;
+        
+        QVector<FileFingerprint> files; // original then additionals (hash 0 if not hashed)
+        bool isUnchanged = false;       // same files or content as latest (not parsed)
+    };
+    struct FileProbe {
+        qint64 size  = -1;
+        qint64 mtime = -1;
+        int tries = 0;
+    };
+    struct Source {
+        QString filename;
+        QVector<FileReload> addFilenames;
+        QSet<QObject*> windows;                     // auto-reloading
+        
+        QWeakPointer<const BenchResults> latest;    // last loaded (kept alive by windows)
+        ParseState parseState;                      // of latest (single file only)
+        quint64 stateVersion = 0;
+        QVector<FileFingerprint> files;             // of latest (empty if unknown)
+        ParseReport report;                         // of latest
+        
+        QFutureWatcher<ReloadResult> loader;
+        QPointer<QWidget> requester;
+        QSharedPointer<ParseProgress> progress;     // of requested reload
+        bool isPending = false;
+    };
+    
+    explicit ResultReloader(QObject *parent = nullptr);
+    
+    QSharedPointer<Source> source(const QString &filename, const QVector<FileReload> &addFilenames);
+    void releaseSource(const QString &sourceKey);
+    void updateWatchList();
+    void reloadUsing(const QString &path);
+    
+    void startReload(const QString &sourceKey);
+    void finishReload(const QString &sourceKey);
+    
+private:
+    QHash<QString, QSharedPointer<Source>> mSources;    // by source key
+    QFileSystemWatcher mWatcher;                        // each path once
+    QSet<QString> mWatchedPaths;                        // re-added if file replaced
+    
+    QHash<QString, FileProbe> mChangedFiles;            // waiting to be stable
+    QTimer mSettleTimer;
+};
+
+
+#endif // RESULT_RELOADER_H
@@ -17,12 +17,15 @@
 #define RESULT_SELECTOR_H
 
 #include "benchmark_results.h"
+#include "result_parser.h"
 
 #include <QSet>
 #include <QVector>
 #include <QString>
 #include <QWidget>
-#include <QFileSystemWatcher>
+#include <QFutureWatcher>
+#include <QSharedPointer>
+#include <QTimer>
 
 namespace Ui {
 class ResultSelector;
@@ -36,16 +39,34 @@ class ResultSelector : public QWidget
     
 public:
     explicit ResultSelector(QWidget *parent = nullptr);
-    explicit ResultSelector(const BenchResults &bchResults, const QString &fileName, QWidget *parent = nullptr);
+    explicit ResultSelector(const BenchSnapshot &bchResults, const QString &fileName, QWidget *parent = nullptr);
     ~ResultSelector();
     
 private:
+    // Files loaded in a worker thread
+    enum LoadKind { LoadNew, LoadAppend, LoadOverwrite };
+    struct LoadResult {
+        BenchResults bchResults;        // merged into current ones if appended/overwritten
+        BenchResults addResults;        // as parsed (to merge again if current ones replaced)
+        quint64 baseVersion = 0;        // of current results merged into
+        ParseState parseState;
+        ParseReport report;
+        QString errorMsg;
+        int errorIdx = -1;
+        bool isValid = false;
+    };
+    
     void connectUI();
     void loadConfig();
     void saveConfig();
     void updateComboBoxY();
     void updateResults(bool clear, const QSet<QString> unselected = {});
     
+    void startLoading(LoadKind kind, const QString &fileName);
+    void setLoading(bool loading);
+    void finishNew(LoadResult &result);
+    void finishAdd(LoadResult &result, bool isAppend);
+    
 public slots:
     void onItemChanged(QTreeWidgetItem *item, int column);
     
@@ -53,15 +74,20 @@ public slots:
     void onComboXChanged(int index);
     void onComboZChanged(int index);
     
-    void onAutoReload(const QString &path);
     void updateReloadWatchList();
     void onCheckAutoReload(int state);
     void onReloadClicked();
+    void onReloadFinished(const QString &sourceKey, bool isValid, const ParseReport &report);
+    void onResultsPublished(const QString &sourceKey, const BenchSnapshot &bchResults);
     
     void onNewClicked();
     void onAppendClicked();
     void onOverwriteClicked();
     
+    void onLoadProgress();
+    void onLoadFinished();
+    void onCancelClicked();
+    
     void onSelectAllClicked();
     void onSelectNoneClicked();
     
@@ -70,12 +96,17 @@ public slots:
 private:
     Ui::ResultSelector *ui;
     
-    BenchResults mBchResults;
+    BenchSnapshot mBchResults;      // shared with plot windows
     QString mOrigFilename;
     QVector<FileReload> mAddFilenames;
     
     QString mWorkingDir;
-    QFileSystemWatcher mWatcher;
+    
+    QFutureWatcher<LoadResult> mLoadWatcher;
+    QSharedPointer<ParseProgress> mLoadProgress;
+    QTimer mProgressTimer;
+    LoadKind mLoadKind = LoadNew;
+    QString mLoadFilename;
 };
 
 
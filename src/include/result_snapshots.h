@@ -0,0 +1,51 @@
+// Copyright 2019 Guillaume AUJAY. All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#ifndef RESULT_SNAPSHOTS_H
+#define RESULT_SNAPSHOTS_H
+
+#include "benchmark_results.h"
+
+#include <QObject>
+#include <QString>
+#include <QVector>
+
+
+//
+// ResultSnapshots
+// Publishes results snapshots to every window showing the same files (GUI thread only)
+class ResultSnapshots : public QObject
+{
+    Q_OBJECT
+    
+public:
+    static ResultSnapshots* instance();
+    
+    // Identify origin files (original and additional ones, in merge order)
+    static QString sourceKey(const QString &filename, const QVector<FileReload> &addFilenames);
+    
+    // Share new results of origin files
+    void publish(const QString &sourceKey, const BenchSnapshot &bchResults);
+    
+signals:
+    void published(const QString &sourceKey, const BenchSnapshot &bchResults);
+    
+private:
+    explicit ResultSnapshots(QObject *parent = nullptr);
+};
+
+
+#endif // RESULT_SNAPSHOTS_H
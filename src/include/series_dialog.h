@@ -21,6 +21,8 @@
 #include <QString>
 #include <QColor>
 
+class QJsonObject;
+
 namespace Ui {
 class SeriesDialog;
 }
@@ -39,6 +41,28 @@ inline bool operator==(const SeriesConfig& lhs, const SeriesConfig& rhs) {
 }
 typedef QVector<SeriesConfig>   SeriesMapping;
 
+// New series data named as mapped series, in same order (error message otherwise)
+template <typename SeriesData>
+bool sameSeriesNames(const SeriesMapping &mapping, const QVector<SeriesData> &seriesData, QString &errorMsg)
+{
+    if (seriesData.size() != mapping.size()) {
+        errorMsg = "Number of series is different";
+        return false;
+    }
+    for (int idx = 0; idx < mapping.size(); ++idx)
+    {
+        if (seriesData[idx].name != mapping[idx].oldName) {
+            errorMsg = "Series has different name";
+            return false;
+        }
+    }
+    return true;
+}
+
+// Saved names and colors ("series" config array) applied to mapped series, from given index
+void loadSeriesConfig(const QJsonObject &json, SeriesMapping &mapping, int from = 0);
+bool loadSeriesConfig(const QString &configPath, SeriesMapping &mapping, int from = 0);
+
 
 class SeriesDialog : public QDialog
 {
@@ -0,0 +1,498 @@
+// Copyright 2019 Guillaume AUJAY. All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "json_reader.h"
+#include "number_parser.h"
+
+#include <QIODevice>
+
+#include <cstring>
+
+
+static inline bool isWhitespace(char c)
+{
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+static inline int hexValue(char c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+static void appendUtf8(QByteArray &out, uint code)
+{
+    if (code < 0x80) {
+        out.append( static_cast<char>(code) );
+    }
+    else if (code < 0x800) {
+        out.append( static_cast<char>(0xC0 | (code >> 6)) );
+        out.append( static_cast<char>(0x80 | (code & 0x3F)) );
+    }
+    else if (code < 0x10000) {
+        out.append( static_cast<char>(0xE0 | (code >> 12)) );
+        out.append( static_cast<char>(0x80 | ((code >> 6) & 0x3F)) );
+        out.append( static_cast<char>(0x80 | (code & 0x3F)) );
+    }
+    else {
+        out.append( static_cast<char>(0xF0 | (code >> 18)) );
+        out.append( static_cast<char>(0x80 | ((code >> 12) & 0x3F)) );
+        out.append( static_cast<char>(0x80 | ((code >> 6) & 0x3F)) );
+        out.append( static_cast<char>(0x80 | (code & 0x3F)) );
+    }
+}
+
+/**************************************************************************************************/
+
+JsonReader::JsonReader(QIODevice *device, qint64 chunkSize, qint64 maxSize)
+    : mDevice(device)
+    , mBuffer(chunkSize, Qt::Uninitialized)
+    , mData(mBuffer.constData())
+    , mDeviceLeft(maxSize)
+{
+    mStack.reserve(8);
+}
+
+JsonReader::JsonReader(const char *data, qint64 size)
+    : mDevice(nullptr)
+    , mData(data)
+    , mEnd(size)
+    , mDeviceLeft(0)
+{
+    mStack.reserve(8);
+}
+
+JsonReader::Token JsonReader::readNext()
+{
+    if (hasError())
+        return Invalid;
+    
+    if ( !skipWhitespace() )
+    {
+        if (mStack.isEmpty() && mRootDone)
+            return setToken(EndDocument);
+        return setError("Unexpected end of data", true);
+    }
+    
+    // Root
+    if ( mStack.isEmpty() )
+    {
+        if (mRootDone)
+            return setError("Unexpected data after document");
+        return readValue();
+    }
+    
+    // Separator or end
+    char c = mData[mPos];
+    LevelState state = mStack.last().state;
+    if (state == AfterValue)
+    {
+        if (c != ',')
+            return closeLevel(c);
+        
+        ++mPos;
+        mStack.last().state = AfterComma;
+        if ( !skipWhitespace() )
+            return setError("Unexpected end of data", true);
+        c = mData[mPos];
+    }
+    else if (state == Start && (c == '}' || c == ']'))
+        return closeLevel(c);
+    
+    // Object name
+    if (mStack.last().isObject && mStack.last().state != AfterName)
+    {
+        if (c != '"')
+            return setError("Expected object name");
+        ++mPos;
+        if ( !readString() )
+            return Invalid;
+        
+        if ( !skipWhitespace() )
+            return setError("Unexpected end of data", true);
+        if (mData[mPos] != ':')
+            return setError("Expected ':' after object name");
+        ++mPos;
+        mStack.last().state = AfterName;
+        
+        return setToken(Name);
+    }
+    
+    // Value
+    mStack.last().state = AfterValue;
+    return readValue();
+}
+
+void JsonReader::resumeInArray(qint64 offset, bool hasValues)
+{
+    mStack.clear();
+    mStack.append({true, AfterValue});
+    mStack.append({false, hasValues ? AfterValue : Start});
+    mRootDone = false;
+    mBase = offset;
+    setToken(BeginArray);
+}
+
+bool JsonReader::isName(const char *name) const
+{
+    return mValueSize == static_cast<qint64>(std::strlen(name))
+            && std::memcmp(mValueData, name, mValueSize) == 0;
+}
+
+double JsonReader::numberValue(bool *ok) const
+{
+    double value = 0.0;
+    bool isValid = NumberParser::parseDouble(mValueData, mValueSize, value);
+    if (ok != nullptr)
+        *ok = isValid;
+    
+    return isValid ? value : 0.0;
+}
+
+bool JsonReader::skipCurrent()
+{
+    if (mToken != BeginObject && mToken != BeginArray)
+        return !hasError();
+    
+    int parentDepth = mStack.size() - 1;
+    while (mStack.size() > parentDepth)
+    {
+        if (readNext() == Invalid)
+            return false;
+    }
+    
+    return true;
+}
+
+/**************************************************************************************************/
+
+bool JsonReader::fill()
+{
+    if (mPos < mEnd)
+        return true;
+    if (mDevice == nullptr)
+        return false;
+    
+    // Keep current value if it is a view on buffer
+    if (mValueData >= mBuffer.constData() && mValueData < mBuffer.constData() + mBuffer.size()) {
+        mValue = QByteArray(mValueData, mValueSize);
+        setValue(mValue.constData(), mValue.size(), false);
+    }
+    
+    mBase += mEnd;
+    mPos = mEnd = 0;
+    qint64 toRead = mDeviceLeft >= 0 ? qMin<qint64>(mDeviceLeft, mBuffer.size()) : mBuffer.size();
+    if (toRead <= 0)
+        return false;
+    qint64 read = mDevice->read(mBuffer.data(), toRead);
+    if (read <= 0)
+        return false;
+    mEnd = read;
+    if (mDeviceLeft >= 0)
+        mDeviceLeft -= read;
+    
+    return true;
+}
+
+bool JsonReader::skipWhitespace()
+{
+    for (;;)
+    {
+        while (mPos < mEnd && isWhitespace(mData[mPos]))
+            ++mPos;
+        if (mPos < mEnd)
+            return true;
+        if ( !fill() )
+            return false;
+    }
+}
+
+bool JsonReader::getChar(char &c)
+{
+    if (mPos >= mEnd && !fill())
+        return false;
+    c = mData[mPos++];
+    
+    return true;
+}
+
+JsonReader::Token JsonReader::readValue()
+{
+    char c = mData[mPos];
+    Token token = Invalid;
+    switch (c)
+    {
+        case '{': {
+            ++mPos;
+            mStack.append({true, Start});
+            return setToken(BeginObject);
+        }
+        case '[': {
+            ++mPos;
+            mStack.append({false, Start});
+            return setToken(BeginArray);
+        }
+        case '"': {
+            ++mPos;
+            if ( !readString() )
+                return Invalid;
+            token = String;
+            break;
+        }
+        case 't': {
+            if ( !readLiteral("true") )
+                return Invalid;
+            mBool = true;
+            token = Bool;
+            break;
+        }
+        case 'f': {
+            if ( !readLiteral("false") )
+                return Invalid;
+            mBool = false;
+            token = Bool;
+            break;
+        }
+        case 'n': {
+            if ( !readLiteral("null") )
+                return Invalid;
+            token = Null;
+            break;
+        }
+        default: {
+            if (c != '-' && (c < '0' || c > '9'))
+                return setError(QString("Unexpected character '%1'").arg(QChar(c)));
+            if ( !readNumber() )
+                return Invalid;
+            token = Number;
+            break;
+        }
+    }
+    if ( mStack.isEmpty() )
+        mRootDone = true;
+    
+    return setToken(token);
+}
+
+JsonReader::Token JsonReader::closeLevel(char c)
+{
+    bool isObject = mStack.last().isObject;
+    if ((isObject && c != '}') || (!isObject && c != ']'))
+        return setError(QString("Unexpected character '%1'").arg(QChar(c)));
+    
+    ++mPos;
+    mStack.removeLast();
+    if ( mStack.isEmpty() )
+        mRootDone = true;
+    
+    return setToken(isObject ? EndObject : EndArray);
+}
+
+bool JsonReader::readString()
+{
+    auto scanPlain = [this]() {
+        while (mPos < mEnd)
+        {
+            uchar c = static_cast<uchar>(mData[mPos]);
+            if (c == '"' || c == '\\' || c < 0x20)
+                break;
+            ++mPos;
+        }
+    };
+    
+    // Plain string in buffer, no copy
+    qint64 start = mPos;
+    scanPlain();
+    if (mPos < mEnd && mData[mPos] == '"') {
+        setValue(mData + start, mPos - start, mDevice == nullptr);
+        ++mPos;
+        return true;
+    }
+    
+    // Escaped or split string
+    setValue(nullptr, 0, false);
+    mValue.resize(0);
+    for (;;)
+    {
+        mValue.append(mData + start, mPos - start);
+        
+        // Special
+        if (mPos >= mEnd) {
+            if ( !fill() ) {
+                setError("Unterminated string", true);
+                return false;
+            }
+        }
+        else {
+            char c = mData[mPos++];
+            if (c == '"') {
+                setValue(mValue.constData(), mValue.size(), false);
+                return true;
+            }
+            if (c != '\\') {
+                setError("Control character in string");
+                return false;
+            }
+            if ( !readEscape() )
+                return false;
+        }
+        
+        // Plain characters
+        start = mPos;
+        scanPlain();
+    }
+}
+
+bool JsonReader::readEscape()
+{
+    char c;
+    if ( !getChar(c) ) {
+        setError("Unterminated string", true);
+        return false;
+    }
+    switch (c)
+    {
+        case '"':  mValue.append('"');  return true;
+        case '\\': mValue.append('\\'); return true;
+        case '/':  mValue.append('/');  return true;
+        case 'b':  mValue.append('\b'); return true;
+        case 'f':  mValue.append('\f'); return true;
+        case 'n':  mValue.append('\n'); return true;
+        case 'r':  mValue.append('\r'); return true;
+        case 't':  mValue.append('\t'); return true;
+        case 'u':  break;
+        default: {
+            setError("Invalid escape sequence");
+            return false;
+        }
+    }
+    
+    // Unicode
+    auto readHex4 = [this](uint &code) -> bool {
+        code = 0;
+        for (int i = 0; i < 4; ++i) {
+            char h;
+            if ( !getChar(h) ) {
+                setError("Unterminated string", true);
+                return false;
+            }
+            int val = hexValue(h);
+            if (val < 0) return false;
+            code = (code << 4) | static_cast<uint>(val);
+        }
+        return true;
+    };
+    uint code;
+    if ( !readHex4(code) ) {
+        setError("Invalid unicode escape");
+        return false;
+    }
+    // Surrogate pair
+    if (code >= 0xD800 && code <= 0xDBFF)
+    {
+        char c1, c2 = 0;
+        uint low;
+        if ( !getChar(c1) || (c1 == '\\' && !getChar(c2)) ) {
+            setError("Unterminated string", true);
+            return false;
+        }
+        if (c1 == '\\' && c2 == 'u' && readHex4(low) && low >= 0xDC00 && low <= 0xDFFF)
+            code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+        else {
+            setError("Invalid unicode surrogate pair");
+            return false;
+        }
+    }
+    else if (code >= 0xDC00 && code <= 0xDFFF) {
+        setError("Invalid unicode surrogate pair");
+        return false;
+    }
+    appendUtf8(mValue, code);
+    
+    return true;
+}
+
+bool JsonReader::readNumber()
+{
+    auto scanNumber = [this]() {
+        while (mPos < mEnd)
+        {
+            char c = mData[mPos];
+            if ((c < '0' || c > '9') && c != '-' && c != '+' && c != '.' && c != 'e' && c != 'E')
+                break;
+            ++mPos;
+        }
+    };
+    
+    // Number in buffer, no copy
+    qint64 start = mPos;
+    scanNumber();
+    if (mPos < mEnd || mDevice == nullptr) {
+        setValue(mData + start, mPos - start, mDevice == nullptr);
+        return true;
+    }
+    
+    // Split number
+    setValue(nullptr, 0, false);
+    mValue.resize(0);
+    for (;;)
+    {
+        mValue.append(mData + start, mPos - start);
+        if (mPos < mEnd || !fill())
+            break;
+        start = mPos;
+        scanNumber();
+    }
+    setValue(mValue.constData(), mValue.size(), false);
+    
+    return true;
+}
+
+bool JsonReader::readLiteral(const char *literal)
+{
+    for (const char *l = literal; *l != '\0'; ++l)
+    {
+        char c;
+        if ( !getChar(c) ) {
+            setError("Unexpected end of data", true);
+            return false;
+        }
+        if (c != *l) {
+            setError(QString("Invalid literal, expected '%1'").arg(literal));
+            return false;
+        }
+    }
+    
+    return true;
+}
+
+void JsonReader::setValue(const char *data, qint64 size, bool stable)
+{
+    mValueData = data;
+    mValueSize = size;
+    mValueStable = stable;
+}
+
+JsonReader::Token JsonReader::setError(const QString &error, bool endOfData)
+{
+    if ( !hasError() ) {
+        mError = error + " at offset " + QString::number(offset());
+        mEndOfData = endOfData;
+    }
+    
+    return setToken(Invalid);
+}
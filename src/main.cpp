@@ -68,7 +68,7 @@ int main(int argc, char *argv[])
                 return 1;
             }
             // Selector Test
-            resultSelector.reset(new ResultSelector(bchResults, jmtDir.filePath(fileName)));
+            resultSelector.reset(new ResultSelector(makeSnapshot( std::move(bchResults) ), jmtDir.filePath(fileName)));
         }
         else
             // Show empty selector
@@ -15,6 +15,8 @@
 
 #include "plot_parameters.h"
 
+#include <QDebug>
+
 #include <algorithm>
 
 const char* config_folder = "jomtSettings/";
@@ -22,6 +24,8 @@ const char* config_folder = "jomtSettings/";
 
 double getYPlotValue(const BenchData &bchData, PlotValueType yType)
 {
+    const BenchAggregate &agg = bchData.aggregates();
+    
     switch (yType)
     {
         // CPU time
@@ -29,19 +33,19 @@ double getYPlotValue(const BenchData &bchData, PlotValueType yType)
             return bchData.cpu_time_us;
         }
         case CpuTimeMinType: {
-            return bchData.min_cpu;
+            return agg.min_cpu;
         }
         case CpuTimeMeanType: {
-            return bchData.mean_cpu;
+            return agg.mean_cpu;
         }
         case CpuTimeMedianType: {
-            return bchData.median_cpu;
+            return agg.median_cpu;
         }
         case CpuTimeStddevType: {
-            return bchData.stddev_cpu;
+            return agg.stddev_cpu;
         }
         case CpuTimeCvType: {
-            return bchData.cv_cpu;
+            return agg.cv_cpu;
         }
         
         // Real time
@@ -49,19 +53,19 @@ double getYPlotValue(const BenchData &bchData, PlotValueType yType)
             return bchData.real_time_us;
         }
         case RealTimeMinType: {
-            return bchData.min_real;
+            return agg.min_real;
         }
         case RealTimeMeanType: {
-            return bchData.mean_real;
+            return agg.mean_real;
         }
         case RealTimeMedianType: {
-            return bchData.median_real;
+            return agg.median_real;
         }
         case RealTimeStddevType: {
-            return bchData.stddev_real;
+            return agg.stddev_real;
         }
         case RealTimeCvType: {
-            return bchData.cv_real;
+            return agg.cv_real;
         }
         
         // Iterations
@@ -74,19 +78,19 @@ double getYPlotValue(const BenchData &bchData, PlotValueType yType)
             return bchData.kbytes_sec_dflt;
         }
         case BytesMinType: {
-            return bchData.min_kbytes;
+            return agg.min_kbytes;
         }
         case BytesMeanType: {
-            return bchData.mean_kbytes;
+            return agg.mean_kbytes;
         }
         case BytesMedianType: {
-            return bchData.median_kbytes;
+            return agg.median_kbytes;
         }
         case BytesStddevType: {
-            return bchData.stddev_kbytes;
+            return agg.stddev_kbytes;
         }
         case BytesCvType: {
-            return bchData.cv_kbytes;
+            return agg.cv_kbytes;
         }
         
         // Items/s
@@ -94,25 +98,96 @@ double getYPlotValue(const BenchData &bchData, PlotValueType yType)
             return bchData.kitems_sec_dflt;
         }
         case ItemsMinType: {
-            return bchData.min_kitems;
+            return agg.min_kitems;
         }
         case ItemsMeanType: {
-            return bchData.mean_kitems;
+            return agg.mean_kitems;
         }
         case ItemsMedianType: {
-            return bchData.median_kitems;
+            return agg.median_kitems;
         }
         case ItemsStddevType: {
-            return bchData.stddev_kitems;
+            return agg.stddev_kitems;
         }
         case ItemsCvType: {
-            return bchData.cv_kitems;
+            return agg.cv_kitems;
+        }
+        
+        // User-defined
+        default: {
+            if ( !isCustomAggregate(yType) )
+                break;
+            const BenchCustomAggregate *custom = agg.findCustom( customAggregateId(yType) );
+            if (custom == nullptr)
+                break;  // not computed for this benchmark
+            switch ( customAggregateMetric(yType) )
+            {
+                case CpuTimeType:  case CpuTimeCvType:  return custom->cpu;
+                case RealTimeType: case RealTimeCvType: return custom->real;
+                case BytesType:    case BytesCvType:    return custom->kbytes;
+                case ItemsType:    case ItemsCvType:    return custom->kitems;
+                default:           break;
+            }
+            break;
         }
     }
     
     return -1;
 }
 
+static BenchColumn valueColumn(PlotValueType yType)
+{
+    switch (yType)
+    {
+        case CpuTimeType:        return CpuTimeColumn;
+        case CpuTimeMinType:     return MinCpuColumn;
+        case CpuTimeMeanType:    return MeanCpuColumn;
+        case CpuTimeMedianType:  return MedianCpuColumn;
+        case CpuTimeStddevType:  return StddevCpuColumn;
+        case CpuTimeCvType:      return CvCpuColumn;
+        
+        case RealTimeType:       return RealTimeColumn;
+        case RealTimeMinType:    return MinRealColumn;
+        case RealTimeMeanType:   return MeanRealColumn;
+        case RealTimeMedianType: return MedianRealColumn;
+        case RealTimeStddevType: return StddevRealColumn;
+        case RealTimeCvType:     return CvRealColumn;
+        
+        case IterationsType:     return IterationsColumn;
+        
+        case BytesType:          return KBytesColumn;
+        case BytesMinType:       return MinKBytesColumn;
+        case BytesMeanType:      return MeanKBytesColumn;
+        case BytesMedianType:    return MedianKBytesColumn;
+        case BytesStddevType:    return StddevKBytesColumn;
+        case BytesCvType:        return CvKBytesColumn;
+        
+        case ItemsType:          return KItemsColumn;
+        case ItemsMinType:       return MinKItemsColumn;
+        case ItemsMeanType:      return MeanKItemsColumn;
+        case ItemsMedianType:    return MedianKItemsColumn;
+        case ItemsStddevType:    return StddevKItemsColumn;
+        case ItemsCvType:        return CvKItemsColumn;
+        
+        default:                 break;
+    }
+    
+    return ColumnCount;
+}
+
+double getYPlotValue(const BenchResults &bchResults, int idx, PlotValueType yType)
+{
+    // User-defined aggregates (not in columns)
+    if ( !bchResults.hasColumns() || isCustomAggregate(yType) )
+        return getYPlotValue(bchResults.benchmarks[idx], yType);
+    
+    BenchColumn column = valueColumn(yType);
+    if (column == ColumnCount)
+        return -1;
+    
+    return bchResults.columns.value(column, idx);
+}
+
 QString getYPlotName(PlotValueType yType, QString timeUnit)
 {
     if (!timeUnit.isEmpty())
@@ -204,21 +279,81 @@ QString getYPlotName(PlotValueType yType, QString timeUnit)
         case ItemsCvType: {
             return "Items/s cv (%)";
         }
+        
+        // User-defined
+        default: {
+            if ( !isCustomAggregate(yType) )
+                break;
+            QString aggName = AggregateNames::name( customAggregateId(yType) );
+            switch ( customAggregateMetric(yType) )
+            {
+                case CpuTimeType:    return "CPU " + aggName + " time" + timeUnit;
+                case RealTimeType:   return "Real " + aggName + " time" + timeUnit;
+                case BytesType:      return "Bytes/s " + aggName + " (k)";
+                case ItemsType:      return "Items/s " + aggName + " (k)";
+                case CpuTimeCvType:  return "CPU " + aggName + " (%)";
+                case RealTimeCvType: return "Real " + aggName + " (%)";
+                case BytesCvType:    return "Bytes/s " + aggName + " (%)";
+                case ItemsCvType:    return "Items/s " + aggName + " (%)";
+                default:           break;
+            }
+            break;
+        }
     }
     
     return "Unknown";
 }
 
+// Metrics of user-defined aggregates (type = base + id * count + metric index), cv ones for percent unit
+static const PlotValueType customAggregateMetrics[] = {
+    CpuTimeType, RealTimeType, BytesType, ItemsType,
+    CpuTimeCvType, RealTimeCvType, BytesCvType, ItemsCvType
+};
+static const int customAggregateMetricCount = 8;
+
+PlotValueType customAggregateType(PlotValueType metric, int aggregateId)
+{
+    if (aggregateId < 0 || AggregateNames::name(aggregateId).isEmpty()) {
+        qWarning() << "Unknown user-defined aggregate:" << aggregateId;
+        return UnknownValueType;
+    }
+    
+    int metricIdx = 0;
+    while (metricIdx < customAggregateMetricCount && customAggregateMetrics[metricIdx] != metric)
+        ++metricIdx;
+    if (metricIdx == customAggregateMetricCount) {
+        qWarning() << "Unsupported metric of user-defined aggregate:" << metric;
+        return UnknownValueType;
+    }
+    
+    return static_cast<PlotValueType>(CustomAggregateType + aggregateId * customAggregateMetricCount + metricIdx);
+}
+
+bool isCustomAggregate(PlotValueType yType)
+{
+    return yType >= CustomAggregateType;
+}
+
+PlotValueType customAggregateMetric(PlotValueType yType)
+{
+    return customAggregateMetrics[(yType - CustomAggregateType) % customAggregateMetricCount];
+}
+
+int customAggregateId(PlotValueType yType)
+{
+    return (yType - CustomAggregateType) / customAggregateMetricCount;
+}
+
 double normalizeTimeUs(const BenchData &bchData, double value)
 {
-    double timeFactor = 1.;
-    if      (bchData.time_unit == "ns") timeFactor = 0.001;
-    else if (bchData.time_unit == "ms") timeFactor = 1000.;
-    return value * timeFactor;
+    return value * timeUnitFactorUs(bchData.time_unit);
 }
 
 bool isYTimeBased(PlotValueType yType)
 {
+    if ( isCustomAggregate(yType) )
+        yType = customAggregateMetric(yType);
+    
     if (   yType != PlotValueType::RealTimeType       && yType != PlotValueType::CpuTimeType
         && yType != PlotValueType::RealTimeMinType    && yType != PlotValueType::CpuTimeMinType
         && yType != PlotValueType::RealTimeMeanType   && yType != PlotValueType::CpuTimeMeanType
@@ -229,7 +364,7 @@ bool isYTimeBased(PlotValueType yType)
     return true;
 }
 
-double findMedian(QVector<double> sorted, int begin, int end)
+double findMedian(const QVector<double> &sorted, int begin, int end)
 {
     int count = end - begin;
     if (count <= 0) return 0.;
@@ -245,7 +380,10 @@ double findMedian(QVector<double> sorted, int begin, int end)
 
 BenchYStats getYPlotStats(BenchData &bchData, PlotValueType yType)
 {
+    const BenchAggregate &agg = bchData.aggregates();
     BenchYStats statRes;
+    if ( isCustomAggregate(yType) )
+        yType = customAggregateMetric(yType);
     
     // No statistics
     if (!bchData.hasAggregate) {
@@ -264,9 +402,9 @@ BenchYStats getYPlotStats(BenchData &bchData, PlotValueType yType)
         case CpuTimeType:
         case CpuTimeMinType: case CpuTimeMeanType: case CpuTimeMedianType: case CpuTimeStddevType:
         {
-            statRes.min    = bchData.min_cpu;
-            statRes.max    = bchData.max_cpu;
-            statRes.median = bchData.median_cpu;
+            statRes.min    = agg.min_cpu;
+            statRes.max    = agg.max_cpu;
+            statRes.median = agg.median_cpu;
             
             std::sort(bchData.cpu_time.begin(), bchData.cpu_time.end());
             int count = bchData.cpu_time.count();
@@ -279,9 +417,9 @@ BenchYStats getYPlotStats(BenchData &bchData, PlotValueType yType)
         case RealTimeType:
         case RealTimeMinType: case RealTimeMeanType: case RealTimeMedianType: case RealTimeStddevType:
         {
-            statRes.min    = bchData.min_real;
-            statRes.max    = bchData.max_real;
-            statRes.median = bchData.median_real;
+            statRes.min    = agg.min_real;
+            statRes.max    = agg.max_real;
+            statRes.median = agg.median_real;
             
             std::sort(bchData.real_time.begin(), bchData.real_time.end());
             int count = bchData.real_time.count();
@@ -294,9 +432,9 @@ BenchYStats getYPlotStats(BenchData &bchData, PlotValueType yType)
         case BytesType:
         case BytesMinType: case BytesMeanType: case BytesMedianType: case BytesStddevType:
         {
-            statRes.min    = bchData.min_kbytes;
-            statRes.max    = bchData.max_kbytes;
-            statRes.median = bchData.median_kbytes;
+            statRes.min    = agg.min_kbytes;
+            statRes.max    = agg.max_kbytes;
+            statRes.median = agg.median_kbytes;
             
             std::sort(bchData.kbytes_sec.begin(), bchData.kbytes_sec.end());
             int count = bchData.kbytes_sec.count();
@@ -309,9 +447,9 @@ BenchYStats getYPlotStats(BenchData &bchData, PlotValueType yType)
         case ItemsType:
         case ItemsMinType: case ItemsMeanType: case ItemsMedianType: case ItemsStddevType:
         {
-            statRes.min    = bchData.min_kitems;
-            statRes.max    = bchData.max_kitems;
-            statRes.median = bchData.median_kitems;
+            statRes.min    = agg.min_kitems;
+            statRes.max    = agg.max_kitems;
+            statRes.median = agg.median_kitems;
             
             std::sort(bchData.kitems_sec.begin(), bchData.kitems_sec.end());
             int count = bchData.kitems_sec.count();
@@ -335,6 +473,82 @@ BenchYStats getYPlotStats(BenchData &bchData, PlotValueType yType)
     return statRes;
 }
 
+BenchYStats getYPlotStats(const BenchResults &bchResults, int idx, PlotValueType yType)
+{
+    if ( !bchResults.hasColumns() ) {
+        BenchData bchData = bchResults.benchmarks[idx];
+        return getYPlotStats(bchData, yType);
+    }
+    
+    BenchYStats statRes;
+    statRes.min      = 0.;
+    statRes.max      = 0.;
+    statRes.median   = 0.;
+    statRes.lowQuart = 0.;
+    statRes.uppQuart = 0.;
+    
+    // No statistics
+    const BenchColumns &columns = bchResults.columns;
+    if ( !columns.hasAggregate(idx) )
+        return statRes;
+    
+    const BenchData &bchData = bchResults.benchmarks[idx];
+    double timeFactor = timeUnitFactorUs(bchData.time_unit);
+    double factor = 1.;
+    BenchColumn repColumn, minColumn, maxColumn, medianColumn;
+    if ( isCustomAggregate(yType) )
+        yType = customAggregateMetric(yType);
+    switch (yType)
+    {
+        case CpuTimeType:
+        case CpuTimeMinType: case CpuTimeMeanType: case CpuTimeMedianType: case CpuTimeStddevType:
+        {
+            repColumn = CpuTimeColumn;
+            factor = timeFactor;
+            minColumn = MinCpuColumn; maxColumn = MaxCpuColumn; medianColumn = MedianCpuColumn;
+            break;
+        }
+        case RealTimeType:
+        case RealTimeMinType: case RealTimeMeanType: case RealTimeMedianType: case RealTimeStddevType:
+        {
+            repColumn = RealTimeColumn;
+            factor = timeFactor;
+            minColumn = MinRealColumn; maxColumn = MaxRealColumn; medianColumn = MedianRealColumn;
+            break;
+        }
+        case BytesType:
+        case BytesMinType: case BytesMeanType: case BytesMedianType: case BytesStddevType:
+        {
+            repColumn = KBytesColumn;
+            minColumn = MinKBytesColumn; maxColumn = MaxKBytesColumn; medianColumn = MedianKBytesColumn;
+            break;
+        }
+        case ItemsType:
+        case ItemsMinType: case ItemsMeanType: case ItemsMedianType: case ItemsStddevType:
+        {
+            repColumn = KItemsColumn;
+            minColumn = MinKItemsColumn; maxColumn = MaxKItemsColumn; medianColumn = MedianKItemsColumn;
+            break;
+        }
+        default:    //Error
+            return statRes;
+    }
+    
+    statRes.min    = columns.value(minColumn, idx);
+    statRes.max    = columns.value(maxColumn, idx);
+    statRes.median = columns.value(medianColumn, idx);
+    
+    // Quartiles from sorted repetitions (durations in us)
+    const QVector<double> &sorted = columns.sortedRepetitions(repColumn);
+    int begin, end;
+    columns.repetitionRange(repColumn, idx, begin, end);
+    int count = end - begin;
+    statRes.lowQuart = findMedian(sorted, begin, begin + count/2) * factor;
+    statRes.uppQuart = findMedian(sorted, begin + count/2 + (count%2), end) * factor;
+    
+    return statRes;
+}
+
 bool commonPartEqual(const QStringList &listA, const QStringList &listB)
 {
     bool isEqual = true;
@@ -17,7 +17,8 @@
 #include "ui_plotter_3dbars.h"
 
 #include "benchmark_results.h"
-#include "result_parser.h"
+#include "result_reloader.h"
+#include "result_snapshots.h"
 
 #include <QFileInfo>
 #include <QDateTime>
@@ -26,6 +27,7 @@
 #include <QJsonObject>
 #include <QJsonDocument>
 #include <QtDataVisualization>
+#include <QtConcurrent>
 
 #include <memory>
 #include <utility>
@@ -33,18 +35,70 @@
 static const char* config_file = "config_3dbars.json";
 static const bool force_config = false;
 
+// Bars rows with Y-values in displayed time unit
+static QBarDataArray* newBarArray(const QVector<QVector<double>> &rows, double timeFactor)
+{
+    QBarDataArray* dataArray = new QBarDataArray;
+    dataArray->reserve( rows.size() );
+    for (const auto& row : rows)
+    {
+        QBarDataRow* newRow = new QBarDataRow;
+        newRow->reserve( row.size() );
+        for (double value : row)
+            newRow->append( static_cast<float>(value * timeFactor) );
+        dataArray->append(newRow);
+    }
+    
+    return dataArray;
+}
+
+// Same rows, columns and labels as displayed
+static bool sameBarsLayout(const QBarDataProxy* dataProxy, const Bars3DSeriesData &seriesData)
+{
+    if (dataProxy->rowCount() != seriesData.rows.size()
+            || dataProxy->rowLabels() != seriesData.rowLabels
+            || dataProxy->columnLabels() != seriesData.columnLabels)
+        return false;
+    
+    for (int row = 0; row < seriesData.rows.size(); ++row)
+        if (dataProxy->rowAt(row)->size() != seriesData.rows[row].size())
+            return false;
+    return true;
+}
 
-Plotter3DBars::Plotter3DBars(const BenchResults &bchResults, const QVector<int> &bchIdxs,
+// Bars series, named if Z-param
+static QBar3DSeries* newBarSeries(const Bars3DSeriesData &seriesData, bool hasZParam, double timeFactor)
+{
+    QBar3DSeries* series = new QBar3DSeries;
+    series->dataProxy()->resetArray(newBarArray(seriesData.rows, timeFactor),
+                                    seriesData.rowLabels, seriesData.columnLabels);
+    
+    if (!hasZParam) {
+        series->setItemLabelFormat(QStringLiteral("@rowLabel [X=@colLabel]: @valueLabel"));
+    }
+    else {
+        series->setName(seriesData.name);
+        series->setItemLabelFormat(QStringLiteral("@seriesName [@colLabel, @rowLabel]: @valueLabel"));
+    }
+    series->setMesh(QAbstract3DSeries::MeshBevelBar);
+    series->setMeshSmooth(false);
+    
+    return series;
+}
+
+
+Plotter3DBars::Plotter3DBars(const BenchSnapshot &bchResults, const QVector<int> &bchIdxs,
                              const PlotParams &plotParams, const QString &origFilename,
                              const QVector<FileReload>& addFilenames, QWidget *parent)
     : QWidget(parent)
     , ui(new Ui::Plotter3DBars)
+    , mBchResults(bchResults)
     , mBenchIdxs(bchIdxs)
     , mPlotParams(plotParams)
     , mOrigFilename(origFilename)
     , mAddFilenames(addFilenames)
-    , mAllIndexes(bchIdxs.size() == bchResults.benchmarks.size())
-    , mWatcher(parent)
+    , mSourceKey(ResultSnapshots::sourceKey(origFilename, addFilenames))
+    , mAllIndexes(bchIdxs.size() == bchResults->benchmarks.size())
 {
     // UI
     ui->setupUi(this);
@@ -55,19 +109,20 @@ Plotter3DBars::Plotter3DBars(const BenchResults &bchResults, const QVector<int>
     
     connectUI();
     
-    // Init
-    setupChart(bchResults, bchIdxs, plotParams);
-    setupOptions();
-    
-    // Show
-    QWidget *container = QWidget::createWindowContainer(mBars);
-    ui->horizontalLayout->insertWidget(0, container, 1);
+    // Init (shown once computed)
+    this->setEnabled(false);
+    computeChart();
 }
 
 Plotter3DBars::~Plotter3DBars()
 {
+    // Stop computing
+    if ( !mChartCanceled.isNull() )
+        mChartCanceled->storeRelaxed(1);
+    
     // Save options to file
-    saveConfig();
+    if (mBars != nullptr)
+        saveConfig();
     
     delete ui;
 }
@@ -125,13 +180,31 @@ void Plotter3DBars::connectUI()
     connect(ui->spinBoxMTicks,       QOverload<int>::of(&QSpinBox::valueChanged), this, &Plotter3DBars::onSpinMTicksChanged);
     
     // Actions
-    connect(&mWatcher,              &QFileSystemWatcher::fileChanged, this, &Plotter3DBars::onAutoReload);
     connect(ui->checkBoxAutoReload, &QCheckBox::stateChanged, this, &Plotter3DBars::onCheckAutoReload);
     connect(ui->pushButtonReload,   &QPushButton::clicked, this, &Plotter3DBars::onReloadClicked);
+    connect(ResultSnapshots::instance(), &ResultSnapshots::published, this, &Plotter3DBars::onResultsPublished);
+    connect(&mChartWatcher, &QFutureWatcher<Bars3DChartData>::finished, this, &Plotter3DBars::onChartComputed);
     connect(ui->pushButtonSnapshot, &QPushButton::clicked, this, &Plotter3DBars::onSnapshotClicked);
 }
 
-void Plotter3DBars::setupChart(const BenchResults &bchResults, const QVector<int> &bchIdxs, const PlotParams &plotParams, bool init)
+void Plotter3DBars::computeChart()
+{
+    // Supersede running computation
+    if ( !mChartCanceled.isNull() )
+        mChartCanceled->storeRelaxed(1);
+    mChartCanceled = QSharedPointer<QAtomicInt>::create(0);
+    
+    // Worker only uses copies (results immutable)
+    BenchSnapshot bchResults = mBchResults;
+    QVector<int> bchIdxs = mBenchIdxs;
+    PlotParams plotParams = mPlotParams;
+    QSharedPointer<QAtomicInt> canceled = mChartCanceled;
+    mChartWatcher.setFuture( QtConcurrent::run([bchResults, bchIdxs, plotParams, canceled]() {
+        return ChartData::compute3DBars(*bchResults, bchIdxs, plotParams, canceled.data());
+    }) );
+}
+
+void Plotter3DBars::setupChart(const Bars3DChartData &chartData, bool init)
 {
     std::unique_ptr<Q3DBars> scopedBars;
     Q3DBars* bars = nullptr;
@@ -152,168 +225,17 @@ void Plotter3DBars::setupChart(const BenchResults &bchResults, const QVector<int
     Q_ASSERT(bars);
     
     // Time unit
-    mCurrentTimeFactor = 1.;
-    if ( isYTimeBased(mPlotParams.yType) ) {
-        if (     bchResults.meta.time_unit == "ns") mCurrentTimeFactor = 1000.;
-        else if (bchResults.meta.time_unit == "ms") mCurrentTimeFactor = 0.001;
-    }
-    
+    mCurrentTimeFactor = ChartData::timeFactor(chartData.timeUnit, mPlotParams.yType);
     
-    // 3D
-    // X: argumentA or templateB
-    // Y: time/iter/bytes/items (not name dependent)
-    // Z: argumentC or templateD (with C!=A, D!=B)
-    bool hasZParam = plotParams.zType != PlotEmptyType;
     
-    //
-    // No Z-param -> one row per benchmark type
-    if (!hasZParam)
+    // 3D (computed rows)
+    bool hasZParam = mPlotParams.zType != PlotEmptyType;
+    for (const auto& seriesData : chartData.series)
     {
-        // Single series (i.e. color)
-        std::unique_ptr<QBar3DSeries> series(new QBar3DSeries);
-
-        QVector<BenchSubset> bchSubsets = bchResults.groupParam(plotParams.xType == PlotArgumentType,
-                                                                bchIdxs, plotParams.xIdx, "X");
-        bool firstCol = true;
-        for (const auto& bchSubset : std::as_const(bchSubsets))
-        {
-            // One row per benchmark * X-group
-            std::unique_ptr<QBarDataRow> data(new QBarDataRow);
-            
-            const QString & subsetName = bchSubset.name;
-//            qDebug() << "subsetName:" << subsetName;
-//            qDebug() << "subsetIdxs:" << bchSubset.idxs;
-            
-            QStringList colLabels;
-            for (int idx : bchSubset.idxs)
-            {
-                QString xName = bchResults.getParamName(plotParams.xType == PlotArgumentType,
-                                                        idx, plotParams.xIdx);
-                colLabels.append(xName);
-                
-                // Add column
-                data->append( static_cast<float>(getYPlotValue(bchResults.benchmarks[idx], plotParams.yType) * mCurrentTimeFactor) );
-            }
-            // Add benchmark row
-            series->dataProxy()->addRow(data.release(), subsetName);
-            
-            // Set column labels (only if no collision, empty otherwise)
-            if (firstCol) // init
-                series->dataProxy()->setColumnLabels(colLabels);
-            else if ( commonPartEqual(series->dataProxy()->columnLabels(), colLabels) ) {
-                if (series->dataProxy()->columnLabels().size() < colLabels.size()) // replace by longest
-                    series->dataProxy()->setColumnLabels(colLabels);
-            }
-            else { // collision
-                series->dataProxy()->setColumnLabels( QStringList("") );
-            }
-            firstCol = false;
-//            qDebug() << "[Multi-NoZ] colLabels:" << colLabels << "|" << series->dataProxy()->columnLabels();
-        }
-        // Add series
-        series->setItemLabelFormat(QStringLiteral("@rowLabel [X=@colLabel]: @valueLabel"));
-        series->setMesh(QAbstract3DSeries::MeshBevelBar);
-        series->setMeshSmooth(false);
-        mSeriesMapping.push_back({"", ""}); // color set later
-        
-        bars->addSeries(series.release());
-    }
-    //
-    // Z-param -> one series per benchmark, one row per Z, one column per X
-    else
-    {
-        // Initial segmentation by 'full name % param1 % param2' (group benchmarks)
-        const auto bchNames = bchResults.segment2DNames(bchIdxs,
-                                                        plotParams.xType == PlotArgumentType, plotParams.xIdx,
-                                                        plotParams.zType == PlotArgumentType, plotParams.zIdx);
-        QStringList prevRowLabels, prevColLabels;
-        bool sameRowLabels = true, sameColLabels = true;
-        for (const auto& bchName : bchNames)
-        {
-            // One series (i.e. color) per 2D name
-            std::unique_ptr<QBar3DSeries> series(new QBar3DSeries);
-//            qDebug() << "bchName" << bchName.name << "|" << bchName.idxs;
-            
-            // Segment: one sub per Z-param from 2D names
-            QVector<BenchSubset> bchZSubs = bchResults.segmentParam(plotParams.zType == PlotArgumentType,
-                                                                    bchName.idxs, plotParams.zIdx);
-            QStringList curRowLabels;
-            for (const auto& bchZSub : std::as_const(bchZSubs))
-            {
-//                qDebug() << "bchZSub" << bchZSub.name << "|" << bchZSub.idxs;
-                curRowLabels.append(bchZSub.name);
-                
-                // One row per Z-param from 2D names
-                std::unique_ptr<QBarDataRow> data(new QBarDataRow);
-                
-                // Group: one column per X-param
-                QVector<BenchSubset> bchSubsets = bchResults.groupParam(plotParams.xType == PlotArgumentType,
-                                                                        bchZSub.idxs, plotParams.xIdx, "X");
-                Q_ASSERT(bchSubsets.size() == 1);
-                if (bchSubsets.empty()) {
-                    qWarning() << "Missing X-parameter subset for Z-row: " << bchZSub.name;
-                    break;
-                }
-                const auto& bchSubset = bchSubsets[0];
-                
-                QStringList curColLabels;
-                for (int idx : bchSubset.idxs)
-                {
-                    QString xName = bchResults.getParamName(plotParams.xType == PlotArgumentType,
-                                                            idx, plotParams.xIdx);
-                    curColLabels.append(xName);
-                    
-                    // Y-values on row
-                    data->append( static_cast<float>(getYPlotValue(bchResults.benchmarks[idx], plotParams.yType) * mCurrentTimeFactor) );
-                }
-                // Add benchmark row
-                series->dataProxy()->addRow(data.release());
-                                    
-                // Check column labels collisions
-                if (sameColLabels) {
-                    if ( prevColLabels.isEmpty() ) // init
-                        prevColLabels = curColLabels;
-                    else {
-                        if ( commonPartEqual(prevColLabels, curColLabels) ) {
-                            if (prevColLabels.size() < curColLabels.size()) // replace by longest
-                                prevColLabels = curColLabels;
-                        }
-                        else sameColLabels = false;
-                    }
-                }
-//                qDebug() << "[Multi-Z] curColLabels:" << curColLabels << "|" << prevColLabels;
-            }
-            // Check row labels collisions
-            if (sameRowLabels) {
-                if ( prevRowLabels.isEmpty() ) // init
-                    prevRowLabels = curRowLabels;
-                else {
-                    if ( commonPartEqual(prevRowLabels, curRowLabels) ) {
-                        if (prevRowLabels.size() < curRowLabels.size()) // replace by longest
-                            prevRowLabels = curRowLabels;
-                    }
-                    else sameRowLabels = false;
-                }
-            }
-//            qDebug() << "[Multi-Z] curRowLabels:" << curRowLabels << "|" << prevRowLabels;
-            //
-            // Add series
-            series->setName( bchName.name );
-            mSeriesMapping.push_back({bchName.name, bchName.name}); // color set later
-            series->setItemLabelFormat(QStringLiteral("@seriesName [@colLabel, @rowLabel]: @valueLabel"));
-            series->setMesh(QAbstract3DSeries::MeshBevelBar);
-            series->setMeshSmooth(false);
-            
-            bars->addSeries(series.release());
-        }
-        // Set row/column labels (empty if collisions)
-        if ( !bars->seriesList().isEmpty() && bars->seriesList().constFirst()->dataProxy()->rowCount() > 0)
-        {
-            for (auto &series : bars->seriesList()) {
-                series->dataProxy()->setColumnLabels(sameColLabels ? prevColLabels : QStringList(""));
-                series->dataProxy()->setRowLabels(   sameRowLabels ? prevRowLabels : QStringList(""));
-            }
-        }
+        // One series (i.e. color) per benchmark, or single one if no Z-param
+        // Row/column labels empty if collisions
+        bars->addSeries( newBarSeries(seriesData, hasZParam, mCurrentTimeFactor) );
+        mSeriesMapping.push_back({seriesData.name, seriesData.name}); // color set later
     }
     
     // Axes
@@ -324,26 +246,21 @@ void Plotter3DBars::setupChart(const BenchResults &bchResults, const QVector<int
         
         // X-axis
         QCategory3DAxis *colAxis = bars->columnAxis();
-        if (plotParams.xType == PlotArgumentType)
-            colAxis->setTitle("Argument " + QString::number(plotParams.xIdx+1));
-        else if (plotParams.xType == PlotTemplateType)
-            colAxis->setTitle("Template " + QString::number(plotParams.xIdx+1));
-        if (plotParams.xType != PlotEmptyType)
+        if ( !chartData.xTitle.isEmpty() ) {
+            colAxis->setTitle(chartData.xTitle);
             colAxis->setTitleVisible(true);
+        }
         
         // Y-axis
         QValue3DAxis *valAxis = bars->valueAxis();
-        valAxis->setTitle( getYPlotName(plotParams.yType, bchResults.meta.time_unit) );
+        valAxis->setTitle(chartData.yTitle);
         valAxis->setTitleVisible(true);
         
         // Z-axis
-        if (plotParams.zType != PlotEmptyType)
+        if ( !chartData.zTitle.isEmpty() )
         {
             QCategory3DAxis *rowAxis = bars->rowAxis();
-            if (plotParams.zType == PlotArgumentType)
-                rowAxis->setTitle("Argument " + QString::number(plotParams.zIdx+1));
-            else
-                rowAxis->setTitle("Template " + QString::number(plotParams.zIdx+1));
+            rowAxis->setTitle(chartData.zTitle);
             rowAxis->setTitleVisible(true);
         }
     }
@@ -361,6 +278,81 @@ void Plotter3DBars::setupChart(const BenchResults &bchResults, const QVector<int
     }
 }
 
+bool Plotter3DBars::reconcileChart(const Bars3DChartData &chartData, QString &errorMsg)
+{
+    // Existing series required (i.e. axes set)
+    const auto oldBarsSeries = mBars->seriesList();
+    if (oldBarsSeries.isEmpty() || chartData.series.isEmpty()) {
+        errorMsg = "No compatible series to display";
+        return false;
+    }
+    
+    // Subset of benchmarks: same series required (in order)
+    if ( !mAllIndexes && !sameSeriesNames(mSeriesMapping, chartData.series, errorMsg) )
+        return false;
+    
+    // Match series by name
+    QHash<QString, const Bars3DSeriesData*> newSeries;
+    for (const auto& seriesData : chartData.series)
+        newSeries.insert(seriesData.name, &seriesData);
+    
+    // Update kept series (changed items only), remove others
+    SeriesMapping newMapping;
+    for (int idx = 0; idx < oldBarsSeries.size(); ++idx)
+    {
+        QBar3DSeries* series = oldBarsSeries[idx];
+        const Bars3DSeriesData* seriesData = newSeries.take(mSeriesMapping[idx].oldName);
+        if (seriesData == nullptr) {
+            mBars->removeSeries(series);
+            delete series;
+            continue;
+        }
+        
+        QBarDataProxy* dataProxy = series->dataProxy();
+        if ( sameBarsLayout(dataProxy, *seriesData) )
+        {
+            const auto& rows = seriesData->rows;
+            for (int row = 0; row < rows.size(); ++row)
+            {
+                for (int col = 0; col < rows[row].size(); ++col) {
+                    float value = static_cast<float>(rows[row][col] * mCurrentTimeFactor);
+                    if (dataProxy->itemAt(row, col)->value() != value)
+                        dataProxy->setItem(row, col, QBarDataItem(value));
+                }
+            }
+        }
+        else {
+            dataProxy->resetArray(newBarArray(seriesData->rows, mCurrentTimeFactor),
+                                  seriesData->rowLabels, seriesData->columnLabels);
+        }
+        newMapping.push_back(mSeriesMapping[idx]);
+    }
+    
+    // Add new series
+    int keptCount = newMapping.size();
+    bool hasZParam = mPlotParams.zType != PlotEmptyType;
+    for (const auto& seriesData : chartData.series)
+    {
+        if ( !newSeries.contains(seriesData.name) )
+            continue;
+        
+        QBar3DSeries* series = newBarSeries(seriesData, hasZParam, mCurrentTimeFactor);
+        mBars->addSeries(series);
+        
+        newMapping.push_back({seriesData.name, seriesData.name});
+    }
+    mSeriesMapping = newMapping;
+    
+    // New series: saved config if any, as when set up
+    if (keptCount < mSeriesMapping.size()) {
+        loadSeriesConfig(QString(config_folder) + config_file, mSeriesMapping, keptCount);
+        applySeriesConfig(keptCount);
+        onComboGradientChanged( ui->comboBoxGradient->currentIndex() );
+    }
+    
+    return true;
+}
+
 void Plotter3DBars::setupOptions(bool init)
 {
     // General
@@ -474,8 +466,23 @@ void Plotter3DBars::setupOptions(bool init)
         onCheckAutoReload(Qt::Checked);
     
     // Update series color config
+    applySeriesConfig();
+    
+    // Restore selected axis
+    if (!init)
+        ui->comboBoxAxis->setCurrentIndex(prevAxisIdx);
+    
+    // Update timestamp
+    QDateTime today = QDateTime::currentDateTime();
+    QTime now = today.time();
+    ui->labelLastReload->setText("(Last: " + now.toString() +")");
+}
+
+// Saved or edited colors and names applied to series (theme colors kept otherwise)
+void Plotter3DBars::applySeriesConfig(int from)
+{
     const auto& chartSeries = mBars->seriesList();
-    for (int idx = 0 ; idx < mSeriesMapping.size(); ++idx)
+    for (int idx = from; idx < mSeriesMapping.size(); ++idx)
     {
         auto& config = mSeriesMapping[idx];
         const auto& series = chartSeries.at(idx);
@@ -489,15 +496,6 @@ void Plotter3DBars::setupOptions(bool init)
         if (config.newName != config.oldName)
             series->setName( config.newName );
     }
-    
-    // Restore selected axis
-    if (!init)
-        ui->comboBoxAxis->setCurrentIndex(prevAxisIdx);
-    
-    // Update timestamp
-    QDateTime today = QDateTime::currentDateTime();
-    QTime now = today.time();
-    ui->labelLastReload->setText("(Last: " + now.toString() +")");
 }
 
 void Plotter3DBars::loadConfig(bool init)
@@ -527,25 +525,7 @@ void Plotter3DBars::loadConfig(bool init)
             ui->doubleSpinBoxSpacingZ->setValue( json["bars.spacing.z"].toDouble() );
         
         // Series
-        if (json.contains("series") && json["series"].isArray())
-        {
-            auto series = json["series"].toArray();
-            for (int idx = 0; idx < series.size(); ++idx) {
-                QJsonObject config = series[idx].toObject();
-                if ( config.contains("oldName")  && config["oldName"].isString()
-                  && config.contains("newName")  && config["newName"].isString()
-                  && config.contains("newColor") && config["newColor"].isString()
-                  && QColor::isValidColorName(config["newColor"].toString()) )
-                {
-                    SeriesConfig savedConfig(config["oldName"].toString(), "");
-                    int iCfg = mSeriesMapping.indexOf(savedConfig);
-                    if (iCfg >= 0) {
-                        mSeriesMapping[iCfg].newName = config["newName"].toString();
-                        mSeriesMapping[iCfg].newColor.fromString( config["newColor"].toString() );
-                    }
-                }
-            }
-        }
+        loadSeriesConfig(json, mSeriesMapping);
         
         // Time
         if (!init) {
@@ -1141,238 +1121,69 @@ void Plotter3DBars::onSpinMTicksChanged(int i)
 // Actions
 void Plotter3DBars::onCheckAutoReload(int state)
 {
+    // Watched once for all windows of same files
     if (state == Qt::Checked)
-    {
-        if (mWatcher.files().empty())
-        {
-            mWatcher.addPath(mOrigFilename);
-            for (const auto& addFilename : mAddFilenames)
-                mWatcher.addPath( addFilename.filename );
-        }
-    }
+        ResultReloader::instance()->watch(this, mOrigFilename, mAddFilenames);
     else
-    {
-        if (!mWatcher.files().empty())
-            mWatcher.removePaths( mWatcher.files() );
-    }
+        ResultReloader::instance()->unwatch(this);
 }
 
-void Plotter3DBars::onAutoReload(const QString &path)
+void Plotter3DBars::onReloadClicked()
 {
-    QFileInfo fi(path);
-    if (fi.exists() && fi.isReadable() && fi.size() > 0)
-        onReloadClicked();
-    else
-        qWarning() << "Unable to auto-reload file: " << path;
+    // Parsed once for all windows of same files (updated on publication)
+    ResultReloader::instance()->reload(mOrigFilename, mAddFilenames, this);
 }
 
-void Plotter3DBars::onReloadClicked()
+void Plotter3DBars::onResultsPublished(const QString &sourceKey, const BenchSnapshot &bchResults)
 {
-    // Load new results
-    QString errorMsg;
-    BenchResults newBchResults = ResultParser::parseJsonFile( mOrigFilename, errorMsg );
-    
-    if ( newBchResults.benchmarks.isEmpty() ) {
-        QMessageBox::critical(this, "Chart reload", "Error parsing original file: " + mOrigFilename + " -> " + errorMsg);
+    // Newer results of same files only
+    if (sourceKey != mSourceKey || bchResults->version <= mBchResults->version)
         return;
-    }
     
-    for (const auto& addFile : std::as_const(mAddFilenames))
+    // Check compatibility with previous (current results kept if rejected)
+    if (mBenchIdxs.size() != bchResults->benchmarks.size())
     {
-        errorMsg.clear();
-        BenchResults newAddResults = ResultParser::parseJsonFile(addFile.filename, errorMsg);
-        if ( newAddResults.benchmarks.isEmpty() ) {
-            QMessageBox::critical(this, "Chart reload", "Error parsing additional file: " + addFile.filename + " -> " + errorMsg);
+        if (!mAllIndexes) {
+            QMessageBox::critical(this, "Chart reload", "Number of series/points is different");
             return;
         }
-        
-        if (addFile.isAppend)
-            newBchResults.appendResults(newAddResults);
-        else
-            newBchResults.overwriteResults(newAddResults);
+        mBenchIdxs = bchResults->segmentAll();
     }
+    mBchResults = bchResults;
     
-    // Check compatibility with previous
-    errorMsg.clear();
-    if (mBenchIdxs.size() != newBchResults.benchmarks.size())
-    {
-        errorMsg = "Number of series/points is different";
-        if (mAllIndexes)
-        {
-            mBenchIdxs.clear();
-            for (int i=0; i<newBchResults.benchmarks.size(); ++i)
-                mBenchIdxs.append(i);
-        }
-    }
+    // Updated once computed
+    computeChart();
+}
+
+void Plotter3DBars::onChartComputed()
+{
+    // Superseded meanwhile
+    if (mChartCanceled->loadRelaxed() != 0)
+        return;
+    const Bars3DChartData chartData = mChartWatcher.result();
     
-    while ( errorMsg.isEmpty() )  // once
+    // First chart
+    if (mBars == nullptr)
     {
-        // Check chart type
-        bool hasZParam = mPlotParams.zType != PlotEmptyType;
-        if (!hasZParam)
-        {
-            // Check compatibility with previous
-            const auto& oldBarsSeries = mBars->seriesList();
-            if (oldBarsSeries.size() != 1) {
-                errorMsg = "No single series originally";
-                break;
-            }
-            const auto oldSeries = oldBarsSeries[0];
-            const auto oldDataProxy = oldSeries->dataProxy();
-    
-            QVector<BenchSubset> newBchSubsets = newBchResults.groupParam(mPlotParams.xType == PlotArgumentType,
-                                                                          mBenchIdxs, mPlotParams.xIdx, "X");
-            if (newBchSubsets.size() != oldDataProxy->rowCount()) {
-                errorMsg = "Number of single series rows is different";
-                break;
-            }
-            
-            int newRowsIdx = 0;
-            for (const auto& bchSubset : std::as_const(newBchSubsets))
-            {
-                const auto& oldRowLabel = oldDataProxy->rowLabels().at(newRowsIdx);
-                const QString& subsetName = bchSubset.name;
-                if (subsetName != oldRowLabel)
-                {
-                    errorMsg = "Series row has different name";
-                    break;
-                }
-                const auto& oldRow = oldDataProxy->rowAt(newRowsIdx);
-                if (bchSubset.idxs.size() != oldRow->size())
-                {
-                    errorMsg = "Number of series columns is different";
-                    break;
-                }
-                ++newRowsIdx;
-            }
-            
-            // Direct update if compatible
-            if ( errorMsg.isEmpty() )
-            {
-                newRowsIdx = 0;
-                for (const auto& bchSubset : std::as_const(newBchSubsets))
-                {
-                    int newColsIdx = 0;
-                    for (int idx : bchSubset.idxs)
-                    {
-                        // Update item
-                        oldDataProxy->setItem(newRowsIdx, newColsIdx,
-                                              QBarDataItem( static_cast<float>(getYPlotValue(newBchResults.benchmarks[idx], mPlotParams.yType) * mCurrentTimeFactor) ));
-                        ++newColsIdx;
-                    }
-                    ++newRowsIdx;
-                }
-            }
-        }
-        else
-        {
-            // Check compatibility with previous
-            const auto& oldBarsSeries = mBars->seriesList();
-            if (oldBarsSeries.empty()) {
-                errorMsg = "No series originally";
-                break;
-            }
-            
-            const auto newBchNames = newBchResults.segment2DNames(mBenchIdxs,
-                                                                 mPlotParams.xType == PlotArgumentType, mPlotParams.xIdx,
-                                                                 mPlotParams.zType == PlotArgumentType, mPlotParams.zIdx);
-            if (newBchNames.size() != oldBarsSeries.size()) {
-                errorMsg = "Number of series is different";
-                break;
-            }
-            
-            int newSeriesIdx = 0;
-            for (const auto& bchName : newBchNames)
-            {
-                const auto& oldSeries = oldBarsSeries.at(newSeriesIdx);
-                const auto& oldDataProxy = oldSeries->dataProxy();
-                if (bchName.name != mSeriesMapping[newSeriesIdx].oldName)
-                {
-                    errorMsg = "Series has different name";
-                    break;
-                }
-                
-                QVector<BenchSubset> newBchZSubs = newBchResults.segmentParam(mPlotParams.zType == PlotArgumentType,
-                                                                              bchName.idxs, mPlotParams.zIdx);
-                if (newBchZSubs.size() != oldDataProxy->rowCount()) {
-                    errorMsg = "Number of series rows is different";
-                    break;
-                }
-                
-                int newRowsIdx = 0;
-                for (const auto& bchZSub : std::as_const(newBchZSubs))
-                {
-                    const auto& oldRowLabel = oldDataProxy->rowLabels().size() < newRowsIdx ?
-                                                oldDataProxy->rowLabels().at(newRowsIdx) : "";
-                    const QString& subsetName = bchZSub.name;
-                    if (subsetName != oldRowLabel && !oldRowLabel.isEmpty())
-                    {
-                        errorMsg = "Series row has different name";
-                        break;
-                    }
-    
-                    const auto& oldRow = oldDataProxy->rowAt(newRowsIdx);
-                    QVector<BenchSubset> newBchSubsets = newBchResults.groupParam(mPlotParams.xType == PlotArgumentType,
-                                                                                  bchZSub.idxs, mPlotParams.xIdx, "X");
-                    Q_ASSERT(newBchSubsets.size() == 1);
-                    if (newBchSubsets.empty()) {
-                        qWarning() << "Missing X-parameter subset for Z-row: " << bchZSub.name;
-                        break;
-                    }
-                    if (newBchSubsets[0].idxs.size() != oldRow->size())
-                    {
-                        errorMsg = "Number of series columns is different";
-                        break;
-                    }
-                    ++newRowsIdx;
-                }
-                ++newSeriesIdx;
-            }
-            
-            // Direct update if compatible
-            if ( errorMsg.isEmpty() )
-            {
-                newSeriesIdx = 0;
-                for (const auto& bchName : newBchNames)
-                {
-                    const auto& oldSeries = oldBarsSeries.at(newSeriesIdx);
-                    const auto& oldDataProxy = oldSeries->dataProxy();
-                    QVector<BenchSubset> newBchZSubs = newBchResults.segmentParam(mPlotParams.zType == PlotArgumentType,
-                                                                                  bchName.idxs, mPlotParams.zIdx);
-                    int newRowsIdx = 0;
-                    for (const auto& bchZSub : std::as_const(newBchZSubs))
-                    {
-                        QVector<BenchSubset> newBchSubsets = newBchResults.groupParam(mPlotParams.xType == PlotArgumentType,
-                                                                                      bchZSub.idxs, mPlotParams.xIdx, "X");
-                        if (newBchSubsets.empty())
-                            break;
-                        const auto& bchSubset = newBchSubsets[0];
-                        
-                        int newColsIdx = 0;
-                        for (int idx : bchSubset.idxs)
-                        {
-                            // Update item
-                            oldDataProxy->setItem(newRowsIdx, newColsIdx,
-                                                  QBarDataItem( static_cast<float>(getYPlotValue(newBchResults.benchmarks[idx], mPlotParams.yType) * mCurrentTimeFactor) ));
-                            ++newColsIdx;
-                        }
-                        ++newRowsIdx;
-                    }
-                    ++newSeriesIdx;
-                }
-            }
-        }
+        setupChart(chartData);
+        setupOptions();
         
-        break;  // once
+        // Show
+        QWidget *container = QWidget::createWindowContainer(mBars);
+        ui->horizontalLayout->insertWidget(0, container, 1);
+        this->setEnabled(true);
+        return;
     }
     
-    if ( !errorMsg.isEmpty() )
+    // Update displayed series in place (axes kept)
+    QString errorMsg;
+    if ( !reconcileChart(chartData, errorMsg) )
     {
         // Reset update if all benchmarks
         if (mAllIndexes)
         {
             saveConfig();
-            setupChart(newBchResults, mBenchIdxs, mPlotParams, false);
+            setupChart(chartData, false);
             setupOptions(false);
         }
         else
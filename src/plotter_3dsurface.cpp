@@ -17,7 +17,8 @@
 #include "ui_plotter_3dsurface.h"
 
 #include "benchmark_results.h"
-#include "result_parser.h"
+#include "result_reloader.h"
+#include "result_snapshots.h"
 
 #include <QFileInfo>
 #include <QDateTime>
@@ -26,6 +27,7 @@
 #include <QJsonObject>
 #include <QJsonDocument>
 #include <QtDataVisualization>
+#include <QtConcurrent>
 
 #include <memory>
 #include <utility>
@@ -33,18 +35,75 @@
 static const char* config_file = "config_3dsurface.json";
 static const bool force_config = false;
 
+// Surface rows with Y-values in displayed time unit
+static QSurfaceDataArray* newSurfaceArray(const QVector<QVector<QVector3D>> &rows, double timeFactor)
+{
+    QSurfaceDataArray* dataArray = new QSurfaceDataArray;
+    dataArray->reserve( rows.size() );
+    for (const auto& row : rows)
+    {
+        QSurfaceDataRow* newRow = new QSurfaceDataRow( row.size() );
+        for (int idx = 0; idx < row.size(); ++idx)
+            (*newRow)[idx].setPosition( QVector3D(row[idx].x(), row[idx].y() * timeFactor, row[idx].z()) );
+        dataArray->append(newRow);
+    }
+    
+    return dataArray;
+}
+
+// Same rows as displayed
+static bool sameSurface(const QSurfaceDataProxy* dataProxy, const QVector<QVector<QVector3D>> &rows, double timeFactor)
+{
+    if (dataProxy->rowCount() != rows.size())
+        return false;
+    
+    for (int row = 0; row < rows.size(); ++row)
+    {
+        const QSurfaceDataRow* oldRow = dataProxy->array()->at(row);
+        if (oldRow->size() != rows[row].size())
+            return false;
+        for (int col = 0; col < rows[row].size(); ++col) {
+            const QVector3D& point = rows[row][col];
+            if (oldRow->at(col).position() != QVector3D(point.x(), point.y() * timeFactor, point.z()))
+                return false;
+        }
+    }
+    return true;
+}
 
-Plotter3DSurface::Plotter3DSurface(const BenchResults &bchResults, const QVector<int> &bchIdxs,
+// Surface series, named if Z-param
+static QSurface3DSeries* newSurfaceSeries(const Surface3DSeriesData &seriesData, bool hasZParam, double timeFactor)
+{
+    QSurfaceDataProxy *dataProxy = new QSurfaceDataProxy();
+    QSurface3DSeries* series = new QSurface3DSeries(dataProxy);
+    dataProxy->resetArray( newSurfaceArray(seriesData.rows, timeFactor) );
+    
+    series->setDrawMode(QSurface3DSeries::DrawSurfaceAndWireframe);
+    series->setFlatShadingEnabled(true);
+    if (!hasZParam) {
+        series->setItemLabelFormat(QStringLiteral("[@xLabel, @zLabel]: @yLabel"));
+    }
+    else {
+        series->setName(seriesData.name);
+        series->setItemLabelFormat(QStringLiteral("@seriesName [@xLabel, @zLabel]: @yLabel"));
+    }
+    
+    return series;
+}
+
+
+Plotter3DSurface::Plotter3DSurface(const BenchSnapshot &bchResults, const QVector<int> &bchIdxs,
                                    const PlotParams &plotParams, const QString &origFilename,
                                    const QVector<FileReload>& addFilenames, QWidget *parent)
     : QWidget(parent)
     , ui(new Ui::Plotter3DSurface)
+    , mBchResults(bchResults)
     , mBenchIdxs(bchIdxs)
     , mPlotParams(plotParams)
     , mOrigFilename(origFilename)
     , mAddFilenames(addFilenames)
-    , mAllIndexes(bchIdxs.size() == bchResults.benchmarks.size())
-    , mWatcher(parent)
+    , mSourceKey(ResultSnapshots::sourceKey(origFilename, addFilenames))
+    , mAllIndexes(bchIdxs.size() == bchResults->benchmarks.size())
 {
     // UI
     ui->setupUi(this);
@@ -55,19 +114,20 @@ Plotter3DSurface::Plotter3DSurface(const BenchResults &bchResults, const QVector
     
     connectUI();
     
-    // Init
-    setupChart(bchResults, bchIdxs, plotParams);
-    setupOptions();
-    
-    // Show
-    QWidget *container = QWidget::createWindowContainer(mSurface);
-    ui->horizontalLayout->insertWidget(0, container, 1);
+    // Init (shown once computed)
+    this->setEnabled(false);
+    computeChart();
 }
 
 Plotter3DSurface::~Plotter3DSurface()
 {
+    // Stop computing
+    if ( !mChartCanceled.isNull() )
+        mChartCanceled->storeRelaxed(1);
+    
     // Save options to file
-    saveConfig();
+    if (mSurface != nullptr)
+        saveConfig();
     
     delete ui;
 }
@@ -120,13 +180,31 @@ void Plotter3DSurface::connectUI()
     connect(ui->spinBoxMTicks,       QOverload<int>::of(&QSpinBox::valueChanged), this, &Plotter3DSurface::onSpinMTicksChanged);
     
     // Actions
-    connect(&mWatcher,              &QFileSystemWatcher::fileChanged, this, &Plotter3DSurface::onAutoReload);
     connect(ui->checkBoxAutoReload, &QCheckBox::stateChanged, this, &Plotter3DSurface::onCheckAutoReload);
     connect(ui->pushButtonReload,   &QPushButton::clicked, this, &Plotter3DSurface::onReloadClicked);
+    connect(ResultSnapshots::instance(), &ResultSnapshots::published, this, &Plotter3DSurface::onResultsPublished);
+    connect(&mChartWatcher, &QFutureWatcher<Surface3DChartData>::finished, this, &Plotter3DSurface::onChartComputed);
     connect(ui->pushButtonSnapshot, &QPushButton::clicked, this, &Plotter3DSurface::onSnapshotClicked);
 }
 
-void Plotter3DSurface::setupChart(const BenchResults &bchResults, const QVector<int> &bchIdxs, const PlotParams &plotParams, bool init)
+void Plotter3DSurface::computeChart()
+{
+    // Supersede running computation
+    if ( !mChartCanceled.isNull() )
+        mChartCanceled->storeRelaxed(1);
+    mChartCanceled = QSharedPointer<QAtomicInt>::create(0);
+    
+    // Worker only uses copies (results immutable)
+    BenchSnapshot bchResults = mBchResults;
+    QVector<int> bchIdxs = mBenchIdxs;
+    PlotParams plotParams = mPlotParams;
+    QSharedPointer<QAtomicInt> canceled = mChartCanceled;
+    mChartWatcher.setFuture( QtConcurrent::run([bchResults, bchIdxs, plotParams, canceled]() {
+        return ChartData::compute3DSurface(*bchResults, bchIdxs, plotParams, canceled.data());
+    }) );
+}
+
+void Plotter3DSurface::setupChart(const Surface3DChartData &chartData, bool init)
 {
     std::unique_ptr<Q3DSurface> scopedSurface;
     Q3DSurface* surface = nullptr;
@@ -147,202 +225,16 @@ void Plotter3DSurface::setupChart(const BenchResults &bchResults, const QVector<
     Q_ASSERT(surface);
     
     // Time unit
-    mCurrentTimeFactor = 1.;
-    if ( isYTimeBased(mPlotParams.yType) ) {
-        if (     bchResults.meta.time_unit == "ns") mCurrentTimeFactor = 1000.;
-        else if (bchResults.meta.time_unit == "ms") mCurrentTimeFactor = 0.001;
-    }
+    mCurrentTimeFactor = ChartData::timeFactor(chartData.timeUnit, mPlotParams.yType);
     
     
-    // 3D
-    // X: argumentA or templateB
-    // Y: time/iter/bytes/items (not name dependent)
-    // Z: argumentC or templateD (with C!=A, D!=B)
-    bool custXAxis = true, custZAxis = true;
-    QString custXName, custZName;
-    bool hasZParam = plotParams.zType != PlotEmptyType;
-    
-    //
-    // No Z-param -> one row per benchmark type
-    if (!hasZParam)
-    {
-        // Single series (i.e. color)
-        QSurfaceDataProxy *dataProxy = new QSurfaceDataProxy();
-        std::unique_ptr<QSurface3DSeries> series(new QSurface3DSeries(dataProxy));
-        std::unique_ptr<QSurfaceDataArray> dataArray(new QSurfaceDataArray);
-        
-        // Segment per X-param
-        QVector<BenchSubset> bchSubsets = bchResults.groupParam(plotParams.xType == PlotArgumentType,
-                                                                bchIdxs, plotParams.xIdx, "X");
-        // Check subsets symmetry/min size
-        bool symBchOK = true, symOK = true, minOK = true;
-        QString culpritName;
-        int refSize = bchSubsets.empty() ? 0 : bchSubsets[0].idxs.size();
-        for (int i = 0; symOK && minOK && i < bchSubsets.size(); ++i) {
-            symOK = bchSubsets[i].idxs.size() == refSize;
-            minOK = bchSubsets[i].idxs.size() >= 2;
-            if (!symOK || !minOK)
-                culpritName = bchSubsets[i].name;
-        }
-        // Ignore asymmetrical series
-        if (!symOK) {
-            qWarning() << "Inconsistent number of X-values between benchmarks to trace surface for: " << culpritName;
-        }
-        // Ignore single-row series
-        else if (!minOK) {
-            qWarning() << "Not enough X-values to trace surface for: " << culpritName;
-        }
-        else
-        {
-            int prevRowSize = 0;
-            double zFallback = 0.;
-            for (const auto& bchSubset : std::as_const(bchSubsets))
-            {
-                // Check inter benchmark consistency
-                if (prevRowSize > 0 && prevRowSize != bchSubset.idxs.size()) {
-                    symBchOK = false;
-                    qWarning() << "Inconsistent number of X-values between benchmarks to trace surface";
-                    break;
-                }
-                prevRowSize = bchSubset.idxs.size();
-                
-                // One row per X-group
-                std::unique_ptr<QSurfaceDataRow> newRow(new QSurfaceDataRow( bchSubset.idxs.size() ));
-                
-//                const QString & subsetName = bchSubset.name;
-//                qDebug() << "subsetName:" << subsetName;
-//                qDebug() << "subsetIdxs:" << bchSubset.idxs;
-                
-                int index = 0;
-                double xFallback = 0.;
-                for (int idx : bchSubset.idxs)
-                {
-                    QString xName = bchResults.getParamName(plotParams.xType == PlotArgumentType,
-                                                            idx, plotParams.xIdx);
-                    double xVal = BenchResults::getParamValue(xName, custXName, custXAxis, xFallback);
-                    
-                    // Y val
-                    double yVal = getYPlotValue(bchResults.benchmarks[idx], plotParams.yType) * mCurrentTimeFactor;
-//                    qDebug() << "-> [" << xVal << yVal << zFallback << "]";
-                    
-                    // Add column
-                    (*newRow)[index++].setPosition( QVector3D(xVal, yVal, zFallback) );
-                }
-                // Add row
-                dataArray->append(newRow.release());
-                
-                ++zFallback;
-            }
-        }
-        if (symBchOK && dataArray->size() > 0)
-        {
-            // Add series
-            dataProxy->resetArray(dataArray.release());
-            
-            series->setDrawMode(QSurface3DSeries::DrawSurfaceAndWireframe);
-            series->setFlatShadingEnabled(true);
-            series->setItemLabelFormat(QStringLiteral("[@xLabel, @zLabel]: @yLabel"));
-            mSeriesMapping.push_back({"", ""}); // color set later
-            
-            surface->addSeries(series.release());
-        }
-    }
-    //
-    // Z-param -> one series per benchmark type
-    else
+    // 3D (computed rows)
+    bool hasZParam = mPlotParams.zType != PlotEmptyType;
+    for (const auto& seriesData : chartData.series)
     {
-        // Initial segmentation by 'full name % param1 % param2' (group benchmarks)
-        const auto bchNames = bchResults.segment2DNames(bchIdxs,
-                                                        plotParams.xType == PlotArgumentType, plotParams.xIdx,
-                                                        plotParams.zType == PlotArgumentType, plotParams.zIdx);
-        for (const auto& bchName : bchNames)
-        {
-            // One series (i.e. color) per 2D-name
-            QSurfaceDataProxy *dataProxy = new QSurfaceDataProxy();
-            std::unique_ptr<QSurface3DSeries> series(new QSurface3DSeries(dataProxy));
-            
-//            qDebug() << "bchName" << bchName.name << "|" << bchName.idxs;
-            
-            // One subset per Z-param from 2D-names
-            QVector<BenchSubset> bchZSubs = bchResults.segmentParam(plotParams.zType == PlotArgumentType,
-                                                                    bchName.idxs, plotParams.zIdx);
-            // Ignore incompatible series
-            if ( bchZSubs.isEmpty() ) {
-                qWarning() << "No Z-value to trace surface for other benchmarks";
-                continue;
-            }
-            
-            // Check subsets symmetry/min size
-            bool symOK = true, minOK = true;
-            QString culpritName;
-            int refSize = bchZSubs[0].idxs.size();
-            for (int i=0; symOK && minOK && i<bchZSubs.size(); ++i) {
-                symOK = bchZSubs[i].idxs.size() == refSize;
-                minOK = bchZSubs[i].idxs.size() >= 2;
-                if (!symOK || !minOK)
-                    culpritName = bchZSubs[0].name;
-            }
-            // Ignore asymmetrical series
-            if (!symOK) {
-                qWarning() << "Inconsistent number of X-values between benchmarks to trace surface for: "
-                           << bchName.name + " [Z=" + culpritName + "]";
-                continue;
-            }
-            // Ignore single-row series
-            else if (!minOK) {
-                qWarning() << "Not enough X-values to trace surface for: "
-                           << bchName.name + " [Z=" + culpritName + "]";
-                continue;
-            }
-
-            std::unique_ptr<QSurfaceDataArray> dataArray(new QSurfaceDataArray);
-            double zFallback = 0.;
-            for (const auto& bchZSub : std::as_const(bchZSubs))
-            {
-                QString zName = bchZSub.name;
-//                qDebug() << "bchZSub" << bchZSub.name << "|" << bchZSub.idxs;
-
-                double zVal = BenchResults::getParamValue(zName, custZName, custZAxis, zFallback);
-                
-                // One row per Z-param from 2D-names
-                std::unique_ptr<QSurfaceDataRow> newRow(new QSurfaceDataRow( bchZSub.idxs.size() ));
-                
-                // One subset per X-param from Z-Subset
-                QVector<BenchSubset> bchSubsets = bchResults.groupParam(plotParams.xType == PlotArgumentType,
-                                                                        bchZSub.idxs, plotParams.xIdx, "X");
-                Q_ASSERT(bchSubsets.size() <= 1);
-                for (const auto& bchSubset : std::as_const(bchSubsets))
-                {
-                    int index = 0;
-                    double xFallback = 0.;
-                    for (int idx : bchSubset.idxs)
-                    {
-                        QString xName = bchResults.getParamName(plotParams.xType == PlotArgumentType,
-                                                                idx, plotParams.xIdx);
-                        double xVal = BenchResults::getParamValue(xName, custXName, custXAxis, xFallback);
-                        
-                        // Y val
-                        double yVal = getYPlotValue(bchResults.benchmarks[idx], plotParams.yType) * mCurrentTimeFactor;
-//                        qDebug() << "-> [" << xVal << yVal << zVal << "]";
-                        
-                        // Add column
-                        (*newRow)[index++].setPosition( QVector3D(xVal, yVal, zVal) );
-                    }
-                    // Add row
-                    dataArray->append(newRow.release());
-                }
-            }
-            // Add series
-            dataProxy->resetArray(dataArray.release());
-            
-            series->setDrawMode(QSurface3DSeries::DrawSurfaceAndWireframe);
-            series->setFlatShadingEnabled(true);
-            series->setName(bchName.name);
-            mSeriesMapping.push_back({bchName.name, bchName.name}); // color set later
-            series->setItemLabelFormat(QStringLiteral("@seriesName [@xLabel, @zLabel]: @yLabel"));
-            
-            surface->addSeries(series.release());
-        }
+        // One series (i.e. color) per benchmark, or single one if no Z-param
+        surface->addSeries( newSurfaceSeries(seriesData, hasZParam, mCurrentTimeFactor) );
+        mSeriesMapping.push_back({seriesData.name, seriesData.name}); // color set later
     }
     
     // Axes
@@ -354,34 +246,20 @@ void Plotter3DSurface::setupChart(const BenchResults &bchResults, const QVector<
         
         // X-axis
         QValue3DAxis *xAxis = surface->axisX();
-        if (plotParams.xType == PlotArgumentType)
-            xAxis->setTitle("Argument " + QString::number(plotParams.xIdx+1));
-        else { // template
-            if ( !custXName.isEmpty() )
-                xAxis->setTitle(custXName);
-            else
-                xAxis->setTitle("Template " + QString::number(plotParams.xIdx+1));
-        }
+        xAxis->setTitle(chartData.xTitle);
         xAxis->setTitleVisible(true);
         xAxis->setSegmentCount(8);
         
         // Y-axis
         QValue3DAxis *yAxis = surface->axisY();
-        yAxis->setTitle( getYPlotName(plotParams.yType, bchResults.meta.time_unit) );
+        yAxis->setTitle(chartData.yTitle);
         yAxis->setTitleVisible(true);
         
         // Z-axis
         QValue3DAxis *zAxis = surface->axisZ();
-        if (plotParams.zType != PlotEmptyType)
+        if ( !chartData.zTitle.isEmpty() )
         {
-            if (plotParams.zType == PlotArgumentType)
-                zAxis->setTitle("Argument " + QString::number(plotParams.zIdx+1));
-            else { // template
-                if ( !custZName.isEmpty() )
-                    zAxis->setTitle(custZName);
-                else
-                    zAxis->setTitle("Template " + QString::number(plotParams.zIdx+1));
-            }
+            zAxis->setTitle(chartData.zTitle);
             zAxis->setTitleVisible(true);
         }
         zAxis->setSegmentCount(8);
@@ -391,8 +269,6 @@ void Plotter3DSurface::setupChart(const BenchResults &bchResults, const QVector<
         QValue3DAxis *yAxis = surface->axisY();
         yAxis->setTitle("No compatible series to display");
         yAxis->setTitleVisible(true);
-
-        qWarning() << "No compatible series to display";
     }
     
     if (init)
@@ -402,6 +278,65 @@ void Plotter3DSurface::setupChart(const BenchResults &bchResults, const QVector<
     }
 }
 
+bool Plotter3DSurface::reconcileChart(const Surface3DChartData &chartData, QString &errorMsg)
+{
+    // Existing series required (i.e. axes set)
+    const auto oldSurfaceSeries = mSurface->seriesList();
+    if (oldSurfaceSeries.isEmpty() || chartData.series.isEmpty()) {
+        errorMsg = "No compatible series to display";
+        return false;
+    }
+    
+    // Subset of benchmarks: same series required (in order)
+    if ( !mAllIndexes && !sameSeriesNames(mSeriesMapping, chartData.series, errorMsg) )
+        return false;
+    
+    // Match series by name
+    QHash<QString, const Surface3DSeriesData*> newSeries;
+    for (const auto& seriesData : chartData.series)
+        newSeries.insert(seriesData.name, &seriesData);
+    
+    // Update kept series (changed rows only), remove others
+    SeriesMapping newMapping;
+    for (int idx = 0; idx < oldSurfaceSeries.size(); ++idx)
+    {
+        QSurface3DSeries* series = oldSurfaceSeries[idx];
+        const Surface3DSeriesData* seriesData = newSeries.take(mSeriesMapping[idx].oldName);
+        if (seriesData == nullptr) {
+            mSurface->removeSeries(series);
+            delete series;
+            continue;
+        }
+        if ( !sameSurface(series->dataProxy(), seriesData->rows, mCurrentTimeFactor) )
+            series->dataProxy()->resetArray( newSurfaceArray(seriesData->rows, mCurrentTimeFactor) );
+        newMapping.push_back(mSeriesMapping[idx]);
+    }
+    
+    // Add new series
+    int keptCount = newMapping.size();
+    bool hasZParam = mPlotParams.zType != PlotEmptyType;
+    for (const auto& seriesData : chartData.series)
+    {
+        if ( !newSeries.contains(seriesData.name) )
+            continue;
+        
+        QSurface3DSeries* series = newSurfaceSeries(seriesData, hasZParam, mCurrentTimeFactor);
+        mSurface->addSeries(series);
+        
+        newMapping.push_back({seriesData.name, seriesData.name});
+    }
+    mSeriesMapping = newMapping;
+    
+    // New series: saved config if any, as when set up
+    if (keptCount < mSeriesMapping.size()) {
+        loadSeriesConfig(QString(config_folder) + config_file, mSeriesMapping, keptCount);
+        applySeriesConfig(keptCount);
+        onComboGradientChanged( ui->comboBoxGradient->currentIndex() );
+    }
+    
+    return true;
+}
+
 void Plotter3DSurface::setupOptions(bool init)
 {
     // General
@@ -496,8 +431,23 @@ void Plotter3DSurface::setupOptions(bool init)
         onCheckAutoReload(Qt::Checked);
     
     // Update series color config
+    applySeriesConfig();
+    
+    // Restore selected axis
+    if (!init)
+        ui->comboBoxAxis->setCurrentIndex(prevAxisIdx);
+    
+    // Update timestamp
+    QDateTime today = QDateTime::currentDateTime();
+    QTime now = today.time();
+    ui->labelLastReload->setText("(Last: " + now.toString()+ ")");
+}
+
+// Saved or edited colors and names applied to series (theme colors kept otherwise)
+void Plotter3DSurface::applySeriesConfig(int from)
+{
     const auto& chartSeries = mSurface->seriesList();
-    for (int idx = 0 ; idx < mSeriesMapping.size(); ++idx)
+    for (int idx = from; idx < mSeriesMapping.size(); ++idx)
     {
         auto& config = mSeriesMapping[idx];
         const auto& series = chartSeries.at(idx);
@@ -511,15 +461,6 @@ void Plotter3DSurface::setupOptions(bool init)
         if (config.newName != config.oldName)
             series->setName( config.newName );
     }
-    
-    // Restore selected axis
-    if (!init)
-        ui->comboBoxAxis->setCurrentIndex(prevAxisIdx);
-    
-    // Update timestamp
-    QDateTime today = QDateTime::currentDateTime();
-    QTime now = today.time();
-    ui->labelLastReload->setText("(Last: " + now.toString()+ ")");
 }
 
 void Plotter3DSurface::loadConfig(bool init)
@@ -543,25 +484,7 @@ void Plotter3DSurface::loadConfig(bool init)
             ui->comboBoxGradient->setCurrentText( json["surface.gradient"].toString() );
         
         // Series
-        if (json.contains("series") && json["series"].isArray())
-        {
-            auto series = json["series"].toArray();
-            for (int idx = 0; idx < series.size(); ++idx) {
-                QJsonObject config = series[idx].toObject();
-                if ( config.contains("oldName")  && config["oldName"].isString()
-                  && config.contains("newName")  && config["newName"].isString()
-                  && config.contains("newColor") && config["newColor"].isString()
-                  && QColor::isValidColorName(config["newColor"].toString()) )
-                {
-                    SeriesConfig savedConfig(config["oldName"].toString(), "");
-                    int iCfg = mSeriesMapping.indexOf(savedConfig);
-                    if (iCfg >= 0) {
-                        mSeriesMapping[iCfg].newName = config["newName"].toString();
-                        mSeriesMapping[iCfg].newColor.fromString( config["newColor"].toString() );
-                    }
-                }
-            }
-        }
+        loadSeriesConfig(json, mSeriesMapping);
         
         // Time
         if (!init) {
@@ -1140,314 +1063,69 @@ void Plotter3DSurface::onSpinMTicksChanged(int i)
 // Actions
 void Plotter3DSurface::onCheckAutoReload(int state)
 {
+    // Watched once for all windows of same files
     if (state == Qt::Checked)
-    {
-        if (mWatcher.files().empty())
-        {
-            mWatcher.addPath(mOrigFilename);
-            for (const auto& addFilename : mAddFilenames)
-                mWatcher.addPath( addFilename.filename );
-        }
-    }
+        ResultReloader::instance()->watch(this, mOrigFilename, mAddFilenames);
     else
-    {
-        if (!mWatcher.files().empty())
-            mWatcher.removePaths( mWatcher.files() );
-    }
+        ResultReloader::instance()->unwatch(this);
 }
 
-void Plotter3DSurface::onAutoReload(const QString &path)
+void Plotter3DSurface::onReloadClicked()
 {
-    QFileInfo fi(path);
-    if (fi.exists() && fi.isReadable() && fi.size() > 0)
-        onReloadClicked();
-    else
-        qWarning() << "Unable to auto-reload file: " << path;
+    // Parsed once for all windows of same files (updated on publication)
+    ResultReloader::instance()->reload(mOrigFilename, mAddFilenames, this);
 }
 
-void Plotter3DSurface::onReloadClicked()
+void Plotter3DSurface::onResultsPublished(const QString &sourceKey, const BenchSnapshot &bchResults)
 {
-    // Load new results
-    QString errorMsg;
-    BenchResults newBchResults = ResultParser::parseJsonFile( mOrigFilename, errorMsg );
-    
-    if ( newBchResults.benchmarks.isEmpty() ) {
-        QMessageBox::critical(this, "Chart reload", "Error parsing original file: " + mOrigFilename + " -> " + errorMsg);
+    // Newer results of same files only
+    if (sourceKey != mSourceKey || bchResults->version <= mBchResults->version)
         return;
-    }
     
-    for (const auto& addFile : std::as_const(mAddFilenames))
+    // Check compatibility with previous (current results kept if rejected)
+    if (mBenchIdxs.size() != bchResults->benchmarks.size())
     {
-        errorMsg.clear();
-        BenchResults newAddResults = ResultParser::parseJsonFile(addFile.filename, errorMsg);
-        if ( newAddResults.benchmarks.isEmpty() ) {
-            QMessageBox::critical(this, "Chart reload", "Error parsing additional file: " + addFile.filename + " -> " + errorMsg);
+        if (!mAllIndexes) {
+            QMessageBox::critical(this, "Chart reload", "Number of series/points is different");
             return;
         }
-        
-        if (addFile.isAppend)
-            newBchResults.appendResults(newAddResults);
-        else
-            newBchResults.overwriteResults(newAddResults);
+        mBenchIdxs = bchResults->segmentAll();
     }
+    mBchResults = bchResults;
     
-    // Check compatibility with previous
-    errorMsg.clear();
-    if (mBenchIdxs.size() != newBchResults.benchmarks.size())
-    {
-        errorMsg = "Number of series/points is different";
-        if (mAllIndexes)
-        {
-            mBenchIdxs.clear();
-            for (int i=0; i<newBchResults.benchmarks.size(); ++i)
-                mBenchIdxs.append(i);
-        }
-    }
+    // Updated once computed
+    computeChart();
+}
+
+void Plotter3DSurface::onChartComputed()
+{
+    // Superseded meanwhile
+    if (mChartCanceled->loadRelaxed() != 0)
+        return;
+    const Surface3DChartData chartData = mChartWatcher.result();
     
-    while ( errorMsg.isEmpty() )  // once
+    // First chart
+    if (mSurface == nullptr)
     {
-        // Check chart type
-        bool hasZParam = mPlotParams.zType != PlotEmptyType;
-        if (!hasZParam)
-        {
-            // Check compatibility with previous
-            const auto& oldSurfaceSeries = mSurface->seriesList();
-            if (oldSurfaceSeries.size() != 1) {
-                errorMsg = "No single series originally";
-                break;
-            }
-            const auto& oldSeries = oldSurfaceSeries[0];
-            const auto& oldDataProxy = oldSeries->dataProxy();
-            const auto& oldDataArray = oldDataProxy->array();
-            
-            QVector<BenchSubset> newBchSubsets = newBchResults.groupParam(mPlotParams.xType == PlotArgumentType,
-                                                                          mBenchIdxs, mPlotParams.xIdx, "X");
-            // Check subsets symmetry/min size
-            bool symOK = true, minOK = true;
-            QString culpritName;
-            Q_ASSERT(!newBchSubsets.empty());
-            int refSize = newBchSubsets.empty() ? 0 : newBchSubsets[0].idxs.size();
-            for (int i = 0; symOK && minOK && i < newBchSubsets.size(); ++i) {
-                symOK = newBchSubsets[i].idxs.size() == refSize;
-                minOK = newBchSubsets[i].idxs.size() >= 2;
-                if (!symOK || !minOK)
-                    culpritName = newBchSubsets[i].name;
-            }
-            if (!symOK) {
-                errorMsg = "Inconsistent number of X-values between benchmarks to trace surface for: " + culpritName;
-                break;
-            }
-            else if (!minOK) {
-                errorMsg = "Not enough X-values to trace surface for: " + culpritName;
-                break;
-            }
-            // Check rows
-            if (newBchSubsets.size() != oldDataProxy->rowCount()) {
-                errorMsg = "Number of single series rows is different";
-                break;
-            }
-            
-            int prevRowSize = 0;
-            int newRowsIdx  = 0;
-            for (const auto& bchSubset : std::as_const(newBchSubsets))
-            {
-                // Check inter benchmark consistency
-                if (prevRowSize > 0 && prevRowSize != bchSubset.idxs.size()) {
-                    errorMsg = "Inconsistent number of X-values between benchmarks to trace surface";
-                    break;
-                }
-                prevRowSize = bchSubset.idxs.size();
-                
-                const auto& oldRow  = oldDataArray->at(newRowsIdx);
-                if (bchSubset.idxs.size() != oldRow->size())
-                {
-                    errorMsg = "Number of series columns is different";
-                    break;
-                }
-                ++newRowsIdx;
-            }
-            
-            // Direct update if compatible
-            if ( errorMsg.isEmpty() )
-            {
-                bool custXAxis = true;
-                QString custXName;
-                double zFallback = 0.;
-                
-                newRowsIdx  = 0;
-                for (const auto& bchSubset : std::as_const(newBchSubsets))
-                {
-                    double xFallback = 0.;
-                    int newColsIdx = 0;
-                    for (int idx : bchSubset.idxs)
-                    {
-                        // Update item
-                        QString xName = newBchResults.getParamName(mPlotParams.xType == PlotArgumentType,
-                                                                   idx, mPlotParams.xIdx);
-                        double xVal = BenchResults::getParamValue(xName, custXName, custXAxis, xFallback);
-                        double yVal = getYPlotValue(newBchResults.benchmarks[idx], mPlotParams.yType) * mCurrentTimeFactor;
-                        
-                        oldDataProxy->setItem(newRowsIdx, newColsIdx,
-                                              QSurfaceDataItem( QVector3D(xVal, yVal, zFallback) ));
-                        ++newColsIdx;
-                    }
-                    ++zFallback;
-                    ++newRowsIdx;
-                }
-            }
-        }
-        else
-        {
-            // Check compatibility with previous
-            const auto& oldSurfaceSeries = mSurface->seriesList();
-            if (oldSurfaceSeries.empty()) {
-                errorMsg = "No series originally";
-                break;
-            }
-            const auto newBchNames = newBchResults.segment2DNames(mBenchIdxs,
-                                                                  mPlotParams.xType == PlotArgumentType, mPlotParams.xIdx,
-                                                                  mPlotParams.zType == PlotArgumentType, mPlotParams.zIdx);
-            if (newBchNames.size() < oldSurfaceSeries.size()) {
-                errorMsg = "Number of series is different";
-                break;
-            }
-            
-            int newSeriesIdx = 0;
-            for (const auto& bchName : newBchNames)
-            {
-                QVector<BenchSubset> newBchZSubs = newBchResults.segmentParam(mPlotParams.zType == PlotArgumentType,
-                                                                              bchName.idxs, mPlotParams.zIdx);
-                // Ignore incompatible series
-                if ( newBchZSubs.isEmpty() ) {
-                    qWarning() << "No Z-value to trace surface for other benchmarks";
-                    continue;
-                }
-                
-                // Check subsets symmetry/min size
-                bool symOK = true, minOK = true;
-                QString culpritName;
-                int refSize = newBchZSubs[0].idxs.size();
-                for (int i=0; symOK && minOK && i<newBchZSubs.size(); ++i) {
-                    symOK = newBchZSubs[i].idxs.size() == refSize;
-                    minOK = newBchZSubs[i].idxs.size() >= 2;
-                    if (!symOK || !minOK)
-                        culpritName = newBchZSubs[i].name;
-                }
-                if (!symOK) {
-                    qWarning() << "Inconsistent number of X-values between benchmarks to trace surface for:"
-                               << bchName.name + "[Z=" + culpritName + "]";
-                    continue;
-                }
-                else if (!minOK) {
-                    qWarning() << "Not enough X-values to trace surface for:"
-                               << bchName.name + "[Z=" + culpritName + "]";
-                    continue;
-                }
-                
-                const auto& oldSeries = oldSurfaceSeries.at(newSeriesIdx);
-                const auto& oldDataProxy = oldSeries->dataProxy();
-                const auto& oldDataArray = oldDataProxy->array();
-                if (bchName.name != mSeriesMapping[newSeriesIdx].oldName)
-                {
-                    errorMsg = "Series has different name";
-                    break;
-                }
-                if (newBchZSubs.size() != oldDataProxy->rowCount()) {
-                    errorMsg = "Number of single series rows is different";
-                    break;
-                }
-                
-                int newRowsIdx  = 0;
-                for (const auto& bchZSub : std::as_const(newBchZSubs))
-                {
-                    const auto& oldRow  = oldDataArray->at(newRowsIdx);
-                    QVector<BenchSubset> newBchSubsets = newBchResults.groupParam(mPlotParams.xType == PlotArgumentType,
-                                                                                  bchZSub.idxs, mPlotParams.xIdx, "X");
-                    Q_ASSERT(newBchSubsets.size() <= 1);
-                    if (newBchSubsets.empty() || newBchSubsets[0].idxs.size() != oldRow->size())
-                    {
-                        errorMsg = "Number of series columns is different";
-                        break;
-                    }
-                    ++newRowsIdx;
-                }
-                ++newSeriesIdx;
-            }
-            
-            // Direct update if compatible
-            if ( errorMsg.isEmpty() )
-            {
-                bool custXAxis = true, custZAxis = true;
-                QString custXName, custZName;
-                
-                newSeriesIdx = 0;
-                for (const auto& bchName : newBchNames)
-                {
-                    QVector<BenchSubset> newBchZSubs = newBchResults.segmentParam(mPlotParams.zType == PlotArgumentType,
-                                                                                  bchName.idxs, mPlotParams.zIdx);
-                    // Ignore incompatible series
-                    if ( newBchZSubs.isEmpty() )
-                        continue;
-                    
-                    // Check subsets symmetry/min size
-                    bool symOK = true, minOK = true;
-                    QString culpritName;
-                    int refSize = newBchZSubs[0].idxs.size();
-                    for (int i=0; symOK && minOK && i<newBchZSubs.size(); ++i) {
-                        symOK = newBchZSubs[i].idxs.size() == refSize;
-                        minOK = newBchZSubs[i].idxs.size() >= 2;
-                        if (!symOK || !minOK)
-                            culpritName = newBchZSubs[i].name;
-                    }
-                    if (!symOK || !minOK)
-                        continue;
-                    
-                    const auto& oldSeries = oldSurfaceSeries.at(newSeriesIdx);
-                    const auto& oldDataProxy = oldSeries->dataProxy();
-                    
-                    double zFallback = 0.;
-                    int newRowsIdx  = 0;
-                    for (const auto& bchZSub : std::as_const(newBchZSubs))
-                    {
-                        const QString zName = bchZSub.name;
-                        double zVal = BenchResults::getParamValue(zName, custZName, custZAxis, zFallback);
-                        
-                        QVector<BenchSubset> newBchSubsets = newBchResults.groupParam(mPlotParams.xType == PlotArgumentType,
-                                                                                      bchZSub.idxs, mPlotParams.xIdx, "X");
-                        Q_ASSERT(newBchSubsets.size() == 1);
-                        const auto& bchSubset = newBchSubsets[0];
-                        
-                        double xFallback = 0.;
-                        int newColsIdx = 0;
-                        for (int idx : bchSubset.idxs)
-                        {
-                            // Update item
-                            QString xName = newBchResults.getParamName(mPlotParams.xType == PlotArgumentType,
-                                                                       idx, mPlotParams.xIdx);
-                            double xVal = BenchResults::getParamValue(xName, custXName, custXAxis, xFallback);
-                            double yVal = getYPlotValue(newBchResults.benchmarks[idx], mPlotParams.yType) * mCurrentTimeFactor;
-                            
-                            oldDataProxy->setItem(newRowsIdx, newColsIdx,
-                                                  QSurfaceDataItem( QVector3D(xVal, yVal, zVal) ));
-                            ++newColsIdx;
-                        }
-                        ++newRowsIdx;
-                    }
-                    ++newSeriesIdx;
-                }
-            }
-        }
+        setupChart(chartData);
+        setupOptions();
         
-        break;  // once
+        // Show
+        QWidget *container = QWidget::createWindowContainer(mSurface);
+        ui->horizontalLayout->insertWidget(0, container, 1);
+        this->setEnabled(true);
+        return;
     }
     
-    if ( !errorMsg.isEmpty() )
+    // Update displayed series in place (axes kept)
+    QString errorMsg;
+    if ( !reconcileChart(chartData, errorMsg) )
     {
         // Reset update if all benchmarks
         if (mAllIndexes)
         {
             saveConfig();
-            setupChart(newBchResults, mBenchIdxs, mPlotParams, false);
+            setupChart(chartData, false);
             setupOptions(false);
         }
         else
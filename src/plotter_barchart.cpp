@@ -17,7 +17,8 @@
 #include "ui_plotter_barchart.h"
 
 #include "benchmark_results.h"
-#include "result_parser.h"
+#include "result_reloader.h"
+#include "result_snapshots.h"
 
 #include <QFileInfo>
 #include <QDateTime>
@@ -26,6 +27,7 @@
 #include <QJsonObject>
 #include <QJsonDocument>
 #include <QtCharts>
+#include <QtConcurrent>
 
 #include <memory>
 #include <utility>
@@ -33,18 +35,40 @@
 static const char* config_file = "config_bars.json";
 static const bool force_config = false;
 
+// Bar values in displayed time unit
+static QList<qreal> scaledValues(const QVector<double> &values, double timeFactor)
+{
+    QList<qreal> scaled;
+    scaled.reserve( values.size() );
+    for (double value : values)
+        scaled.append(value * timeFactor);
+    
+    return scaled;
+}
 
-PlotterBarChart::PlotterBarChart(const BenchResults &bchResults, const QVector<int> &bchIdxs,
+// Escaped category labels
+static QStringList escapedCategories(const QStringList &categories)
+{
+    QStringList escaped;
+    for (const auto& category : categories)
+        escaped.append( category.toHtmlEscaped() );
+    
+    return escaped;
+}
+
+
+PlotterBarChart::PlotterBarChart(const BenchSnapshot &bchResults, const QVector<int> &bchIdxs,
                                  const PlotParams &plotParams, const QString &origFilename,
                                  const QVector<FileReload>& addFilenames, QWidget *parent)
     : QWidget(parent)
     , ui(new Ui::PlotterBarChart)
+    , mBchResults(bchResults)
     , mBenchIdxs(bchIdxs)
     , mPlotParams(plotParams)
     , mOrigFilename(origFilename)
     , mAddFilenames(addFilenames)
-    , mAllIndexes(bchIdxs.size() == bchResults.benchmarks.size())
-    , mWatcher(parent)
+    , mSourceKey(ResultSnapshots::sourceKey(origFilename, addFilenames))
+    , mAllIndexes(bchIdxs.size() == bchResults->benchmarks.size())
     , mIsVert(plotParams.type == ChartBarType)
 {
     // UI
@@ -57,18 +81,20 @@ PlotterBarChart::PlotterBarChart(const BenchResults &bchResults, const QVector<i
     
     connectUI();
     
-    // Init
-    setupChart(bchResults, bchIdxs, plotParams);
-    setupOptions();
-    
-    // Show
-    ui->horizontalLayout->insertWidget(0, mChartView);
+    // Init (shown once computed)
+    this->setEnabled(false);
+    computeChart();
 }
 
 PlotterBarChart::~PlotterBarChart()
 {
+    // Stop computing
+    if ( !mChartCanceled.isNull() )
+        mChartCanceled->storeRelaxed(1);
+    
     // Save options to file
-    saveConfig();
+    if (mChartView != nullptr)
+        saveConfig();
     
     delete ui;
 }
@@ -141,13 +167,31 @@ void PlotterBarChart::connectUI()
     connect(ui->spinBoxMTicks,       QOverload<int>::of(&QSpinBox::valueChanged), this, &PlotterBarChart::onSpinMTicksChanged);
     
     // Actions
-    connect(&mWatcher,              &QFileSystemWatcher::fileChanged, this, &PlotterBarChart::onAutoReload);
     connect(ui->checkBoxAutoReload, &QCheckBox::stateChanged, this, &PlotterBarChart::onCheckAutoReload);
     connect(ui->pushButtonReload,   &QPushButton::clicked, this, &PlotterBarChart::onReloadClicked);
+    connect(ResultSnapshots::instance(), &ResultSnapshots::published, this, &PlotterBarChart::onResultsPublished);
+    connect(&mChartWatcher, &QFutureWatcher<BarChartData>::finished, this, &PlotterBarChart::onChartComputed);
     connect(ui->pushButtonSnapshot, &QPushButton::clicked, this, &PlotterBarChart::onSnapshotClicked);
 }
 
-void PlotterBarChart::setupChart(const BenchResults &bchResults, const QVector<int> &bchIdxs, const PlotParams &plotParams, bool init)
+void PlotterBarChart::computeChart()
+{
+    // Supersede running computation
+    if ( !mChartCanceled.isNull() )
+        mChartCanceled->storeRelaxed(1);
+    mChartCanceled = QSharedPointer<QAtomicInt>::create(0);
+    
+    // Worker only uses copies (results immutable)
+    BenchSnapshot bchResults = mBchResults;
+    QVector<int> bchIdxs = mBenchIdxs;
+    PlotParams plotParams = mPlotParams;
+    QSharedPointer<QAtomicInt> canceled = mChartCanceled;
+    mChartWatcher.setFuture( QtConcurrent::run([bchResults, bchIdxs, plotParams, canceled]() {
+        return ChartData::computeBars(*bchResults, bchIdxs, plotParams, canceled.data());
+    }) );
+}
+
+void PlotterBarChart::setupChart(const BarChartData &chartData, bool init)
 {
     std::unique_ptr<QChart> scopedChart;
     QChart* chart = nullptr;
@@ -170,11 +214,7 @@ void PlotterBarChart::setupChart(const BenchResults &bchResults, const QVector<i
     Q_ASSERT(chart);
     
     // Time unit
-    mCurrentTimeFactor = 1.;
-    if ( isYTimeBased(mPlotParams.yType) ) {
-        if (     bchResults.meta.time_unit == "ns") mCurrentTimeFactor = 1000.;
-        else if (bchResults.meta.time_unit == "ms") mCurrentTimeFactor = 0.001;
-    }
+    mCurrentTimeFactor = ChartData::timeFactor(chartData.timeUnit, mPlotParams.yType);
     
     // Single series, one barset per benchmark type
     std::unique_ptr<QAbstractBarSeries> scopedSeries;
@@ -183,59 +223,16 @@ void PlotterBarChart::setupChart(const BenchResults &bchResults, const QVector<i
     QAbstractBarSeries* series = scopedSeries.get();
     
     
-    // 2D Bars
-    // X: argumentA or templateB
-    // Y: time/iter/bytes/items (not name dependent)
-    // Bar: one per benchmark % X-param
-    QVector<BenchSubset> bchSubsets = bchResults.groupParam(plotParams.xType == PlotArgumentType,
-                                                            bchIdxs, plotParams.xIdx, "X");
-    // Ignore empty series
-    if ( bchSubsets.isEmpty() ) {
-        qWarning() << "No compatible series to display";
-    }
-    
-    bool firstCol = true;
-    QStringList prevColLabels;
-    for (const auto& bchSubset : std::as_const(bchSubsets))
+    // 2D Bars (computed values)
+    for (const auto& setData : chartData.sets)
     {
-        // Ignore empty set
-        if ( bchSubset.idxs.isEmpty() ) {
-            qWarning() << "No X-value to trace bar for:" << bchSubset.name;
-            continue;
-        }
-        
-        const QString& subsetName = bchSubset.name;
-//        qDebug() << "subsetName:" << subsetName;
-//        qDebug() << "subsetIdxs:" << bchSubset.idxs;
-        
         // X-row
-        std::unique_ptr<QBarSet> barSet(new QBarSet( subsetName.toHtmlEscaped() ));
-        mSeriesMapping.push_back({subsetName, subsetName}); // color set later
+        std::unique_ptr<QBarSet> barSet(new QBarSet( setData.name.toHtmlEscaped() ));
+        mSeriesMapping.push_back({setData.name, setData.name}); // color set later
+        barSet->append( scaledValues(setData.values, mCurrentTimeFactor) );
         
-        QStringList colLabels;
-        for (int idx : bchSubset.idxs)
-        {
-            QString xName = bchResults.getParamName(plotParams.xType == PlotArgumentType,
-                                                    idx, plotParams.xIdx);
-            colLabels.append( xName.toHtmlEscaped() );
-            
-            // Add column
-            barSet->append(getYPlotValue(bchResults.benchmarks[idx], plotParams.yType) * mCurrentTimeFactor);
-        }
         // Add set (i.e. color)
         series->append(barSet.release());
-        
-        // Set column labels (only if no collision, empty otherwise)
-        if (firstCol) // init
-            prevColLabels = colLabels;
-        else if ( commonPartEqual(prevColLabels, colLabels) ) {
-            if (prevColLabels.size() < colLabels.size()) // replace by longest
-                prevColLabels = colLabels;
-        }
-        else { // collision
-            prevColLabels = QStringList("");
-        }
-        firstCol = false;
     }
     // Add the series
     chart->addSeries(scopedSeries.release());
@@ -249,20 +246,18 @@ void PlotterBarChart::setupChart(const BenchResults &bchResults, const QVector<i
         
         // X-axis
         QBarCategoryAxis* catAxis = new QBarCategoryAxis();
-        catAxis->append(prevColLabels);
+        catAxis->append( escapedCategories(chartData.categories) );
         chart->addAxis(catAxis, catAlign);
         series->attachAxis(catAxis);
-        if (plotParams.xType == PlotArgumentType)
-            catAxis->setTitleText("Argument " + QString::number(plotParams.xIdx+1));
-        else if (plotParams.xType == PlotTemplateType)
-            catAxis->setTitleText("Template " + QString::number(plotParams.xIdx+1));
+        if ( !chartData.xTitle.isEmpty() )
+            catAxis->setTitleText(chartData.xTitle);
         
         // Y-axis
         QValueAxis* valAxis = new QValueAxis();
         chart->addAxis(valAxis, valAlign);
         series->attachAxis(valAxis);
         valAxis->applyNiceNumbers();
-        valAxis->setTitleText( getYPlotName(plotParams.yType, bchResults.meta.time_unit) );
+        valAxis->setTitleText(chartData.yTitle);
     }
     else
         chart->setTitle("No compatible series to display");
@@ -275,6 +270,79 @@ void PlotterBarChart::setupChart(const BenchResults &bchResults, const QVector<i
     }
 }
 
+bool PlotterBarChart::reconcileChart(const BarChartData &chartData, QString &errorMsg)
+{
+    // Existing axes required (i.e. sets displayed)
+    QChart* chart = mChartView->chart();
+    const auto& chartSeries = chart->series();
+    const auto catAxes = chart->axes(mIsVert ? Qt::Horizontal : Qt::Vertical);
+    if (chartSeries.size() != 1 || catAxes.isEmpty() || chartData.sets.isEmpty()) {
+        errorMsg = "No compatible series to display";
+        return false;
+    }
+    QAbstractBarSeries* series = (QAbstractBarSeries*)chartSeries[0];
+    
+    // Subset of benchmarks: same sets required (in order)
+    if ( !mAllIndexes && !sameSeriesNames(mSeriesMapping, chartData.sets, errorMsg) )
+        return false;
+    
+    // Match sets by name
+    QHash<QString, const BarSetData*> newSets;
+    for (const auto& setData : chartData.sets)
+        newSets.insert(setData.name, &setData);
+    
+    // Update kept sets (changed values only), remove others
+    SeriesMapping newMapping;
+    const auto oldBarSets = series->barSets();
+    for (int idx = 0; idx < oldBarSets.size(); ++idx)
+    {
+        QBarSet* barSet = oldBarSets[idx];
+        const BarSetData* setData = newSets.take(mSeriesMapping[idx].oldName);
+        if (setData == nullptr) {
+            series->remove(barSet);
+            continue;
+        }
+        const QList<qreal> values = scaledValues(setData->values, mCurrentTimeFactor);
+        bool changed = values.size() != barSet->count();
+        for (int col = 0; !changed && col < values.size(); ++col)
+            changed = values[col] != barSet->at(col);
+        if (changed) {
+            barSet->remove(0, barSet->count());
+            barSet->append(values);
+        }
+        newMapping.push_back(mSeriesMapping[idx]);
+    }
+    
+    // Add new sets (styled by chart theme)
+    int keptCount = newMapping.size();
+    for (const auto& setData : chartData.sets)
+    {
+        if ( !newSets.contains(setData.name) )
+            continue;
+        
+        QBarSet* barSet = new QBarSet( setData.name.toHtmlEscaped() );
+        barSet->append( scaledValues(setData.values, mCurrentTimeFactor) );
+        series->append(barSet);
+        
+        newMapping.push_back({setData.name, setData.name});
+    }
+    mSeriesMapping = newMapping;
+    
+    // New series: saved config if any, as when set up
+    if (keptCount < mSeriesMapping.size()) {
+        loadSeriesConfig(QString(config_folder) + config_file, mSeriesMapping, keptCount);
+        applySeriesConfig(keptCount);
+    }
+    
+    // Update columns
+    QBarCategoryAxis* catAxis = (QBarCategoryAxis*)(catAxes.constFirst());
+    const QStringList categories = escapedCategories(chartData.categories);
+    if (catAxis->categories() != categories)
+        catAxis->setCategories(categories);
+    
+    return true;
+}
+
 void PlotterBarChart::setupOptions(bool init)
 {
     auto chart = mChartView->chart();
@@ -370,10 +438,26 @@ void PlotterBarChart::setupOptions(bool init)
         onCheckAutoReload(Qt::Checked);
     
     // Update series color config
+    applySeriesConfig();
+    
+    // Restore selected axis
+    if (!init)
+        ui->comboBoxAxis->setCurrentIndex(prevAxisIdx);
+    
+    // Update timestamp
+    QDateTime today = QDateTime::currentDateTime();
+    QTime now = today.time();
+    ui->labelLastReload->setText("(Last: " + now.toString() + ")");
+}
+
+// Saved or edited colors and names applied to series (theme colors kept otherwise)
+void PlotterBarChart::applySeriesConfig(int from)
+{
+    auto chart = mChartView->chart();
     if (!chart->series().empty())
     {
         const auto barSeries = (QAbstractBarSeries*)chart->series().at(0);
-        for (int idx = 0 ; idx < mSeriesMapping.size(); ++idx)
+        for (int idx = from; idx < mSeriesMapping.size(); ++idx)
         {
             auto& config = mSeriesMapping[idx];
             const auto& barSet = barSeries->barSets().at(idx);
@@ -388,15 +472,6 @@ void PlotterBarChart::setupOptions(bool init)
                 barSet->setLabel( config.newName.toHtmlEscaped() );
         }
     }
-    
-    // Restore selected axis
-    if (!init)
-        ui->comboBoxAxis->setCurrentIndex(prevAxisIdx);
-    
-    // Update timestamp
-    QDateTime today = QDateTime::currentDateTime();
-    QTime now = today.time();
-    ui->labelLastReload->setText("(Last: " + now.toString() + ")");
 }
 
 void PlotterBarChart::loadConfig(bool init)
@@ -422,25 +497,7 @@ void PlotterBarChart::loadConfig(bool init)
             ui->spinBoxLegendFontSize->setValue( json["legend.fontSize"].toInt(8) );
         
         // Series
-        if (json.contains("series") && json["series"].isArray())
-        {
-            auto series = json["series"].toArray();
-            for (int idx = 0; idx < series.size(); ++idx) {
-                QJsonObject config = series[idx].toObject();
-                if ( config.contains("oldName")  && config["oldName"].isString()
-                  && config.contains("newName")  && config["newName"].isString()
-                  && config.contains("newColor") && config["newColor"].isString()
-                  && QColor::isValidColorName(config["newColor"].toString()) )
-                {
-                    SeriesConfig savedConfig(config["oldName"].toString(), "");
-                    int iCfg = mSeriesMapping.indexOf(savedConfig);
-                    if (iCfg >= 0) {
-                        mSeriesMapping[iCfg].newName = config["newName"].toString();
-                        mSeriesMapping[iCfg].newColor.fromString( config["newColor"].toString() );
-                    }
-                }
-            }
-        }
+        loadSeriesConfig(json, mSeriesMapping);
         
         // Time
         if (!init) {
@@ -1102,146 +1159,76 @@ void PlotterBarChart::onSpinMTicksChanged(int i)
 // Actions
 void PlotterBarChart::onCheckAutoReload(int state)
 {
+    // Watched once for all windows of same files
     if (state == Qt::Checked)
-    {
-        if (mWatcher.files().empty())
-        {
-            mWatcher.addPath(mOrigFilename);
-            for (const auto& addFilename : mAddFilenames)
-                mWatcher.addPath( addFilename.filename );
-        }
-    }
+        ResultReloader::instance()->watch(this, mOrigFilename, mAddFilenames);
     else
-    {
-        if (!mWatcher.files().empty())
-            mWatcher.removePaths( mWatcher.files() );
-    }
+        ResultReloader::instance()->unwatch(this);
 }
 
-void PlotterBarChart::onAutoReload(const QString &path)
+void PlotterBarChart::onReloadClicked()
 {
-    QFileInfo fi(path);
-    if (fi.exists() && fi.isReadable() && fi.size() > 0)
-        onReloadClicked();
-    else
-        qWarning() << "Unable to auto-reload file: " << path;
+    // Parsed once for all windows of same files (updated on publication)
+    ResultReloader::instance()->reload(mOrigFilename, mAddFilenames, this);
 }
 
-void PlotterBarChart::onReloadClicked()
+void PlotterBarChart::onResultsPublished(const QString &sourceKey, const BenchSnapshot &bchResults)
 {
-    // Load new results
-    QString errorMsg;
-    BenchResults newBchResults = ResultParser::parseJsonFile( mOrigFilename, errorMsg );
-    
-    if ( newBchResults.benchmarks.isEmpty() ) {
-        QMessageBox::critical(this, "Chart reload", "Error parsing original file: " + mOrigFilename + " -> " + errorMsg);
+    // Newer results of same files only
+    if (sourceKey != mSourceKey || bchResults->version <= mBchResults->version)
         return;
-    }
     
-    for (const auto& addFile : std::as_const(mAddFilenames))
+    // Check compatibility with previous (current results kept if rejected)
+    if (mBenchIdxs.size() != bchResults->benchmarks.size())
     {
-        errorMsg.clear();
-        BenchResults newAddResults = ResultParser::parseJsonFile(addFile.filename, errorMsg);
-        if ( newAddResults.benchmarks.isEmpty() ) {
-            QMessageBox::critical(this, "Chart reload", "Error parsing additional file: " + addFile.filename + " -> " + errorMsg);
+        if (!mAllIndexes) {
+            QMessageBox::critical(this, "Chart reload", "Number of series/points is different");
             return;
         }
-        
-        if (addFile.isAppend)
-            newBchResults.appendResults(newAddResults);
-        else
-            newBchResults.overwriteResults(newAddResults);
+        mBenchIdxs = bchResults->segmentAll();
     }
+    mBchResults = bchResults;
     
-    // Check compatibility with previous
-    errorMsg.clear();
-    if (mBenchIdxs.size() != newBchResults.benchmarks.size())
-    {
-        errorMsg = "Number of series/points is different";
-        if (mAllIndexes)
-        {
-            mBenchIdxs.clear();
-            for (int i=0; i<newBchResults.benchmarks.size(); ++i)
-                mBenchIdxs.append(i);
-        }
-    }
+    // Updated once computed
+    computeChart();
+}
+
+void PlotterBarChart::onChartComputed()
+{
+    // Superseded meanwhile
+    if (mChartCanceled->loadRelaxed() != 0)
+        return;
+    const BarChartData chartData = mChartWatcher.result();
     
-    QVector<BenchSubset> newBchSubsets = newBchResults.groupParam(mPlotParams.xType == PlotArgumentType,
-                                                                  mBenchIdxs, mPlotParams.xIdx, "X");
-    int newBarSetIdx = 0;
-    const auto& oldChartSeries = mChartView->chart()->series();
-    if ( newBchSubsets.isEmpty() ) {
-        errorMsg = "No compatible series to display";   // Ignore empty series
-    }
-    if (oldChartSeries.size() != 1) {
-        errorMsg = "No compatible series to display originally";
+    // First chart
+    if (mChartView == nullptr)
+    {
+        setupChart(chartData);
+        setupOptions();
+        
+        // Show
+        ui->horizontalLayout->insertWidget(0, mChartView);
+        this->setEnabled(true);
+        return;
     }
     
-    if (errorMsg.isEmpty())
+    // Update displayed sets in place (axes and ranges kept)
+    QString errorMsg;
+    if ( !reconcileChart(chartData, errorMsg) )
     {
-        const QAbstractBarSeries* oldBarSeries = (QAbstractBarSeries*)oldChartSeries[0];
-        for (const auto& bchSubset : std::as_const(newBchSubsets))
+        // Reset update if all benchmarks
+        if (mAllIndexes)
         {
-            // Ignore empty set
-            if ( bchSubset.idxs.isEmpty() )
-                continue;
-            if (newBarSetIdx >= oldBarSeries->count())
-                break;
-            
-            const QString& subsetName = bchSubset.name;
-            if (subsetName != mSeriesMapping[newBarSetIdx].oldName) {
-                errorMsg = "Series has different name";
-                break;
-            }
-            const auto barSet = oldBarSeries->barSets().at(newBarSetIdx);
-            if (bchSubset.idxs.size() != barSet->count())
-            {
-                errorMsg = "Number of series bars is different";
-                break;
-            }
-            ++newBarSetIdx;
+            saveConfig();
+            setupChart(chartData, false);
+            setupOptions(false);
         }
-        if (newBarSetIdx != oldBarSeries->count()) {
-            errorMsg = "Number of series is different";
-        }
-    }
-    
-    // Direct update if compatible
-    if ( errorMsg.isEmpty() )
-    {
-        newBarSetIdx = 0;
-        const QAbstractBarSeries* oldBarSeries = (QAbstractBarSeries*)oldChartSeries[0];
-        for (const auto& bchSubset : std::as_const(newBchSubsets))
+        else
         {
-            // Ignore empty set
-            if ( bchSubset.idxs.isEmpty() ) {
-                qWarning() << "No X-value to trace bar for:" << bchSubset.name;
-                continue;
-            }
-            
-            // Update points
-            const auto& barSet = oldBarSeries->barSets().at(newBarSetIdx);
-            barSet->remove(0, barSet->count());
-            
-            for (int idx : bchSubset.idxs) {
-                // Add column
-                barSet->append(getYPlotValue(newBchResults.benchmarks[idx], mPlotParams.yType) * mCurrentTimeFactor);
-            }
-            ++newBarSetIdx;
+            QMessageBox::critical(this, "Chart reload", errorMsg);
+            return;
         }
     }
-    // Reset update if all benchmarks
-    else if (mAllIndexes)
-    {
-        saveConfig();
-        setupChart(newBchResults, mBenchIdxs, mPlotParams, false);
-        setupOptions(false);
-    }
-    else
-    {
-        QMessageBox::critical(this, "Chart reload", errorMsg);
-        return;
-    }
     
     // Update timestamp
     QDateTime today = QDateTime::currentDateTime();
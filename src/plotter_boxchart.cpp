@@ -17,7 +17,8 @@
 #include "ui_plotter_boxchart.h"
 
 #include "benchmark_results.h"
-#include "result_parser.h"
+#include "result_reloader.h"
+#include "result_snapshots.h"
 
 #include <QFileInfo>
 #include <QDateTime>
@@ -26,6 +27,7 @@
 #include <QJsonObject>
 #include <QJsonDocument>
 #include <QtCharts>
+#include <QtConcurrent>
 
 #include <memory>
 #include <utility>
@@ -33,18 +35,65 @@
 static const char* config_file = "config_boxes.json";
 static const bool force_config = false;
 
+// Box with Y-values in displayed time unit
+static QBoxSet* newBoxSet(const BoxData &boxData, double timeFactor)
+{
+    QBoxSet* box = new QBoxSet( boxData.name.toHtmlEscaped() );
+    box->setValue(QBoxSet::LowerExtreme,  boxData.stats.min      * timeFactor);
+    box->setValue(QBoxSet::UpperExtreme,  boxData.stats.max      * timeFactor);
+    box->setValue(QBoxSet::Median,        boxData.stats.median   * timeFactor);
+    box->setValue(QBoxSet::LowerQuartile, boxData.stats.lowQuart * timeFactor);
+    box->setValue(QBoxSet::UpperQuartile, boxData.stats.uppQuart * timeFactor);
+    
+    return box;
+}
+
+// Named series of boxes
+static QBoxPlotSeries* newBoxSeries(const BoxSeriesData &seriesData, double timeFactor)
+{
+    QBoxPlotSeries* series = new QBoxPlotSeries();
+    for (const auto& boxData : seriesData.boxes)
+        series->append( newBoxSet(boxData, timeFactor) );
+    series->setName( seriesData.name.toHtmlEscaped() );
+    
+    return series;
+}
+
+// Same boxes as displayed
+static bool sameBoxes(const QBoxPlotSeries* series, const BoxSeriesData &seriesData, double timeFactor)
+{
+    if (series->count() != seriesData.boxes.size())
+        return false;
+    
+    const auto boxSets = series->boxSets();
+    for (int idx = 0; idx < boxSets.size(); ++idx)
+    {
+        const QBoxSet* box = boxSets[idx];
+        const auto& boxData = seriesData.boxes[idx];
+        if (box->label() != boxData.name.toHtmlEscaped()
+                || box->at(QBoxSet::LowerExtreme)  != boxData.stats.min      * timeFactor
+                || box->at(QBoxSet::UpperExtreme)  != boxData.stats.max      * timeFactor
+                || box->at(QBoxSet::Median)        != boxData.stats.median   * timeFactor
+                || box->at(QBoxSet::LowerQuartile) != boxData.stats.lowQuart * timeFactor
+                || box->at(QBoxSet::UpperQuartile) != boxData.stats.uppQuart * timeFactor)
+            return false;
+    }
+    return true;
+}
 
-PlotterBoxChart::PlotterBoxChart(BenchResults &bchResults, const QVector<int> &bchIdxs,
+
+PlotterBoxChart::PlotterBoxChart(const BenchSnapshot &bchResults, const QVector<int> &bchIdxs,
                                  const PlotParams &plotParams, const QString &origFilename,
                                  const QVector<FileReload>& addFilenames, QWidget *parent)
     : QWidget(parent)
     , ui(new Ui::PlotterBoxChart)
+    , mBchResults(bchResults)
     , mBenchIdxs(bchIdxs)
     , mPlotParams(plotParams)
     , mOrigFilename(origFilename)
     , mAddFilenames(addFilenames)
-    , mAllIndexes(bchIdxs.size() == bchResults.benchmarks.size())
-    , mWatcher(parent)
+    , mSourceKey(ResultSnapshots::sourceKey(origFilename, addFilenames))
+    , mAllIndexes(bchIdxs.size() == bchResults->benchmarks.size())
 {
     // UI
     ui->setupUi(this);
@@ -55,18 +104,20 @@ PlotterBoxChart::PlotterBoxChart(BenchResults &bchResults, const QVector<int> &b
     
     connectUI();
     
-    // Init
-    setupChart(bchResults, bchIdxs, plotParams);
-    setupOptions();
-    
-    // Show
-    ui->horizontalLayout->insertWidget(0, mChartView);
+    // Init (shown once computed)
+    this->setEnabled(false);
+    computeChart();
 }
 
 PlotterBoxChart::~PlotterBoxChart()
 {
+    // Stop computing
+    if ( !mChartCanceled.isNull() )
+        mChartCanceled->storeRelaxed(1);
+    
     // Save options to file
-    saveConfig();
+    if (mChartView != nullptr)
+        saveConfig();
     
     delete ui;
 }
@@ -127,13 +178,31 @@ void PlotterBoxChart::connectUI()
     connect(ui->spinBoxMTicks,       QOverload<int>::of(&QSpinBox::valueChanged), this, &PlotterBoxChart::onSpinMTicksChanged);
     
     // Actions
-    connect(&mWatcher,              &QFileSystemWatcher::fileChanged, this, &PlotterBoxChart::onAutoReload);
     connect(ui->checkBoxAutoReload, &QCheckBox::stateChanged, this, &PlotterBoxChart::onCheckAutoReload);
     connect(ui->pushButtonReload,   &QPushButton::clicked, this, &PlotterBoxChart::onReloadClicked);
+    connect(ResultSnapshots::instance(), &ResultSnapshots::published, this, &PlotterBoxChart::onResultsPublished);
+    connect(&mChartWatcher, &QFutureWatcher<BoxChartData>::finished, this, &PlotterBoxChart::onChartComputed);
     connect(ui->pushButtonSnapshot, &QPushButton::clicked, this, &PlotterBoxChart::onSnapshotClicked);
 }
 
-void PlotterBoxChart::setupChart(BenchResults &bchResults, const QVector<int> &bchIdxs, const PlotParams &plotParams, bool init)
+void PlotterBoxChart::computeChart()
+{
+    // Supersede running computation
+    if ( !mChartCanceled.isNull() )
+        mChartCanceled->storeRelaxed(1);
+    mChartCanceled = QSharedPointer<QAtomicInt>::create(0);
+    
+    // Worker only uses copies (results immutable)
+    BenchSnapshot bchResults = mBchResults;
+    QVector<int> bchIdxs = mBenchIdxs;
+    PlotParams plotParams = mPlotParams;
+    QSharedPointer<QAtomicInt> canceled = mChartCanceled;
+    mChartWatcher.setFuture( QtConcurrent::run([bchResults, bchIdxs, plotParams, canceled]() {
+        return ChartData::computeBoxes(*bchResults, bchIdxs, plotParams, canceled.data());
+    }) );
+}
+
+void PlotterBoxChart::setupChart(const BoxChartData &chartData, bool init)
 {
 //    std::unique_ptr<QChart> scopedChart(new QChart());
 //    QChart* chart = scopedChart.get();
@@ -158,48 +227,15 @@ void PlotterBoxChart::setupChart(BenchResults &bchResults, const QVector<int> &b
     Q_ASSERT(chart);
     
     // Time unit
-    mCurrentTimeFactor = 1.;
-    if ( isYTimeBased(mPlotParams.yType) ) {
-        if (     bchResults.meta.time_unit == "ns") mCurrentTimeFactor = 1000.;
-        else if (bchResults.meta.time_unit == "ms") mCurrentTimeFactor = 0.001;
-    }
+    mCurrentTimeFactor = ChartData::timeFactor(chartData.timeUnit, mPlotParams.yType);
     
     
-    // 2D Boxes and whiskers
-    // X: argumentA or templateB
-    // Y: time/iter/bytes/items (not name dependent)
-    // Box: one per benchmark % X-param
-    QVector<BenchSubset> bchSubsets = bchResults.groupParam(plotParams.xType == PlotArgumentType,
-                                                            bchIdxs, plotParams.xIdx, "X");
-    for (const auto& bchSubset : std::as_const(bchSubsets))
+    // 2D Boxes and whiskers (computed stats)
+    for (const auto& seriesData : chartData.series)
     {
         // Series = benchmark % X-param
-        std::unique_ptr<QBoxPlotSeries> series(new QBoxPlotSeries());
-        
-        const QString & subsetName = bchSubset.name;
-//        qDebug() << "subsetName:" << subsetName;
-//        qDebug() << "subsetIdxs:" << bchSubset.idxs;
-        
-        for (int idx : bchSubset.idxs)
-        {
-            QString xName = bchResults.getParamName(plotParams.xType == PlotArgumentType,
-                                                    idx, plotParams.xIdx);
-            BenchYStats yStats = getYPlotStats(bchResults.benchmarks[idx], plotParams.yType);
-            
-            // BoxSet
-            std::unique_ptr<QBoxSet> box(new QBoxSet( xName.toHtmlEscaped() ));
-            box->setValue(QBoxSet::LowerExtreme,  yStats.min      * mCurrentTimeFactor);
-            box->setValue(QBoxSet::UpperExtreme,  yStats.max      * mCurrentTimeFactor);
-            box->setValue(QBoxSet::Median,        yStats.median   * mCurrentTimeFactor);
-            box->setValue(QBoxSet::LowerQuartile, yStats.lowQuart * mCurrentTimeFactor);
-            box->setValue(QBoxSet::UpperQuartile, yStats.uppQuart * mCurrentTimeFactor);
-            
-            series->append(box.release());
-        }
-        // Add series
-        series->setName( subsetName.toHtmlEscaped() );
-        mSeriesMapping.push_back({subsetName, subsetName}); // color set later
-        chart->addSeries(series.release());
+        chart->addSeries( newBoxSeries(seriesData, mCurrentTimeFactor) );
+        mSeriesMapping.push_back({seriesData.name, seriesData.name}); // color set later
     }
     
     // Axes
@@ -210,16 +246,14 @@ void PlotterBoxChart::setupChart(BenchResults &bchResults, const QVector<int> &b
         
         // X-axis
         QBarCategoryAxis* xAxis = (QBarCategoryAxis*)(chart->axes(Qt::Horizontal).constFirst());
-        if (plotParams.xType == PlotArgumentType)
-            xAxis->setTitleText("Argument " + QString::number(plotParams.xIdx+1));
-        else if (plotParams.xType == PlotTemplateType)
-            xAxis->setTitleText("Template " + QString::number(plotParams.xIdx+1));
-        if (plotParams.xType != PlotEmptyType)
+        if ( !chartData.xTitle.isEmpty() ) {
+            xAxis->setTitleText(chartData.xTitle);
             xAxis->setTitleVisible(true);
+        }
         
         // Y-axis
         QValueAxis* yAxis = (QValueAxis*)(chart->axes(Qt::Vertical).constFirst());
-        yAxis->setTitleText( getYPlotName(plotParams.yType, bchResults.meta.time_unit) );
+        yAxis->setTitleText(chartData.yTitle);
         yAxis->applyNiceNumbers();
     }
     else
@@ -233,6 +267,85 @@ void PlotterBoxChart::setupChart(BenchResults &bchResults, const QVector<int> &b
     }
 }
 
+bool PlotterBoxChart::reconcileChart(const BoxChartData &chartData, QString &errorMsg)
+{
+    // Existing axes required (i.e. series displayed)
+    QChart* chart = mChartView->chart();
+    const auto xAxes = chart->axes(Qt::Horizontal);
+    const auto yAxes = chart->axes(Qt::Vertical);
+    if (xAxes.isEmpty() || yAxes.isEmpty() || chartData.series.isEmpty()) {
+        errorMsg = "No compatible series to display";
+        return false;
+    }
+    
+    // Subset of benchmarks: same series required (in order)
+    if ( !mAllIndexes && !sameSeriesNames(mSeriesMapping, chartData.series, errorMsg) )
+        return false;
+    
+    // Match series by name
+    QHash<QString, const BoxSeriesData*> newSeries;
+    for (const auto& seriesData : chartData.series)
+        newSeries.insert(seriesData.name, &seriesData);
+    
+    // Update kept series (changed boxes only), remove others
+    SeriesMapping newMapping;
+    const auto oldChartSeries = chart->series();
+    for (int idx = 0; idx < oldChartSeries.size(); ++idx)
+    {
+        QBoxPlotSeries* series = (QBoxPlotSeries*)oldChartSeries[idx];
+        const BoxSeriesData* seriesData = newSeries.take(mSeriesMapping[idx].oldName);
+        if (seriesData == nullptr) {
+            chart->removeSeries(series);
+            delete series;
+            continue;
+        }
+        if ( !sameBoxes(series, *seriesData, mCurrentTimeFactor) ) {
+            series->clear();
+            for (const auto& boxData : seriesData->boxes)
+                series->append( newBoxSet(boxData, mCurrentTimeFactor) );
+        }
+        newMapping.push_back(mSeriesMapping[idx]);
+    }
+    
+    // Add new series (on current axes)
+    int keptCount = newMapping.size();
+    for (const auto& seriesData : chartData.series)
+    {
+        if ( !newSeries.contains(seriesData.name) )
+            continue;
+        
+        QBoxPlotSeries* series = newBoxSeries(seriesData, mCurrentTimeFactor);
+        chart->addSeries(series);
+        series->attachAxis( xAxes.constFirst() );
+        series->attachAxis( yAxes.constFirst() );
+        
+        newMapping.push_back({seriesData.name, seriesData.name});
+    }
+    mSeriesMapping = newMapping;
+    
+    // New series: saved config if any, as when set up
+    if (keptCount < mSeriesMapping.size()) {
+        loadSeriesConfig(QString(config_folder) + config_file, mSeriesMapping, keptCount);
+        applySeriesConfig(keptCount);
+    }
+    
+    // Update columns
+    QStringList categories;
+    for (const auto& seriesData : chartData.series)
+    {
+        for (const auto& boxData : seriesData.boxes) {
+            const QString label = boxData.name.toHtmlEscaped();
+            if ( !categories.contains(label) )
+                categories.append(label);
+        }
+    }
+    QBarCategoryAxis* xAxis = (QBarCategoryAxis*)(xAxes.constFirst());
+    if (xAxis->categories() != categories)
+        xAxis->setCategories(categories);
+    
+    return true;
+}
+
 void PlotterBoxChart::setupOptions(bool init)
 {
     auto chart = mChartView->chart();
@@ -322,8 +435,24 @@ void PlotterBoxChart::setupOptions(bool init)
         onCheckAutoReload(Qt::Checked);
     
     // Update series color config
+    applySeriesConfig();
+    
+    // Restore selected axis
+    if (!init)
+        ui->comboBoxAxis->setCurrentIndex(prevAxisIdx);
+    
+    // Update timestamp
+    QDateTime today = QDateTime::currentDateTime();
+    QTime now = today.time();
+    ui->labelLastReload->setText("(Last: " + now.toString() + ")");
+}
+
+// Saved or edited colors and names applied to series (theme colors kept otherwise)
+void PlotterBoxChart::applySeriesConfig(int from)
+{
+    auto chart = mChartView->chart();
     const auto& chartSeries = chart->series();
-    for (int idx = 0 ; idx < mSeriesMapping.size(); ++idx)
+    for (int idx = from; idx < mSeriesMapping.size(); ++idx)
     {
         auto& config = mSeriesMapping[idx];
         const auto& series = (QBoxPlotSeries*)chartSeries.at(idx);
@@ -340,15 +469,6 @@ void PlotterBoxChart::setupOptions(bool init)
         if (config.newName != config.oldName)
             series->setName( config.newName.toHtmlEscaped() );
     }
-    
-    // Restore selected axis
-    if (!init)
-        ui->comboBoxAxis->setCurrentIndex(prevAxisIdx);
-    
-    // Update timestamp
-    QDateTime today = QDateTime::currentDateTime();
-    QTime now = today.time();
-    ui->labelLastReload->setText("(Last: " + now.toString() + ")");
 }
 
 void PlotterBoxChart::loadConfig(bool init)
@@ -374,25 +494,7 @@ void PlotterBoxChart::loadConfig(bool init)
             ui->spinBoxLegendFontSize->setValue( json["legend.fontSize"].toInt(8) );
         
         // Series
-        if (json.contains("series") && json["series"].isArray())
-        {
-            auto series = json["series"].toArray();
-            for (int idx = 0; idx < series.size(); ++idx) {
-                QJsonObject config = series[idx].toObject();
-                if ( config.contains("oldName")  && config["oldName"].isString()
-                  && config.contains("newName")  && config["newName"].isString()
-                  && config.contains("newColor") && config["newColor"].isString()
-                  && QColor::isValidColorName(config["newColor"].toString()) )
-                {
-                    SeriesConfig savedConfig(config["oldName"].toString(), "");
-                    int iCfg = mSeriesMapping.indexOf(savedConfig);
-                    if (iCfg >= 0) {
-                        mSeriesMapping[iCfg].newName = config["newName"].toString();
-                        mSeriesMapping[iCfg].newColor.fromString( config["newColor"].toString() );
-                    }
-                }
-            }
-        }
+        loadSeriesConfig(json, mSeriesMapping);
         
         // Time
         if (!init) {
@@ -1002,140 +1104,76 @@ void PlotterBoxChart::onSpinMTicksChanged(int i)
 // Actions
 void PlotterBoxChart::onCheckAutoReload(int state)
 {
+    // Watched once for all windows of same files
     if (state == Qt::Checked)
-    {
-        if (mWatcher.files().empty())
-        {
-            mWatcher.addPath(mOrigFilename);
-            for (const auto& addFilename : mAddFilenames)
-                mWatcher.addPath( addFilename.filename );
-        }
-    }
+        ResultReloader::instance()->watch(this, mOrigFilename, mAddFilenames);
     else
-    {
-        if (!mWatcher.files().empty())
-            mWatcher.removePaths( mWatcher.files() );
-    }
+        ResultReloader::instance()->unwatch(this);
 }
 
-void PlotterBoxChart::onAutoReload(const QString &path)
+void PlotterBoxChart::onReloadClicked()
 {
-    QFileInfo fi(path);
-    if (fi.exists() && fi.isReadable() && fi.size() > 0)
-        onReloadClicked();
-    else
-        qWarning() << "Unable to auto-reload file: " << path;
+    // Parsed once for all windows of same files (updated on publication)
+    ResultReloader::instance()->reload(mOrigFilename, mAddFilenames, this);
 }
 
-void PlotterBoxChart::onReloadClicked()
+void PlotterBoxChart::onResultsPublished(const QString &sourceKey, const BenchSnapshot &bchResults)
 {
-    // Load new results
-    QString errorMsg;
-    BenchResults newBchResults = ResultParser::parseJsonFile( mOrigFilename, errorMsg );
-    
-    if ( newBchResults.benchmarks.isEmpty() ) {
-        QMessageBox::critical(this, "Chart reload", "Error parsing original file: " + mOrigFilename + " -> " + errorMsg);
+    // Newer results of same files only
+    if (sourceKey != mSourceKey || bchResults->version <= mBchResults->version)
         return;
-    }
     
-    for (const auto& addFile : std::as_const(mAddFilenames))
+    // Check compatibility with previous (current results kept if rejected)
+    if (mBenchIdxs.size() != bchResults->benchmarks.size())
     {
-        errorMsg.clear();
-        BenchResults newAddResults = ResultParser::parseJsonFile(addFile.filename, errorMsg);
-        if ( newAddResults.benchmarks.isEmpty() ) {
-            QMessageBox::critical(this, "Chart reload", "Error parsing additional file: " + addFile.filename + " -> " + errorMsg);
+        if (!mAllIndexes) {
+            QMessageBox::critical(this, "Chart reload", "Number of series/points is different");
             return;
         }
-        
-        if (addFile.isAppend)
-            newBchResults.appendResults(newAddResults);
-        else
-            newBchResults.overwriteResults(newAddResults);
+        mBenchIdxs = bchResults->segmentAll();
     }
+    mBchResults = bchResults;
+    
+    // Updated once computed
+    computeChart();
+}
+
+void PlotterBoxChart::onChartComputed()
+{
+    // Superseded meanwhile
+    if (mChartCanceled->loadRelaxed() != 0)
+        return;
+    const BoxChartData chartData = mChartWatcher.result();
     
-    // Check compatibility with previous
-    errorMsg.clear();
-    if (mBenchIdxs.size() != newBchResults.benchmarks.size())
+    // First chart
+    if (mChartView == nullptr)
     {
-        errorMsg = "Number of series/points is different";
-        if (mAllIndexes)
-        {
-            mBenchIdxs.clear();
-            for (int i=0; i<newBchResults.benchmarks.size(); ++i)
-                mBenchIdxs.append(i);
-        }
+        setupChart(chartData);
+        setupOptions();
+        
+        // Show
+        ui->horizontalLayout->insertWidget(0, mChartView);
+        this->setEnabled(true);
+        return;
     }
     
-    QVector<BenchSubset> newBchSubsets = newBchResults.groupParam(mPlotParams.xType == PlotArgumentType,
-                                                                  mBenchIdxs, mPlotParams.xIdx, "X");
-    const auto& oldChartSeries = mChartView->chart()->series();
-    int newSeriesIdx = 0;
-    if (errorMsg.isEmpty())
+    // Update displayed series in place (axes and ranges kept)
+    QString errorMsg;
+    if ( !reconcileChart(chartData, errorMsg) )
     {
-        for (const auto& bchSubset : std::as_const(newBchSubsets))
+        // Reset update if all benchmarks
+        if (mAllIndexes)
         {
-            if (newSeriesIdx >= oldChartSeries.size())
-                break;
-            
-            const QString& subsetName = bchSubset.name;
-            if (subsetName != mSeriesMapping[newSeriesIdx].oldName)
-            {
-                errorMsg = "Series has different name";
-                break;
-            }
-            const auto boxSeries = (QBoxPlotSeries*)oldChartSeries[newSeriesIdx];
-            if (bchSubset.idxs.size() != boxSeries->count())
-            {
-                errorMsg = "Series has different number of points";
-                break;
-            }
-            ++newSeriesIdx;
-        }
-        if (newSeriesIdx != oldChartSeries.size()) {
-            errorMsg = "Number of series is different";
+            saveConfig();
+            setupChart(chartData, false);
+            setupOptions(false);
         }
-    }
-    
-    // Direct update if compatible
-    if ( errorMsg.isEmpty() )
-    {
-        newSeriesIdx = 0;
-        for (const auto& bchSubset : std::as_const(newBchSubsets))
+        else
         {
-            // Update points
-            QBoxPlotSeries* oldSeries = (QBoxPlotSeries*)oldChartSeries[newSeriesIdx];
-            oldSeries->clear();
-            
-            for (int idx : bchSubset.idxs)
-            {
-                QString xName = newBchResults.getParamName(mPlotParams.xType == PlotArgumentType,
-                                                           idx, mPlotParams.xIdx);
-                BenchYStats yStats = getYPlotStats(newBchResults.benchmarks[idx], mPlotParams.yType);
-                
-                std::unique_ptr<QBoxSet> box(new QBoxSet( xName.toHtmlEscaped() ));
-                box->setValue(QBoxSet::LowerExtreme,  yStats.min      * mCurrentTimeFactor);
-                box->setValue(QBoxSet::UpperExtreme,  yStats.max      * mCurrentTimeFactor);
-                box->setValue(QBoxSet::Median,        yStats.median   * mCurrentTimeFactor);
-                box->setValue(QBoxSet::LowerQuartile, yStats.lowQuart * mCurrentTimeFactor);
-                box->setValue(QBoxSet::UpperQuartile, yStats.uppQuart * mCurrentTimeFactor);
-                
-                oldSeries->append(box.release());
-            }
-            ++newSeriesIdx;
+            QMessageBox::critical(this, "Chart reload", errorMsg);
+            return;
         }
     }
-    // Reset update if all benchmarks
-    else if (mAllIndexes)
-    {
-        saveConfig();
-        setupChart(newBchResults, mBenchIdxs, mPlotParams, false);
-        setupOptions(false);
-    }
-    else
-    {
-        QMessageBox::critical(this, "Chart reload", errorMsg);
-        return;
-    }
     
     // Update timestamp
     QDateTime today = QDateTime::currentDateTime();
@@ -17,7 +17,8 @@
 #include "ui_plotter_linechart.h"
 
 #include "benchmark_results.h"
-#include "result_parser.h"
+#include "result_reloader.h"
+#include "result_snapshots.h"
 
 #include <QFileInfo>
 #include <QDateTime>
@@ -27,24 +28,50 @@
 #include <QJsonObject>
 #include <QJsonDocument>
 #include <QtCharts>
+#include <QtConcurrent>
 
 #include <memory>
 #include <utility>
 
 static const char* config_file = "config_lines.json";
 
+// Points with Y-values in displayed time unit
+static QList<QPointF> scaledPoints(const QVector<QPointF> &points, double timeFactor)
+{
+    QList<QPointF> scaled;
+    scaled.reserve( points.size() );
+    for (const auto& point : points)
+        scaled.append( QPointF(point.x(), point.y() * timeFactor) );
+    
+    return scaled;
+}
+
+// Named line or spline series
+static QXYSeries* newLineSeries(const LineSeriesData &seriesData, PlotChartType type, double timeFactor)
+{
+    QXYSeries* series = nullptr;
+    if (type == ChartLineType)  series = new QLineSeries();
+    else                        series = new QSplineSeries();
+    
+    series->append( scaledPoints(seriesData.points, timeFactor) );
+    series->setName( seriesData.name.toHtmlEscaped() );
+    
+    return series;
+}
 
-PlotterLineChart::PlotterLineChart(const BenchResults &bchResults, const QVector<int> &bchIdxs,
+
+PlotterLineChart::PlotterLineChart(const BenchSnapshot &bchResults, const QVector<int> &bchIdxs,
                                    const PlotParams &plotParams, const QString &origFilename,
                                    const QVector<FileReload>& addFilenames, QWidget *parent)
     : QWidget(parent)
     , ui(new Ui::PlotterLineChart)
+    , mBchResults(bchResults)
     , mBenchIdxs(bchIdxs)
     , mPlotParams(plotParams)
     , mOrigFilename(origFilename)
     , mAddFilenames(addFilenames)
-    , mAllIndexes(bchIdxs.size() == bchResults.benchmarks.size())
-    , mWatcher(parent)
+    , mSourceKey(ResultSnapshots::sourceKey(origFilename, addFilenames))
+    , mAllIndexes(bchIdxs.size() == bchResults->benchmarks.size())
 {
     // UI
     ui->setupUi(this);
@@ -59,18 +86,20 @@ PlotterLineChart::PlotterLineChart(const BenchResults &bchResults, const QVector
     //TODO: select points
     //See: https://doc.qt.io/qt-6/qtcharts-callout-example.html
     
-    // Init
-    setupChart(bchResults, bchIdxs, plotParams);
-    setupOptions();
-    
-    // Show
-    ui->horizontalLayout->insertWidget(0, mChartView);
+    // Init (shown once computed)
+    this->setEnabled(false);
+    computeChart();
 }
 
 PlotterLineChart::~PlotterLineChart()
 {
+    // Stop computing
+    if ( !mChartCanceled.isNull() )
+        mChartCanceled->storeRelaxed(1);
+    
     // Save options to file
-    saveConfig();
+    if (mChartView != nullptr)
+        saveConfig();
     
     delete ui;
 }
@@ -129,13 +158,31 @@ void PlotterLineChart::connectUI()
     connect(ui->spinBoxMTicks,       QOverload<int>::of(&QSpinBox::valueChanged), this, &PlotterLineChart::onSpinMTicksChanged);
     
     // Actions
-    connect(&mWatcher,              &QFileSystemWatcher::fileChanged, this, &PlotterLineChart::onAutoReload);
     connect(ui->checkBoxAutoReload, &QCheckBox::stateChanged, this, &PlotterLineChart::onCheckAutoReload);
     connect(ui->pushButtonReload,   &QPushButton::clicked, this, &PlotterLineChart::onReloadClicked);
+    connect(ResultSnapshots::instance(), &ResultSnapshots::published, this, &PlotterLineChart::onResultsPublished);
+    connect(&mChartWatcher, &QFutureWatcher<LineChartData>::finished, this, &PlotterLineChart::onChartComputed);
     connect(ui->pushButtonSnapshot, &QPushButton::clicked, this, &PlotterLineChart::onSnapshotClicked);
 }
 
-void PlotterLineChart::setupChart(const BenchResults &bchResults, const QVector<int> &bchIdxs, const PlotParams &plotParams, bool init)
+void PlotterLineChart::computeChart()
+{
+    // Supersede running computation
+    if ( !mChartCanceled.isNull() )
+        mChartCanceled->storeRelaxed(1);
+    mChartCanceled = QSharedPointer<QAtomicInt>::create(0);
+    
+    // Worker only uses copies (results immutable)
+    BenchSnapshot bchResults = mBchResults;
+    QVector<int> bchIdxs = mBenchIdxs;
+    PlotParams plotParams = mPlotParams;
+    QSharedPointer<QAtomicInt> canceled = mChartCanceled;
+    mChartWatcher.setFuture( QtConcurrent::run([bchResults, bchIdxs, plotParams, canceled]() {
+        return ChartData::computeLines(*bchResults, bchIdxs, plotParams, canceled.data());
+    }) );
+}
+
+void PlotterLineChart::setupChart(const LineChartData &chartData, bool init)
 {
     std::unique_ptr<QChart> scopedChart;
     QChart* chart = nullptr;
@@ -158,52 +205,15 @@ void PlotterLineChart::setupChart(const BenchResults &bchResults, const QVector<
     Q_ASSERT(chart);
     
     // Time unit
-    mCurrentTimeFactor = 1.;
-    if ( isYTimeBased(mPlotParams.yType) ) {
-        if (     bchResults.meta.time_unit == "ns") mCurrentTimeFactor = 1000.;
-        else if (bchResults.meta.time_unit == "ms") mCurrentTimeFactor = 0.001;
-    }
+    mCurrentTimeFactor = ChartData::timeFactor(chartData.timeUnit, mPlotParams.yType);
     
     
-    // 2D Lines
-    // X: argumentA or templateB
-    // Y: time/iter/bytes/items (not name dependent)
-    // Line: one per benchmark % X-param
-    QVector<BenchSubset> bchSubsets = bchResults.groupParam(plotParams.xType == PlotArgumentType,
-                                                            bchIdxs, plotParams.xIdx, "X");
-    bool custDataAxis = true;
-    QString custDataName;
-    for (const auto& bchSubset : std::as_const(bchSubsets))
+    // 2D Lines (computed points)
+    for (const auto& seriesData : chartData.series)
     {
-        // Ignore single point lines
-        if (bchSubset.idxs.size() < 2) {
-            qWarning() << "Not enough points to trace line for: " << bchSubset.name;
-            continue;
-        }
-        
-        // Chart type
-        std::unique_ptr<QLineSeries> series;
-        if (plotParams.type == ChartLineType)   series.reset(new QLineSeries());
-        else                                    series.reset(new QSplineSeries());
-        
-        const QString& subsetName = bchSubset.name;
-//        qDebug() << "subsetName:" << subsetName;
-//        qDebug() << "subsetIdxs:" << bchSubset.idxs;
-        
-        double xFallback = 0.;
-        for (int idx : bchSubset.idxs)
-        {
-            QString xName = bchResults.getParamName(plotParams.xType == PlotArgumentType,
-                                                    idx, plotParams.xIdx);
-            double xVal = BenchResults::getParamValue(xName, custDataName, custDataAxis, xFallback);
-            
-            // Add point
-            series->append(xVal, getYPlotValue(bchResults.benchmarks[idx], plotParams.yType) * mCurrentTimeFactor);
-        }
         // Add series
-        series->setName( subsetName.toHtmlEscaped() );
-        mSeriesMapping.push_back({subsetName, subsetName}); // color set later
-        chart->addSeries(series.release());
+        chart->addSeries( newLineSeries(seriesData, mPlotParams.type, mCurrentTimeFactor) );
+        mSeriesMapping.push_back({seriesData.name, seriesData.name}); // color set later
     }
     
     //
@@ -214,19 +224,12 @@ void PlotterLineChart::setupChart(const BenchResults &bchResults, const QVector<
         
         // X-axis
         QValueAxis* xAxis = (QValueAxis*)(chart->axes(Qt::Horizontal).constFirst());
-        if (plotParams.xType == PlotArgumentType)
-            xAxis->setTitleText("Argument " + QString::number(plotParams.xIdx+1));
-        else { // template
-            if ( !custDataName.isEmpty() )
-                xAxis->setTitleText(custDataName);
-            else
-                xAxis->setTitleText("Template " + QString::number(plotParams.xIdx+1));
-        }
+        xAxis->setTitleText(chartData.xTitle);
         xAxis->setTickCount(9);
         
         // Y-axis
         QValueAxis* yAxis = (QValueAxis*)(chart->axes(Qt::Vertical).constFirst());
-        yAxis->setTitleText( getYPlotName(plotParams.yType, bchResults.meta.time_unit) );
+        yAxis->setTitleText(chartData.yTitle);
         yAxis->applyNiceNumbers();
     }
     else
@@ -240,6 +243,69 @@ void PlotterLineChart::setupChart(const BenchResults &bchResults, const QVector<
     }
 }
 
+bool PlotterLineChart::reconcileChart(const LineChartData &chartData, QString &errorMsg)
+{
+    // Existing axes required (i.e. series displayed)
+    QChart* chart = mChartView->chart();
+    const auto xAxes = chart->axes(Qt::Horizontal);
+    const auto yAxes = chart->axes(Qt::Vertical);
+    if (xAxes.isEmpty() || yAxes.isEmpty() || chartData.series.isEmpty()) {
+        errorMsg = "No compatible series to display";
+        return false;
+    }
+    
+    // Subset of benchmarks: same series required (in order)
+    if ( !mAllIndexes && !sameSeriesNames(mSeriesMapping, chartData.series, errorMsg) )
+        return false;
+    
+    // Match series by name
+    QHash<QString, const LineSeriesData*> newSeries;
+    for (const auto& seriesData : chartData.series)
+        newSeries.insert(seriesData.name, &seriesData);
+    
+    // Update kept series (changed points only), remove others
+    SeriesMapping newMapping;
+    const auto oldChartSeries = chart->series();
+    for (int idx = 0; idx < oldChartSeries.size(); ++idx)
+    {
+        QXYSeries* series = (QXYSeries*)oldChartSeries[idx];
+        const LineSeriesData* seriesData = newSeries.take(mSeriesMapping[idx].oldName);
+        if (seriesData == nullptr) {
+            chart->removeSeries(series);
+            delete series;
+            continue;
+        }
+        const QList<QPointF> points = scaledPoints(seriesData->points, mCurrentTimeFactor);
+        if (series->points() != points)
+            series->replace(points);
+        newMapping.push_back(mSeriesMapping[idx]);
+    }
+    
+    // Add new series (on current axes)
+    int keptCount = newMapping.size();
+    for (const auto& seriesData : chartData.series)
+    {
+        if ( !newSeries.contains(seriesData.name) )
+            continue;
+        
+        QXYSeries* series = newLineSeries(seriesData, mPlotParams.type, mCurrentTimeFactor);
+        chart->addSeries(series);
+        series->attachAxis( xAxes.constFirst() );
+        series->attachAxis( yAxes.constFirst() );
+        
+        newMapping.push_back({seriesData.name, seriesData.name});
+    }
+    mSeriesMapping = newMapping;
+    
+    // New series: saved config if any, as when set up
+    if (keptCount < mSeriesMapping.size()) {
+        loadSeriesConfig(QString(config_folder) + config_file, mSeriesMapping, keptCount);
+        applySeriesConfig(keptCount);
+    }
+    
+    return true;
+}
+
 void PlotterLineChart::setupOptions(bool init)
 {
     auto chart = mChartView->chart();
@@ -327,8 +393,24 @@ void PlotterLineChart::setupOptions(bool init)
         onCheckAutoReload(Qt::Checked);
     
     // Update series color config
+    applySeriesConfig();
+    
+    // Restore selected axis
+    if (!init)
+        ui->comboBoxAxis->setCurrentIndex(prevAxisIdx);
+    
+    // Update timestamp
+    QDateTime today = QDateTime::currentDateTime();
+    QTime now = today.time();
+    ui->labelLastReload->setText("(Last: " + now.toString() + ")");
+}
+
+// Saved or edited colors and names applied to series (theme colors kept otherwise)
+void PlotterLineChart::applySeriesConfig(int from)
+{
+    auto chart = mChartView->chart();
     const auto& chartSeries = chart->series();
-    for (int idx = 0 ; idx < mSeriesMapping.size(); ++idx)
+    for (int idx = from; idx < mSeriesMapping.size(); ++idx)
     {
         auto& config = mSeriesMapping[idx];
         const auto& series = (QXYSeries*)chartSeries.at(idx);
@@ -342,15 +424,6 @@ void PlotterLineChart::setupOptions(bool init)
         if (config.newName != config.oldName)
             series->setName( config.newName.toHtmlEscaped() );
     }
-    
-    // Restore selected axis
-    if (!init)
-        ui->comboBoxAxis->setCurrentIndex(prevAxisIdx);
-    
-    // Update timestamp
-    QDateTime today = QDateTime::currentDateTime();
-    QTime now = today.time();
-    ui->labelLastReload->setText("(Last: " + now.toString() + ")");
 }
 
 void PlotterLineChart::loadConfig(bool init)
@@ -376,25 +449,7 @@ void PlotterLineChart::loadConfig(bool init)
             ui->spinBoxLegendFontSize->setValue( json["legend.fontSize"].toInt(8) );
         
         // Series
-        if (json.contains("series") && json["series"].isArray())
-        {
-            auto series = json["series"].toArray();
-            for (int idx = 0; idx < series.size(); ++idx) {
-                QJsonObject config = series[idx].toObject();
-                if ( config.contains("oldName")  && config["oldName"].isString()
-                  && config.contains("newName")  && config["newName"].isString()
-                  && config.contains("newColor") && config["newColor"].isString()
-                  && QColor::isValidColorName(config["newColor"].toString()) )
-                {
-                    SeriesConfig savedConfig(config["oldName"].toString(), "");
-                    int iCfg = mSeriesMapping.indexOf(savedConfig);
-                    if (iCfg >= 0) {
-                        mSeriesMapping[iCfg].newName = config["newName"].toString();
-                        mSeriesMapping[iCfg].newColor.fromString( config["newColor"].toString() );
-                    }
-                }
-            }
-        }
+        loadSeriesConfig(json, mSeriesMapping);
         
         // Time
         if (!init) {
@@ -967,143 +1022,76 @@ void PlotterLineChart::onSpinMTicksChanged(int i)
 // Actions
 void PlotterLineChart::onCheckAutoReload(int state)
 {
+    // Watched once for all windows of same files
     if (state == Qt::Checked)
-    {
-        if (mWatcher.files().empty())
-        {
-            mWatcher.addPath(mOrigFilename);
-            for (const auto& addFilename : std::as_const(mAddFilenames))
-                mWatcher.addPath( addFilename.filename );
-        }
-    }
+        ResultReloader::instance()->watch(this, mOrigFilename, mAddFilenames);
     else
-    {
-        if (!mWatcher.files().empty())
-            mWatcher.removePaths( mWatcher.files() );
-    }
+        ResultReloader::instance()->unwatch(this);
 }
 
-void PlotterLineChart::onAutoReload(const QString &path)
+void PlotterLineChart::onReloadClicked()
 {
-    QFileInfo fi(path);
-    if (fi.exists() && fi.isReadable() && fi.size() > 0)
-        onReloadClicked();
-    else
-        qWarning() << "Unable to auto-reload file: " << path;
+    // Parsed once for all windows of same files (updated on publication)
+    ResultReloader::instance()->reload(mOrigFilename, mAddFilenames, this);
 }
 
-void PlotterLineChart::onReloadClicked()
+void PlotterLineChart::onResultsPublished(const QString &sourceKey, const BenchSnapshot &bchResults)
 {
-    // Load new results
-    QString errorMsg;
-    BenchResults newBchResults = ResultParser::parseJsonFile( mOrigFilename, errorMsg );
-    
-    if ( newBchResults.benchmarks.isEmpty() ) {
-        QMessageBox::critical(this, "Chart reload", "Error parsing original file: " + mOrigFilename + " -> " + errorMsg);
+    // Newer results of same files only
+    if (sourceKey != mSourceKey || bchResults->version <= mBchResults->version)
         return;
-    }
-    for (const auto& addFile : std::as_const(mAddFilenames))
+    
+    // Check compatibility with previous (current results kept if rejected)
+    if (mBenchIdxs.size() != bchResults->benchmarks.size())
     {
-        errorMsg.clear();
-        BenchResults newAddResults = ResultParser::parseJsonFile(addFile.filename, errorMsg);
-        if ( newAddResults.benchmarks.isEmpty() ) {
-            QMessageBox::critical(this, "Chart reload", "Error parsing additional file: " + addFile.filename + " -> " + errorMsg);
+        if (!mAllIndexes) {
+            QMessageBox::critical(this, "Chart reload", "Number of series/points is different");
             return;
         }
-        if (addFile.isAppend)
-            newBchResults.appendResults(newAddResults);
-        else
-            newBchResults.overwriteResults(newAddResults);
+        mBenchIdxs = bchResults->segmentAll();
     }
+    mBchResults = bchResults;
     
-    // Check compatibility with previous
-    errorMsg.clear();
-    if (mBenchIdxs.size() != newBchResults.benchmarks.size())
+    // Updated once computed
+    computeChart();
+}
+
+void PlotterLineChart::onChartComputed()
+{
+    // Superseded meanwhile
+    if (mChartCanceled->loadRelaxed() != 0)
+        return;
+    const LineChartData chartData = mChartWatcher.result();
+    
+    // First chart
+    if (mChartView == nullptr)
     {
-        errorMsg = "Number of series/points is different";
-        if (mAllIndexes)
-        {
-            mBenchIdxs.clear();
-            for (int i=0; i<newBchResults.benchmarks.size(); ++i)
-                mBenchIdxs.append(i);
-        }
+        setupChart(chartData);
+        setupOptions();
+        
+        // Show
+        ui->horizontalLayout->insertWidget(0, mChartView);
+        this->setEnabled(true);
+        return;
     }
     
-    QVector<BenchSubset> newBchSubsets = newBchResults.groupParam(mPlotParams.xType == PlotArgumentType,
-                                                                  mBenchIdxs, mPlotParams.xIdx, "X");
-    const auto& oldChartSeries = mChartView->chart()->series();
-    int newSeriesIdx = 0;
-    if (errorMsg.isEmpty())
+    // Update displayed series in place (axes and ranges kept)
+    QString errorMsg;
+    if ( !reconcileChart(chartData, errorMsg) )
     {
-        for (const auto& bchSubset : std::as_const(newBchSubsets))
+        // Reset update if all benchmarks
+        if (mAllIndexes)
         {
-            // Ignore single point lines
-            if (bchSubset.idxs.size() < 2)
-                continue;
-            if (newSeriesIdx >= oldChartSeries.size())
-                break;
-            
-            const QString& subsetName = bchSubset.name;
-            if (subsetName != mSeriesMapping[newSeriesIdx].oldName) {
-                errorMsg = "Series has different name";
-                break;
-            }
-            const auto lineSeries = (QLineSeries*)(oldChartSeries[newSeriesIdx]);
-            if (bchSubset.idxs.size() != lineSeries->count())
-            {
-                errorMsg = "Series has different number of points";
-                break;
-            }
-            ++newSeriesIdx;
+            saveConfig();
+            setupChart(chartData, false);
+            setupOptions(false);
         }
-        if (newSeriesIdx != oldChartSeries.size()) {
-            errorMsg = "Number of series is different";
-        }
-    }
-    
-    // Direct update if compatible
-    if ( errorMsg.isEmpty() )
-    {
-        bool custDataAxis = true;
-        QString custDataName;
-        newSeriesIdx = 0;
-        for (const auto& bchSubset : std::as_const(newBchSubsets))
+        else
         {
-            // Ignore single point lines
-            if (bchSubset.idxs.size() < 2) {
-                qWarning() << "Not enough points to trace line for: " << bchSubset.name;
-                continue;
-            }
-            
-            // Update points
-            QXYSeries* oldSeries = (QXYSeries*)oldChartSeries[newSeriesIdx];
-            oldSeries->clear();
-            
-            double xFallback = 0.;
-            for (int idx : bchSubset.idxs)
-            {
-                QString xName = newBchResults.getParamName(mPlotParams.xType == PlotArgumentType,
-                                                           idx, mPlotParams.xIdx);
-                double xVal = BenchResults::getParamValue(xName, custDataName, custDataAxis, xFallback);
-                
-                // Add point
-                oldSeries->append(xVal, getYPlotValue(newBchResults.benchmarks[idx], mPlotParams.yType) * mCurrentTimeFactor);
-            }
-            ++newSeriesIdx;
+            QMessageBox::critical(this, "Chart reload", errorMsg);
+            return;
         }
     }
-    // Reset update if all benchmarks
-    else if (mAllIndexes)
-    {
-        saveConfig();
-        setupChart(newBchResults, mBenchIdxs, mPlotParams, false);
-        setupOptions(false);
-    }
-    else
-    {
-        QMessageBox::critical(this, "Chart reload", errorMsg);
-        return;
-    }
     
     // Update timestamp
     QDateTime today = QDateTime::currentDateTime();
@@ -0,0 +1,730 @@
+// Copyright 2019 Guillaume AUJAY. All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "result_cache.h"
+#include "result_parser.h"
+#include "plot_parameters.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QSaveFile>
+#include <QHash>
+#include <QMutex>
+
+#define CACHE_DEBUG false
+#include <QDebug>
+
+#include <cstring>
+
+/*
+ * Format (native endianness, every value aligned on its size):
+ *   header | source path | meta | context | benchmarks
+ * Strings as utf16 arrays, double vectors as raw arrays,
+ * so loading is mostly memory copies from the mapped file.
+ */
+static const char    cache_magic[8]   = {'J','O','M','T','B','C','H','\0'};
+static const quint32 cache_version    = 4;
+static const quint32 cache_endianness = 0x01020304;
+static const char*   cache_subfolder  = "cache/";
+static const char*   cache_suffix     = ".jbc";
+
+static const qint64  cache_disk_budget = qint64(512) << 20;  // bytes of cache files
+static const qint64  hash_chunk_size   = 1 << 20;
+
+static bool cache_enabled = true;
+static QString cache_folder;        // settings subfolder if empty
+static qint64 memory_budget = qint64(256) << 20;   // bytes
+
+struct CacheHeader {
+    char    magic[8];
+    quint32 version;
+    quint32 endianness;
+    qint64  sourceSize;
+    qint64  sourceMtime;
+    quint64 sourceHash;
+    quint64 bodySize;
+};
+
+
+//
+// Cache writer
+class CacheWriter
+{
+public:
+    QByteArray data;
+    
+    void align(int alignment)
+    {
+        while (data.size() % alignment != 0)
+            data.append('\0');
+    }
+    template<typename T>
+    void write(const T &value)
+    {
+        align(sizeof(T));
+        data.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+    void writeBool(bool value)
+    {
+        write<quint8>(value ? 1 : 0);
+    }
+    void writeString(const QString &str)
+    {
+        write<quint32>(static_cast<quint32>(str.size()));
+        align(sizeof(char16_t));
+        data.append(reinterpret_cast<const char*>(str.utf16()), str.size() * sizeof(char16_t));
+    }
+    void writeStringList(const QStringList &list)
+    {
+        write<quint32>(static_cast<quint32>(list.size()));
+        for (const auto& str : list)
+            writeString(str);
+    }
+    void writeDoubles(const QVector<double> &vec)
+    {
+        write<quint32>(static_cast<quint32>(vec.size()));
+        align(sizeof(double));
+        data.append(reinterpret_cast<const char*>(vec.constData()), vec.size() * sizeof(double));
+    }
+};
+
+//
+// Cache reader (bounds checked, on mapped memory)
+class CacheReader
+{
+public:
+    CacheReader(const char *data, qint64 size)
+        : mData(data), mSize(size) {}
+    
+    bool isValid() const { return mValid; }
+    
+    template<typename T>
+    T read()
+    {
+        T value = T();
+        const char *ptr = take(sizeof(T), sizeof(T));
+        if (ptr != nullptr)
+            std::memcpy(&value, ptr, sizeof(T));
+        return value;
+    }
+    bool readBool()
+    {
+        return read<quint8>() != 0;
+    }
+    QString readString()
+    {
+        quint32 size = read<quint32>();
+        const char *ptr = take(static_cast<qint64>(size) * sizeof(char16_t), sizeof(char16_t));
+        if (ptr == nullptr || size == 0)
+            return QString();
+        return QString::fromUtf16(reinterpret_cast<const char16_t*>(ptr), size);
+    }
+    QStringList readStringList()
+    {
+        QStringList list;
+        quint32 size = read<quint32>();
+        for (quint32 i = 0; mValid && i < size; ++i)
+            list.append( readString() );
+        return list;
+    }
+    QVector<double> readDoubles()
+    {
+        QVector<double> vec;
+        quint32 size = read<quint32>();
+        const char *ptr = take(static_cast<qint64>(size) * sizeof(double), sizeof(double));
+        if (ptr != nullptr && size > 0) {
+            vec.resize(size);
+            std::memcpy(vec.data(), ptr, size * sizeof(double));
+        }
+        return vec;
+    }
+    
+private:
+    const char* take(qint64 size, qint64 alignment)
+    {
+        qint64 pos = (mPos + alignment - 1) / alignment * alignment;
+        if (!mValid || size < 0 || pos + size > mSize) {
+            mValid = false;
+            return nullptr;
+        }
+        mPos = pos + size;
+        return mData + pos;
+    }
+    
+private:
+    const char *mData;
+    qint64 mSize;
+    qint64 mPos = 0;
+    bool mValid = true;
+};
+
+/**************************************************************************************************/
+
+static void writeResults(CacheWriter &writer, const BenchResults &bchResults)
+{
+    // Meta
+    const BenchMeta &meta = bchResults.meta;
+    writer.writeBool(meta.hasAggregate);
+    writer.writeBool(meta.onlyAggregate);
+    writer.writeBool(meta.hasCv);
+    writer.writeBool(meta.hasBytesSec);
+    writer.writeBool(meta.hasItemsSec);
+    writer.write<qint32>(meta.maxArguments);
+    writer.write<qint32>(meta.maxTemplates);
+    writer.writeString(meta.time_unit);
+    // User-defined aggregates (names, ids are process-wide)
+    QStringList aggregateNames;
+    QHash<int, qint32> aggregateIdxs;
+    for (int aggId : meta.customAggregates) {
+        aggregateIdxs.insert(aggId, aggregateNames.size());
+        aggregateNames.append( AggregateNames::name(aggId) );
+    }
+    writer.writeStringList(aggregateNames);
+    for (int aggId : meta.customAggregates)
+        writer.writeBool( meta.percentAggregates.contains(aggId) );
+    
+    // Context
+    const BenchContext &ctx = bchResults.context;
+    writer.writeString(ctx.date);
+    writer.writeString(ctx.host_name);
+    writer.writeString(ctx.executable);
+    writer.write<qint32>(ctx.num_cpus);
+    writer.write<qint32>(ctx.mhz_per_cpu);
+    writer.writeBool(ctx.cpu_scaling_enabled);
+    writer.writeString(ctx.build_type);
+    writer.write<quint32>(static_cast<quint32>(ctx.caches.size()));
+    for (const auto& cache : ctx.caches)
+    {
+        writer.writeString(cache.type);
+        writer.write<qint32>(cache.level);
+        writer.write<qint64>(cache.size);
+        writer.write<qint32>(cache.num_sharing);
+    }
+    
+    // Benchmarks
+    writer.write<quint32>(static_cast<quint32>(bchResults.benchmarks.size()));
+    for (const auto& bchData : bchResults.benchmarks)
+    {
+        writer.writeString(bchData.name);
+        writer.writeString(bchData.run_name);
+        writer.writeString(bchData.run_type);
+        writer.write<qint32>(bchData.repetitions);
+        writer.write<qint32>(bchData.repetition_index);
+        writer.write<qint32>(bchData.threads);
+        writer.write<qint32>(bchData.iterations);
+        writer.write<quint8>(bchData.time_unit);
+        writer.writeDoubles(bchData.real_time);
+        writer.writeDoubles(bchData.cpu_time);
+        writer.writeDoubles(bchData.kbytes_sec);
+        writer.writeDoubles(bchData.kitems_sec);
+        
+        // Aggregate (block only if allocated)
+        writer.writeBool(bchData.hasAggregate);
+        writer.writeBool(bchData.aggregate_block.constData() != nullptr);
+        if (bchData.aggregate_block.constData() != nullptr)
+        {
+            const BenchAggregate &agg = bchData.aggregates();
+            const double aggregates[24] = {
+                agg.min_real,    agg.min_cpu,    agg.min_kbytes,    agg.min_kitems,
+                agg.max_real,    agg.max_cpu,    agg.max_kbytes,    agg.max_kitems,
+                agg.mean_real,   agg.mean_cpu,   agg.mean_kbytes,   agg.mean_kitems,
+                agg.median_real, agg.median_cpu, agg.median_kbytes, agg.median_kitems,
+                agg.stddev_real, agg.stddev_cpu, agg.stddev_kbytes, agg.stddev_kitems,
+                agg.cv_real,     agg.cv_cpu,     agg.cv_kbytes,     agg.cv_kitems
+            };
+            for (double value : aggregates)
+                writer.write<double>(value);
+            
+            writer.write<quint32>(static_cast<quint32>(agg.custom.size()));
+            for (const auto& custom : agg.custom)
+            {
+                writer.write<qint32>(aggregateIdxs.value(custom.id, -1));
+                writer.write<double>(custom.real);
+                writer.write<double>(custom.cpu);
+                writer.write<double>(custom.kbytes);
+                writer.write<double>(custom.kitems);
+            }
+        }
+        
+        // Meta
+        writer.writeString(bchData.base_name);
+        writer.writeString(bchData.family);
+        writer.writeString(bchData.container);
+        writer.writeStringList(bchData.arguments);
+        writer.writeStringList(bchData.templates);
+        
+        // Default
+        writer.write<double>(bchData.real_time_us);
+        writer.write<double>(bchData.cpu_time_us);
+        writer.write<double>(bchData.kbytes_sec_dflt);
+        writer.write<double>(bchData.kitems_sec_dflt);
+    }
+}
+
+static bool readResults(CacheReader &reader, BenchResults &bchResults)
+{
+    // Meta
+    BenchMeta &meta = bchResults.meta;
+    meta.hasAggregate  = reader.readBool();
+    meta.onlyAggregate = reader.readBool();
+    meta.hasCv         = reader.readBool();
+    meta.hasBytesSec   = reader.readBool();
+    meta.hasItemsSec   = reader.readBool();
+    meta.maxArguments  = reader.read<qint32>();
+    meta.maxTemplates  = reader.read<qint32>();
+    meta.time_unit     = reader.readString();
+    for (const auto& name : reader.readStringList())
+        meta.customAggregates.append( AggregateNames::id(name) );
+    for (int aggId : std::as_const(meta.customAggregates))
+        if ( reader.readBool() )
+            meta.percentAggregates.append(aggId);
+    
+    // Context
+    BenchContext &ctx = bchResults.context;
+    ctx.date        = reader.readString();
+    ctx.host_name   = reader.readString();
+    ctx.executable  = reader.readString();
+    ctx.num_cpus    = reader.read<qint32>();
+    ctx.mhz_per_cpu = reader.read<qint32>();
+    ctx.cpu_scaling_enabled = reader.readBool();
+    ctx.build_type  = reader.readString();
+    quint32 cacheCount = reader.read<quint32>();
+    for (quint32 i = 0; reader.isValid() && i < cacheCount; ++i)
+    {
+        BenchCache cache;
+        cache.type        = reader.readString();
+        cache.level       = reader.read<qint32>();
+        cache.size        = reader.read<qint64>();
+        cache.num_sharing = reader.read<qint32>();
+        ctx.caches.append(cache);
+    }
+    
+    // Benchmarks
+    quint32 bchCount = reader.read<quint32>();
+    if ( reader.isValid() )
+        bchResults.benchmarks.reserve(bchCount);
+    for (quint32 i = 0; reader.isValid() && i < bchCount; ++i)
+    {
+        BenchData bchData;
+        bchData.name             = reader.readString();
+        bchData.run_name         = reader.readString();
+        bchData.run_type         = reader.readString();
+        bchData.repetitions      = reader.read<qint32>();
+        bchData.repetition_index = reader.read<qint32>();
+        bchData.threads          = reader.read<qint32>();
+        bchData.iterations       = reader.read<qint32>();
+        quint8 timeUnit          = reader.read<quint8>();
+        if (timeUnit > SecondUnit)
+            return false;
+        bchData.time_unit        = static_cast<BenchTimeUnit>(timeUnit);
+        bchData.real_time        = reader.readDoubles();
+        bchData.cpu_time         = reader.readDoubles();
+        bchData.kbytes_sec       = reader.readDoubles();
+        bchData.kitems_sec       = reader.readDoubles();
+        
+        // Aggregate (block only if allocated)
+        bchData.hasAggregate = reader.readBool();
+        if ( reader.readBool() )
+        {
+            BenchAggregate &agg = bchData.editAggregates();
+            double* aggregates[24] = {
+                &agg.min_real,    &agg.min_cpu,    &agg.min_kbytes,    &agg.min_kitems,
+                &agg.max_real,    &agg.max_cpu,    &agg.max_kbytes,    &agg.max_kitems,
+                &agg.mean_real,   &agg.mean_cpu,   &agg.mean_kbytes,   &agg.mean_kitems,
+                &agg.median_real, &agg.median_cpu, &agg.median_kbytes, &agg.median_kitems,
+                &agg.stddev_real, &agg.stddev_cpu, &agg.stddev_kbytes, &agg.stddev_kitems,
+                &agg.cv_real,     &agg.cv_cpu,     &agg.cv_kbytes,     &agg.cv_kitems
+            };
+            for (double *value : aggregates)
+                *value = reader.read<double>();
+            
+            quint32 customCount = reader.read<quint32>();
+            for (quint32 c = 0; reader.isValid() && c < customCount; ++c)
+            {
+                qint32 aggIdx = reader.read<qint32>();
+                if (aggIdx < 0 || aggIdx >= meta.customAggregates.size())
+                    return false;
+                BenchCustomAggregate custom;
+                custom.id     = meta.customAggregates[aggIdx];
+                custom.real   = reader.read<double>();
+                custom.cpu    = reader.read<double>();
+                custom.kbytes = reader.read<double>();
+                custom.kitems = reader.read<double>();
+                agg.custom.append(custom);
+            }
+        }
+        
+        // Meta
+        bchData.base_name = reader.readString();
+        bchData.family    = reader.readString();
+        bchData.container = reader.readString();
+        bchData.arguments = reader.readStringList();
+        bchData.templates = reader.readStringList();
+        
+        // Default
+        bchData.real_time_us    = reader.read<double>();
+        bchData.cpu_time_us     = reader.read<double>();
+        bchData.kbytes_sec_dflt = reader.read<double>();
+        bchData.kitems_sec_dflt = reader.read<double>();
+        
+        bchResults.benchmarks.append(bchData);
+    }
+    ++bchResults.revision;
+    
+    return reader.isValid();
+}
+
+/**************************************************************************************************/
+
+// Cache file header matching source
+static bool isHeaderValid(const CacheHeader &header, const FileFingerprint &source, qint64 cacheSize)
+{
+    return std::memcmp(header.magic, cache_magic, sizeof(cache_magic)) == 0
+            && header.version == cache_version && header.endianness == cache_endianness
+            && header.sourceSize == source.size && header.sourceMtime == source.mtime
+            && header.sourceHash == source.hash
+            && header.bodySize == static_cast<quint64>(cacheSize - sizeof(CacheHeader));
+}
+
+// Cache file already up to date for source (header only)
+static bool isCacheFileValid(const QString &cacheFilePath, const FileFingerprint &source)
+{
+    QFile cacheFile(cacheFilePath);
+    if ( !cacheFile.open(QIODevice::ReadOnly) )
+        return false;
+    
+    CacheHeader header;
+    if (cacheFile.read(reinterpret_cast<char*>(&header), sizeof(CacheHeader)) != sizeof(CacheHeader))
+        return false;
+    return isHeaderValid(header, source, cacheFile.size());
+}
+
+// Least recently used cache files removed until under disk budget (except just saved one)
+static void pruneCacheFolder(const QString &keepPath)
+{
+    QDir cacheDir( QFileInfo(keepPath).absolutePath() );
+    const QFileInfoList cacheFiles = cacheDir.entryInfoList(QStringList("*" + QString(cache_suffix)),
+                                                            QDir::Files, QDir::Time);   // newest first
+    qint64 usedBytes = 0;
+    for (const auto& fileInfo : cacheFiles)
+    {
+        usedBytes += fileInfo.size();
+        if (usedBytes > cache_disk_budget && fileInfo.absoluteFilePath() != QFileInfo(keepPath).absoluteFilePath())
+        {
+            if (CACHE_DEBUG) qDebug() << "Results cache pruned:" << fileInfo.fileName();
+            usedBytes -= fileInfo.size();
+            QFile::remove( fileInfo.absoluteFilePath() );
+        }
+    }
+}
+
+/**************************************************************************************************/
+
+//
+// In-process cache (last results of each source file, least recently used evicted first)
+struct MemoryEntry {
+    FileFingerprint source;
+    BenchResults bchResults;    // implicitly shared with loaded copies
+    qint64 bytes = 0;
+    quint64 lastUse = 0;
+};
+
+static QMutex memory_mutex;
+static QHash<QString, MemoryEntry> memory_entries;  // by source path
+static qint64 memory_used = 0;
+static quint64 memory_clock = 0;
+
+// Heap usage of results (from capacities, pooled strings counted once)
+static qint64 estimateSize(const BenchResults &bchResults)
+{
+    return static_cast<qint64>(sizeof(BenchResults)) + bchResults.memorySize();
+}
+
+// Oldest entries removed until under budget (locked)
+static void evictMemory(qint64 budget)
+{
+    while (memory_used > budget && !memory_entries.isEmpty())
+    {
+        auto oldest = memory_entries.begin();
+        for (auto it = memory_entries.begin(); it != memory_entries.end(); ++it)
+            if (it->lastUse < oldest->lastUse)
+                oldest = it;
+        
+        if (CACHE_DEBUG) qDebug() << "Results evicted from memory:" << oldest->source.path;
+        memory_used -= oldest->bytes;
+        memory_entries.erase(oldest);
+    }
+}
+
+static bool loadFromMemory(const FileFingerprint &source, BenchResults &bchResults)
+{
+    QMutexLocker locker(&memory_mutex);
+    auto it = memory_entries.find(source.path);
+    if (it == memory_entries.end())
+        return false;
+    
+    const FileFingerprint &cached = it->source;
+    if (cached.size != source.size || cached.mtime != source.mtime || cached.hash != source.hash)
+        return false;
+    it->lastUse = ++memory_clock;
+    bchResults = it->bchResults;
+    
+    return true;
+}
+
+static void saveToMemory(const FileFingerprint &source, const BenchResults &bchResults)
+{
+    qint64 bytes = estimateSize(bchResults);
+    
+    QMutexLocker locker(&memory_mutex);
+    // Previous results of source file outdated
+    auto it = memory_entries.find(source.path);
+    if (it != memory_entries.end()) {
+        memory_used -= it->bytes;
+        memory_entries.erase(it);
+    }
+    if (bytes > memory_budget)
+        return;
+    
+    memory_entries.insert(source.path, {source, bchResults, bytes, ++memory_clock});
+    memory_used += bytes;
+    evictMemory(memory_budget);
+}
+
+/**************************************************************************************************/
+
+void ResultCache::setEnabled(bool enabled)
+{
+    cache_enabled = enabled;
+}
+
+bool ResultCache::isEnabled()
+{
+    return cache_enabled;
+}
+
+void ResultCache::setFolder(const QString &folder)
+{
+    cache_folder = folder.isEmpty() || folder.endsWith("/") ? folder : folder + "/";
+}
+
+QString ResultCache::folder()
+{
+    return !cache_folder.isEmpty() ? cache_folder : QString(config_folder) + cache_subfolder;
+}
+
+void ResultCache::setMemoryBudget(qint64 bytes)
+{
+    QMutexLocker locker(&memory_mutex);
+    memory_budget = qMax<qint64>(bytes, 0);
+    evictMemory(memory_budget);
+}
+
+qint64 ResultCache::memoryBudget()
+{
+    QMutexLocker locker(&memory_mutex);
+    return memory_budget;
+}
+
+FileFingerprint ResultCache::fingerprint(QFile &file, ParseProgress *progress)
+{
+    QFileInfo fileInfo(file);
+    FileFingerprint print;
+    print.path  = fileInfo.absoluteFilePath();
+    print.size  = fileInfo.size();
+    print.mtime = fileInfo.lastModified().toMSecsSinceEpoch();
+    
+    // Content hash by chunks, up to size when opened
+    // (never mapped, source may be truncated while hashed)
+    if (progress != nullptr)
+        progress->addTotal(print.size);
+    file.seek(0);
+    quint64 hash = 0;
+    QByteArray chunk(hash_chunk_size, Qt::Uninitialized);
+    for (qint64 left = print.size; left > 0; )
+    {
+        if (progress != nullptr && progress->isCanceled())
+            return FileFingerprint();
+        
+        qint64 read = file.read(chunk.data(), qMin(left, hash_chunk_size));
+        if (read <= 0)
+            return FileFingerprint();
+        hash = hashBytes(chunk.constData(), read, hash);
+        left -= read;
+        if (progress != nullptr)
+            progress->addParsed(read);
+    }
+    print.hash = hash;
+    file.seek(0);
+    
+    return print;
+}
+
+bool ResultCache::load(const FileFingerprint &source, BenchResults &bchResults)
+{
+    if (!cache_enabled || !source.isValid())
+        return false;
+    
+    // Parsed or loaded in this process
+    if ( loadFromMemory(source, bchResults) ) {
+        if (CACHE_DEBUG) qDebug() << "Results loaded from memory:" << source.path;
+        return true;
+    }
+    
+    // Cache file
+    QFile cacheFile( cachePath(source.path) );
+    if ( !cacheFile.exists() || !cacheFile.open(QIODevice::ReadOnly) )
+        return false;
+    
+    qint64 cacheSize = cacheFile.size();
+    if (cacheSize < static_cast<qint64>(sizeof(CacheHeader)))
+        return false;
+    const char *cacheData = reinterpret_cast<const char*>( cacheFile.map(0, cacheSize) );
+    QByteArray cacheCopy;
+    if (cacheData == nullptr) {
+        cacheCopy = cacheFile.readAll();
+        cacheData = cacheCopy.constData();
+    }
+    
+    // Check source
+    CacheHeader header;
+    std::memcpy(&header, cacheData, sizeof(CacheHeader));
+    if ( !isHeaderValid(header, source, cacheSize) )
+    {
+        if (CACHE_DEBUG) qDebug() << "Outdated cache for:" << source.path;
+        return false;
+    }
+    CacheReader reader(cacheData + sizeof(CacheHeader), cacheSize - sizeof(CacheHeader));
+    if (reader.readString() != source.path)
+        return false;
+    
+    // Load
+    BenchResults cachedResults;
+    if ( !readResults(reader, cachedResults) ) {
+        qWarning() << "Invalid results cache:" << cacheFile.fileName();
+        return false;
+    }
+    cachedResults.internStrings();   // derived, not cached
+    cachedResults.updateDerived();
+    saveToMemory(source, cachedResults);
+    bchResults = cachedResults;
+    if (CACHE_DEBUG) qDebug() << "Results loaded from cache:" << source.path;
+    
+    // Recently used (kept when pruning)
+    cacheFile.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+    
+    return true;
+}
+
+bool ResultCache::save(const FileFingerprint &source, const BenchResults &bchResults)
+{
+    if (!cache_enabled || !source.isValid())
+        return false;
+    saveToMemory(source, bchResults);
+    
+    // Already cached (e.g. by another window)
+    QString cacheFilePath = cachePath(source.path);
+    if ( isCacheFileValid(cacheFilePath, source) ) {
+        if (CACHE_DEBUG) qDebug() << "Results cache up to date:" << cacheFilePath;
+        return true;
+    }
+    QDir().mkpath( QFileInfo(cacheFilePath).absolutePath() );
+    
+    CacheWriter writer;
+    writer.writeString(source.path);
+    writeResults(writer, bchResults);
+    
+    CacheHeader header;
+    std::memcpy(header.magic, cache_magic, sizeof(cache_magic));
+    header.version     = cache_version;
+    header.endianness  = cache_endianness;
+    header.sourceSize  = source.size;
+    header.sourceMtime = source.mtime;
+    header.sourceHash  = source.hash;
+    header.bodySize    = writer.data.size();
+    
+    // Atomic write
+    QSaveFile cacheFile(cacheFilePath);
+    if ( !cacheFile.open(QIODevice::WriteOnly) ) {
+        qWarning() << "Couldn't write results cache:" << cacheFilePath;
+        return false;
+    }
+    cacheFile.write(reinterpret_cast<const char*>(&header), sizeof(CacheHeader));
+    cacheFile.write(writer.data);
+    if ( !cacheFile.commit() ) {
+        qWarning() << "Couldn't write results cache:" << cacheFilePath;
+        return false;
+    }
+    if (CACHE_DEBUG) qDebug() << "Results cache saved:" << cacheFilePath;
+    pruneCacheFolder(cacheFilePath);
+    
+    return true;
+}
+
+QString ResultCache::cachePath(const QString &sourcePath)
+{
+    QByteArray path = QFileInfo(sourcePath).absoluteFilePath().toUtf8();
+    quint64 pathHash = hashBytes(path.constData(), path.size());
+    
+    return folder() + QString::number(pathHash, 16) + cache_suffix;
+}
+
+/**************************************************************************************************/
+
+static inline quint64 rotl64(quint64 x, int r)
+{
+    return (x << r) | (x >> (64 - r));
+}
+
+static inline quint64 read64(const char *p)
+{
+    quint64 v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+quint64 ResultCache::hashBytes(const char *data, qint64 size, quint64 seed)
+{
+    const quint64 prime1 = 0x9E3779B185EBCA87ULL;
+    const quint64 prime2 = 0xC2B2AE3D27D4EB4FULL;
+    
+    // 4 independent lanes of 8 bytes
+    quint64 h[4] = { seed + prime1, seed ^ prime2, seed - prime1, seed + prime2 };
+    qint64 pos = 0;
+    for (; pos + 32 <= size; pos += 32)
+    {
+        for (int i = 0; i < 4; ++i)
+            h[i] = rotl64(h[i] + read64(data + pos + 8*i) * prime2, 31) * prime1;
+    }
+    quint64 hash = rotl64(h[0], 1) + rotl64(h[1], 7) + rotl64(h[2], 12) + rotl64(h[3], 18);
+    hash += static_cast<quint64>(size);
+    
+    // Remaining bytes
+    for (; pos + 8 <= size; pos += 8)
+        hash = rotl64(hash ^ (read64(data + pos) * prime2), 27) * prime1;
+    for (; pos < size; ++pos)
+        hash = rotl64(hash ^ (static_cast<uchar>(data[pos]) * prime1), 11) * prime2;
+    
+    // Final mix
+    hash ^= hash >> 33;
+    hash *= prime2;
+    hash ^= hash >> 29;
+    hash *= prime1;
+    hash ^= hash >> 32;
+    
+    return hash;
+}
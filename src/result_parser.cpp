@@ -14,27 +14,25 @@
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "result_parser.h"
+#include "json_reader.h"
+#include "result_cache.h"
 
 #include <QFile>
-#include <QJsonDocument>
-#include <QJsonObject>
-#include <QJsonArray>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QHash>
+#include <QScopedPointer>
+#include <QtConcurrent>
 
 #define PARSE_DEBUG false
-#if PARSE_DEBUG
-  #include <QDebug>
-#endif
+#include <QDebug>
 
+#include <cmath>
+#include <limits>
+
+// Parsed bytes between progress updates
+static const qint64 progress_step = 1 << 20;
 
-// Find benchmark index by name
-static int findExistingBenchmark(const BenchResults &bchResults, const QString &run_name)
-{
-    int idx = -1;
-    for (int i=0; idx<0 && i<bchResults.benchmarks.size(); ++i)
-        if (bchResults.benchmarks[i].run_name == run_name) idx = i;
-    
-    return idx;
-}
 
 // Remove aggregate suffix if any
 static void cleanupName(BenchData &bchData)
@@ -55,121 +53,202 @@ static void cleanupName(BenchData &bchData)
     }
 }
 
+// Integer conversion (same as QJsonValue::toInt)
+static int toInt(double value, int defaultValue = 0)
+{
+    if (value >= std::numeric_limits<int>::min() && value <= std::numeric_limits<int>::max()
+            && std::floor(value) == value)
+        return static_cast<int>(value);
+    return defaultValue;
+}
 
-// Parse benchmark results from json file
-BenchResults ResultParser::parseJsonFile(const QString &filename, QString& errorMsg)
+/**************************************************************************************************/
+
+// Raw utf8 string, decoded on demand
+// (view on input memory when stable, own copy otherwise)
+struct RawString
 {
-    BenchResults bchResults;
+    QByteArrayView view;
+    QByteArray copy;
     
-    // Read file
-    QFile benchFile(filename);
-    if ( !benchFile.open(QIODevice::ReadOnly) ) {
-        errorMsg = "Couldn't open benchmark results file.";
-        return bchResults;
+    void set(const JsonReader &reader)
+    {
+        if ( reader.isValueStable() )
+            view = reader.valueView();
+        else {
+            copy = reader.valueView().toByteArray();
+            view = QByteArrayView(copy.constData(), copy.size());
+        }
     }
-    QByteArray benchData = benchFile.readAll();
-    benchFile.close();
-    
-    // Get Json main object
-    QJsonDocument benchDoc( QJsonDocument::fromJson(benchData) );
-    if (!benchDoc.isObject()) {
-        errorMsg = "Not a json benchmark results file.";
-        return bchResults;
+    QString toString() const { return QString::fromUtf8(view); }
+};
+
+/**************************************************************************************************/
+
+// Read value of current field (skipped if type mismatch)
+static bool nextString(JsonReader &reader, RawString &value)
+{
+    if (reader.readNext() == JsonReader::String) {
+        value.set(reader);
+        return true;
     }
-    QJsonObject benchObj = benchDoc.object();
-    if (benchObj.isEmpty()) {
-        errorMsg = "Empty json benchmark results file.";
-        return bchResults;
+    reader.skipCurrent();
+    return false;
+}
+
+static bool nextString(JsonReader &reader, QString &value)
+{
+    if (reader.readNext() == JsonReader::String) {
+        value = reader.stringValue();
+        return true;
+    }
+    reader.skipCurrent();
+    return false;
+}
+
+static bool nextNumber(JsonReader &reader, double &value)
+{
+    if (reader.readNext() == JsonReader::Number) {
+        bool ok = false;
+        value = reader.numberValue(&ok);
+        return ok;
+    }
+    reader.skipCurrent();
+    return false;
+}
+
+static bool nextBool(JsonReader &reader, bool &value)
+{
+    if (reader.readNext() == JsonReader::Bool) {
+        value = reader.boolValue();
+        return true;
+    }
+    reader.skipCurrent();
+    return false;
+}
+
+/**************************************************************************************************/
+
+// Parse cache object
+static bool parseCache(JsonReader &reader, BenchCache &bchCache)
+{
+    if (PARSE_DEBUG) qDebug() << "Context cache";
+    
+    double value;
+    while (reader.readNext() == JsonReader::Name)
+    {
+        // Meta
+        if (reader.isName("type"))
+        {
+            if ( nextString(reader, bchCache.type) )
+                if (PARSE_DEBUG) qDebug() << "-> type:" << bchCache.type;
+        }
+        else if (reader.isName("level"))
+        {
+            if ( nextNumber(reader, value) ) {
+                bchCache.level = toInt(value);
+                if (PARSE_DEBUG) qDebug() << "-> level:" << bchCache.level;
+            }
+        }
+        else if (reader.isName("size"))
+        {
+            if ( nextNumber(reader, value) ) {
+                bchCache.size = static_cast<int64_t>(value);
+                if (PARSE_DEBUG) qDebug() << "-> size:" << bchCache.size;
+            }
+        }
+        else if (reader.isName("num_sharing"))
+        {
+            if ( nextNumber(reader, value) ) {
+                bchCache.num_sharing = toInt(value);
+                if (PARSE_DEBUG) qDebug() << "-> num_sharing:" << bchCache.num_sharing;
+            }
+        }
+        else
+            reader.skipValue();
     }
     
+    return reader.token() == JsonReader::EndObject;
+}
+
+// Parse context object
+static bool parseContext(JsonReader &reader, BenchResults &bchResults)
+{
+    QString build_type;
+    bool hasLibraryBuildType = false;
     
-    /*
-     * Context
-     */
-    if (benchObj.contains("context") && benchObj["context"].isObject())
+    double value;
+    while (reader.readNext() == JsonReader::Name)
     {
-        QJsonObject ctxObj = benchObj["context"].toObject();
-        
         // Meta
-        if (ctxObj.contains("date") && ctxObj["date"].isString())
+        if (reader.isName("date"))
         {
-            bchResults.context.date = ctxObj["date"].toString();
-            if (PARSE_DEBUG) qDebug() << "date: " << bchResults.context.date;
+            if ( nextString(reader, bchResults.context.date) )
+                if (PARSE_DEBUG) qDebug() << "date: " << bchResults.context.date;
         }
-        if (ctxObj.contains("host_name") && ctxObj["host_name"].isString())
+        else if (reader.isName("host_name"))
         {
-            bchResults.context.host_name = ctxObj["host_name"].toString();
-            if (PARSE_DEBUG) qDebug() << "host_name: " << bchResults.context.host_name;
+            if ( nextString(reader, bchResults.context.host_name) )
+                if (PARSE_DEBUG) qDebug() << "host_name: " << bchResults.context.host_name;
         }
-        if (ctxObj.contains("executable") && ctxObj["executable"].isString())
+        else if (reader.isName("executable"))
         {
-            bchResults.context.executable = ctxObj["executable"].toString();
-            if (PARSE_DEBUG) qDebug() << "executable: " << bchResults.context.executable;
+            if ( nextString(reader, bchResults.context.executable) )
+                if (PARSE_DEBUG) qDebug() << "executable: " << bchResults.context.executable;
         }
-        
         // Build
-        if (ctxObj.contains("library_build_type") && ctxObj["library_build_type"].isString())
+        else if (reader.isName("library_build_type"))
         {
-            bchResults.context.build_type = ctxObj["library_build_type"].toString();
-            if (PARSE_DEBUG) qDebug() << "library_build_type: " << bchResults.context.build_type;
+            if ( nextString(reader, bchResults.context.build_type) ) {
+                hasLibraryBuildType = true;
+                if (PARSE_DEBUG) qDebug() << "library_build_type: " << bchResults.context.build_type;
+            }
         }
-        else if (ctxObj.contains("build_type") && ctxObj["build_type"].isString())
+        else if (reader.isName("build_type"))
         {
-            bchResults.context.build_type = ctxObj["build_type"].toString();
-            if (PARSE_DEBUG) qDebug() << "build_type: " << bchResults.context.build_type;
+            if ( nextString(reader, build_type) )
+                if (PARSE_DEBUG) qDebug() << "build_type: " << build_type;
         }
-        
         // CPU
-        if (ctxObj.contains("num_cpus") && ctxObj["num_cpus"].isDouble())
+        else if (reader.isName("num_cpus"))
         {
-            bchResults.context.num_cpus = ctxObj["num_cpus"].toInt();
-            if (PARSE_DEBUG) qDebug() << "num_cpus: " << bchResults.context.num_cpus;
+            if ( nextNumber(reader, value) ) {
+                bchResults.context.num_cpus = toInt(value);
+                if (PARSE_DEBUG) qDebug() << "num_cpus: " << bchResults.context.num_cpus;
+            }
         }
-        if (ctxObj.contains("mhz_per_cpu") && ctxObj["mhz_per_cpu"].isDouble())
+        else if (reader.isName("mhz_per_cpu"))
         {
-            bchResults.context.mhz_per_cpu = ctxObj["mhz_per_cpu"].toInt();
-            if (PARSE_DEBUG) qDebug() << "mhz_per_cpu: " << bchResults.context.mhz_per_cpu;
+            if ( nextNumber(reader, value) ) {
+                bchResults.context.mhz_per_cpu = toInt(value);
+                if (PARSE_DEBUG) qDebug() << "mhz_per_cpu: " << bchResults.context.mhz_per_cpu;
+            }
         }
-        if (ctxObj.contains("cpu_scaling_enabled") && ctxObj["cpu_scaling_enabled"].isBool())
+        else if (reader.isName("cpu_scaling_enabled"))
         {
-            bchResults.context.cpu_scaling_enabled = ctxObj["cpu_scaling_enabled"].toBool();
-            if (PARSE_DEBUG) qDebug() << "cpu_scaling_enabled: " << bchResults.context.cpu_scaling_enabled;
+            if ( nextBool(reader, bchResults.context.cpu_scaling_enabled) )
+                if (PARSE_DEBUG) qDebug() << "cpu_scaling_enabled: " << bchResults.context.cpu_scaling_enabled;
         }
-        
         // Caches
-        if (ctxObj.contains("caches") && ctxObj["caches"].isArray())
+        else if (reader.isName("caches"))
         {
-            QJsonArray cchArray = ctxObj["caches"].toArray();
-            bchResults.context.caches.reserve( cchArray.size() );
-            
-            for (int cchIdx = 0; cchIdx < cchArray.size(); ++cchIdx)
+            if (reader.readNext() != JsonReader::BeginArray) {
+                reader.skipCurrent();
+                continue;
+            }
+            while (reader.readNext() != JsonReader::EndArray)
             {
+                if (reader.token() == JsonReader::Invalid)
+                    return false;
+                
                 // Cache
-                QJsonObject cchObj = cchArray[cchIdx].toObject();
                 BenchCache bchCache;
-                if (PARSE_DEBUG) qDebug() << "Context cache";
-                
-                // Meta
-                if (cchObj.contains("type") && cchObj["type"].isString())
-                {
-                    bchCache.type = cchObj["type"].toString();
-                    if (PARSE_DEBUG) qDebug() << "-> type:" << bchCache.type;
-                }
-                if (cchObj.contains("level") && cchObj["level"].isDouble())
-                {
-                    bchCache.level = cchObj["level"].toInt();
-                    if (PARSE_DEBUG) qDebug() << "-> level:" << bchCache.level;
-                }
-                if (cchObj.contains("size") && cchObj["size"].isDouble())
-                {
-                    bchCache.size = static_cast<int64_t>( cchObj["size"].toDouble() );
-                    if (PARSE_DEBUG) qDebug() << "-> size:" << bchCache.size;
-                }
-                if (cchObj.contains("num_sharing") && cchObj["num_sharing"].isDouble())
-                {
-                    bchCache.num_sharing = cchObj["num_sharing"].toInt();
-                   if (PARSE_DEBUG)  qDebug() << "-> num_sharing:" << bchCache.num_sharing;
+                if (reader.token() == JsonReader::BeginObject) {
+                    if ( !parseCache(reader, bchCache) )
+                        return false;
                 }
+                else if ( !reader.skipCurrent() )
+                    return false;
                 
                 //
                 // Push bench cache
@@ -179,482 +258,717 @@ BenchResults ResultParser::parseJsonFile(const QString &filename, QString& error
                 if (PARSE_DEBUG) qDebug() << "";
             }
         }
+        else
+            reader.skipValue();
     }
-    else
-        qCritical() << "Results parsing: missing field 'context'";
+    // Fallback build type
+    if (!hasLibraryBuildType && !build_type.isEmpty())
+        bchResults.context.build_type = build_type;
     
-    // New line between context and benchmarks
-    if (PARSE_DEBUG) qDebug() << "";
+    return reader.token() == JsonReader::EndObject;
+}
+
+/**************************************************************************************************/
+
+// Raw benchmark fields
+struct BenchEntry
+{
+    RawString name, run_name, run_type, aggregate_name, aggregate_unit, time_unit;
+    double iterations = 0., real_time = 0., cpu_time = 0.;
+    double bytes_per_second = 0., items_per_second = 0.;
+    double repetitions = 0., repetition_index = 0., threads = 0.;
+    
+    bool hasName = false, hasRunName = false, hasRunType = false, hasAggregateName = false, hasAggregateUnit = false;
+    bool hasTimeUnit = false;
+    bool hasIterations = false, hasRealTime = false, hasCpuTime = false;
+    bool hasBytesSec = false, hasItemsSec = false;
+    bool hasRepetitions = false, hasRepetitionIndex = false, hasThreads = false;
+};
+
+// Parse benchmark object
+static bool parseBenchEntry(JsonReader &reader, BenchEntry &entry)
+{
+    while (reader.readNext() == JsonReader::Name)
+    {
+        if      (reader.isName("name"))             entry.hasName            = nextString(reader, entry.name);
+        else if (reader.isName("run_name"))         entry.hasRunName         = nextString(reader, entry.run_name);
+        else if (reader.isName("run_type"))         entry.hasRunType         = nextString(reader, entry.run_type);
+        else if (reader.isName("aggregate_name"))   entry.hasAggregateName   = nextString(reader, entry.aggregate_name);
+        else if (reader.isName("aggregate_unit"))   entry.hasAggregateUnit   = nextString(reader, entry.aggregate_unit);
+        else if (reader.isName("time_unit"))        entry.hasTimeUnit        = nextString(reader, entry.time_unit);
+        else if (reader.isName("iterations"))       entry.hasIterations      = nextNumber(reader, entry.iterations);
+        else if (reader.isName("real_time"))        entry.hasRealTime        = nextNumber(reader, entry.real_time);
+        else if (reader.isName("cpu_time"))         entry.hasCpuTime         = nextNumber(reader, entry.cpu_time);
+        else if (reader.isName("bytes_per_second")) entry.hasBytesSec        = nextNumber(reader, entry.bytes_per_second);
+        else if (reader.isName("items_per_second")) entry.hasItemsSec        = nextNumber(reader, entry.items_per_second);
+        else if (reader.isName("repetitions"))      entry.hasRepetitions     = nextNumber(reader, entry.repetitions);
+        else if (reader.isName("repetition_index")) entry.hasRepetitionIndex = nextNumber(reader, entry.repetition_index);
+        else if (reader.isName("threads"))          entry.hasThreads         = nextNumber(reader, entry.threads);
+        else
+            reader.skipValue();
+    }
+    
+    return reader.token() == JsonReader::EndObject;
+}
+
+// Store user-defined aggregate (e.g. p90/p99 from ComputeStatistics)
+// Values in percent if aggregate unit is percentage (like cv), durations otherwise
+static void setCustomAggregate(BenchMeta &meta, BenchAggregate &agg, const QString &aggregate_name,
+                               const BenchEntry &entry, const BenchData &bchData)
+{
+    bool isPercent = entry.hasAggregateUnit && entry.aggregate_unit.view == "percentage";
+    
+    BenchCustomAggregate value;
+    value.id = AggregateNames::id(aggregate_name);
+    if (isPercent) {
+        value.real   = bchData.real_time.back() * 100;
+        value.cpu    = bchData.cpu_time.back()  * 100;
+        value.kbytes = !bchData.kbytes_sec.isEmpty() ? bchData.kbytes_sec_dflt * 100 : 0.;
+        value.kitems = !bchData.kitems_sec.isEmpty() ? bchData.kitems_sec_dflt * 100 : 0.;
+    }
+    else {
+        value.real   = bchData.real_time_us;
+        value.cpu    = bchData.cpu_time_us;
+        value.kbytes = !bchData.kbytes_sec.isEmpty() ? bchData.kbytes_sec_dflt : 0.;
+        value.kitems = !bchData.kitems_sec.isEmpty() ? bchData.kitems_sec_dflt : 0.;
+    }
+    agg.setCustom(value);
+    
+    if ( !meta.customAggregates.contains(value.id) )
+        meta.customAggregates.append(value.id);
+    if ( isPercent && !meta.percentAggregates.contains(value.id) )
+        meta.percentAggregates.append(value.id);
+    if (PARSE_DEBUG) qDebug() << "-> custom aggregate:" << aggregate_name << "| id:" << value.id
+                              << "| percent:" << isPercent;
+}
+
+// Add parsed benchmark to results (new or merged into existing one)
+// Returns index of added/changed benchmark (-1 if ignored)
+static int addBenchmark(BenchResults &bchResults, BenchIndex &bchIndex, const BenchEntry &entry)
+{
+    BenchData bchData;
+    
+    //
+    // Name
+    if (entry.hasName)
+    {
+        bchData.name = bchResults.strings.intern(entry.name.view);
+        if (PARSE_DEBUG) qDebug() << "bench name:" << bchData.name;
+    }
+    else {
+        qCritical() << "Results parsing: missing benchmark field 'name'";
+        return -1;
+    }
+    // Run name
+    if (entry.hasRunName)
+    {
+        bchData.run_name = bchResults.strings.intern(entry.run_name.view);
+        if (PARSE_DEBUG) qDebug() << "-> run_name:" << bchData.run_name;
+    }
+    else {
+        bchData.run_name = bchData.name;
+        if (PARSE_DEBUG) qDebug() << "-> name as run_name:" << bchData.run_name;
+    }
+    cleanupName(bchData);
+    // Run type
+    if (entry.hasRunType)
+    {
+        bchData.run_type = bchResults.strings.intern(entry.run_type.view);
+        if (PARSE_DEBUG) qDebug() << "-> run_type:" << bchData.run_type;
+    }
+    else {
+        bchData.run_type = "iteration";
+        if (PARSE_DEBUG) qDebug() << "-> default run_type:" << bchData.run_type;
+    }
+    
+    //
+    // Timing
+    if (entry.hasIterations)
+    {
+        bchData.iterations = toInt(entry.iterations);
+        if (PARSE_DEBUG) qDebug() << "-> iterations:" << bchData.iterations;
+    }
+    else {
+        qCritical() << "Results parsing: missing benchmark field 'iterations'";
+        return -1;
+    }
+    
+    if (entry.hasRealTime)
+    {
+        bchData.real_time.append( entry.real_time );
+        if (PARSE_DEBUG) qDebug() << "-> real_time:" << bchData.real_time.back();
+    }
+    else {
+        qCritical() << "Results parsing: missing benchmark field 'real_time'";
+        return -1;
+    }
+    
+    if (entry.hasCpuTime)
+    {
+        bchData.cpu_time.append( entry.cpu_time );
+        if (PARSE_DEBUG) qDebug() << "-> cpu_time:" << bchData.cpu_time.back();
+    }
+    else {
+        qCritical() << "Results parsing: missing benchmark field 'cpu_time'";
+        return -1;
+    }
+    
+    if (entry.hasTimeUnit)
+    {
+        bchData.time_unit = toTimeUnit(entry.time_unit.view);
+        if (PARSE_DEBUG) qDebug() << "-> time_unit:" << timeUnitName(bchData.time_unit);
+    }
+    else {
+        bchData.time_unit = NanoSecondUnit;
+        if (PARSE_DEBUG) qDebug() << "-> default time_unit:" << timeUnitName(bchData.time_unit);
+    }
+    // Time normalization (us)
+    double timeFactor = timeUnitFactorUs(bchData.time_unit);
+    if (bchData.time_unit == NanoSecondUnit)
+    {
+        if (bchResults.meta.time_unit.isEmpty())     bchResults.meta.time_unit = "ns";
+        else if (bchResults.meta.time_unit != "ns")  bchResults.meta.time_unit = "us";
+    }
+    else if (bchData.time_unit == MilliSecondUnit)
+    {
+        if (bchResults.meta.time_unit.isEmpty())     bchResults.meta.time_unit = "ms";
+        else if (bchResults.meta.time_unit != "ms")  bchResults.meta.time_unit = "us";
+        
+    }
+    else {
+        bchResults.meta.time_unit = "us";
+    }
+    bchData.real_time_us = bchData.real_time.back() * timeFactor;
+    bchData.cpu_time_us  = bchData.cpu_time.back()  * timeFactor;
+    
+    //
+    // Throughput
+    if (entry.hasBytesSec)
+    {
+        bchData.kbytes_sec.append(entry.bytes_per_second * 0.001);
+        bchData.kbytes_sec_dflt = bchData.kbytes_sec.back();
+        bchResults.meta.hasBytesSec = true;
+        if (PARSE_DEBUG) qDebug() << "-> kbytes_sec:" << bchData.kbytes_sec_dflt;
+    }
+    if (entry.hasItemsSec)
+    {
+        bchData.kitems_sec.append(entry.items_per_second * 0.001);
+        bchData.kitems_sec_dflt = bchData.kitems_sec.back();
+        bchResults.meta.hasItemsSec = true;
+        if (PARSE_DEBUG) qDebug() << "-> kitems_sec:" << bchData.kitems_sec_dflt;
+    }
     
     
     /*
-     * Benchmarks
+     * Existing benchmark
      */
-    if (benchObj.contains("benchmarks") && benchObj["benchmarks"].isArray())
+    int idx = bchIndex.value(bchData.run_name, -1);
+    if (idx >= 0)
     {
-        QJsonArray bchArray = benchObj["benchmarks"].toArray();
-        bchResults.benchmarks.reserve( bchArray.size() );
+        BenchData &exBchData = bchResults.benchmarks[idx];
+        BenchAggregate &exAgg = exBchData.editAggregates();
         
-        for (int bchIdx = 0; bchIdx < bchArray.size(); ++bchIdx)
+        /*
+         * Aggregate type
+         */
+        if (bchData.run_type == "aggregate")
         {
-            // Benchmark
-            QJsonObject bchObj = bchArray[bchIdx].toObject();
-            BenchData bchData;
+            if (PARSE_DEBUG) qDebug() << "-> append aggregate:" << exBchData.name;
             
-            //
             // Name
-            if (bchObj.contains("name") && bchObj["name"].isString())
+            QString aggregate_name;
+            if (entry.hasAggregateName)
             {
-                bchData.name = bchObj["name"].toString();
-                if (PARSE_DEBUG) qDebug() << "bench name:" << bchData.name;
+                aggregate_name = entry.aggregate_name.toString();
+                if (PARSE_DEBUG) qDebug() << "-> aggregate_name:" << aggregate_name;
             }
             else {
-                qCritical() << "Results parsing: missing benchmark field 'name'";
-                continue;
+                qCritical() << "Results parsing: missing benchmark field 'aggregate_name'";
+                return -1;
             }
-            // Run name
-            if (bchObj.contains("run_name") && bchObj["run_name"].isString())
-            {
-                bchData.run_name = bchObj["run_name"].toString();
-                if (PARSE_DEBUG) qDebug() << "-> run_name:" << bchData.run_name;
+            // Type
+            if (aggregate_name == "mean") {
+                exAgg.mean_cpu  = bchData.cpu_time_us;
+                exAgg.mean_real = bchData.real_time_us;
+                if ( !bchData.kbytes_sec.isEmpty() )
+                    exAgg.mean_kbytes = bchData.kbytes_sec_dflt;
+                if ( !bchData.kitems_sec.isEmpty() )
+                    exAgg.mean_kitems = bchData.kitems_sec_dflt;
             }
-            else {
-                bchData.run_name = bchData.name;
-                if (PARSE_DEBUG) qDebug() << "-> name as run_name:" << bchData.run_name;
+            else if (aggregate_name == "median") {
+                exAgg.median_cpu  = bchData.cpu_time_us;
+                exAgg.median_real = bchData.real_time_us;
+                if ( !bchData.kbytes_sec.isEmpty() )
+                    exAgg.median_kbytes = bchData.kbytes_sec_dflt;
+                if ( !bchData.kitems_sec.isEmpty() )
+                    exAgg.median_kitems = bchData.kitems_sec_dflt;
             }
-            cleanupName(bchData);
-            // Run type
-            if (bchObj.contains("run_type") && bchObj["run_type"].isString())
-            {
-                bchData.run_type = bchObj["run_type"].toString();
-                if (PARSE_DEBUG) qDebug() << "-> run_type:" << bchData.run_type;
+            else if (aggregate_name == "stddev") {
+                exAgg.stddev_cpu  = bchData.cpu_time_us;
+                exAgg.stddev_real = bchData.real_time_us;
+                if ( !bchData.kbytes_sec.isEmpty() )
+                    exAgg.stddev_kbytes = bchData.kbytes_sec_dflt;
+                if ( !bchData.kitems_sec.isEmpty() )
+                    exAgg.stddev_kitems = bchData.kitems_sec_dflt;
+            }
+            else if (aggregate_name == "cv") {
+                exAgg.cv_cpu  = bchData.cpu_time.back()  * 100;  // percent
+                exAgg.cv_real = bchData.real_time.back() * 100;
+                if ( !bchData.kbytes_sec.isEmpty() )
+                    exAgg.cv_kbytes = bchData.kbytes_sec_dflt * 100;
+                if ( !bchData.kitems_sec.isEmpty() )
+                    exAgg.cv_kitems = bchData.kitems_sec_dflt * 100;
+                bchResults.meta.hasCv = true;
             }
             else {
-                bchData.run_type = "iteration";
-                if (PARSE_DEBUG) qDebug() << "-> default run_type:" << bchData.run_type;
+                setCustomAggregate(bchResults.meta, exAgg, aggregate_name, entry, bchData);
             }
             
-            //
-            // Timing
-            if (bchObj.contains("iterations") && bchObj["iterations"].isDouble())
-            {
-                bchData.iterations = bchObj["iterations"].toInt();
-                if (PARSE_DEBUG) qDebug() << "-> iterations:" << bchData.iterations;
+            // New aggregate line
+            if (PARSE_DEBUG) qDebug() << "||";
+        }
+        
+        /*
+         * Iteration type (from aggregate)
+         */
+        else
+        {
+            if (PARSE_DEBUG) qDebug() << "-> append iteration:" << exBchData.name;
+            
+            // Append data
+            exBchData.cpu_time.append( bchData.cpu_time.back() );
+            exBchData.cpu_time_us = std::min(exBchData.cpu_time_us, bchData.cpu_time_us);
+            
+            exBchData.real_time.append( bchData.real_time.back() );
+            exBchData.real_time_us = std::min(exBchData.real_time_us, bchData.real_time_us);
+            
+            if ( !bchData.kbytes_sec.isEmpty() ) {
+                exBchData.kbytes_sec.append( bchData.kbytes_sec_dflt );
+                exBchData.kbytes_sec_dflt = std::min(exBchData.kbytes_sec_dflt, bchData.kbytes_sec_dflt);
             }
-            else {
-                qCritical() << "Results parsing: missing benchmark field 'iterations'";
-                continue;
+            if ( !bchData.kitems_sec.isEmpty() ) {
+                exBchData.kitems_sec.append( bchData.kitems_sec_dflt );
+                exBchData.kitems_sec_dflt = std::min(exBchData.kitems_sec_dflt, bchData.kitems_sec_dflt);
             }
             
-            if (bchObj.contains("real_time") && bchObj["real_time"].isDouble())
+            // Min/Max
+            if (!exBchData.hasAggregate) //First -> init
             {
-                bchData.real_time.append( bchObj["real_time"].toDouble() );
-                if (PARSE_DEBUG) qDebug() << "-> real_time:" << bchData.real_time.back();
-            }
-            else {
-                qCritical() << "Results parsing: missing benchmark field 'real_time'";
-                continue;
+                exAgg.min_cpu  = exBchData.cpu_time_us;
+                exAgg.max_cpu  = std::max(exBchData.cpu_time_us,  bchData.cpu_time_us);
+                
+                exAgg.min_real = exBchData.real_time_us;
+                exAgg.max_real = std::max(exBchData.real_time_us, bchData.real_time_us);
+                
+                if ( !bchData.kbytes_sec.isEmpty() ) {
+                    exAgg.min_kbytes = exBchData.kbytes_sec_dflt;
+                    exAgg.max_kbytes = std::max(exBchData.kbytes_sec_dflt, bchData.kbytes_sec_dflt);
+                }
+                if ( !bchData.kitems_sec.isEmpty() ) {
+                    exAgg.min_kitems = exBchData.kitems_sec_dflt;
+                    exAgg.max_kitems = std::max(exBchData.kitems_sec_dflt, bchData.kitems_sec_dflt);
+                }
             }
-            
-            if (bchObj.contains("cpu_time") && bchObj["cpu_time"].isDouble())
+            else
             {
-                bchData.cpu_time.append( bchObj["cpu_time"].toDouble() );
-                if (PARSE_DEBUG) qDebug() << "-> cpu_time:" << bchData.cpu_time.back();
+                if (exAgg.min_cpu  > bchData.cpu_time_us)  exAgg.min_cpu = bchData.cpu_time_us;
+                if (exAgg.max_cpu  < bchData.cpu_time_us)  exAgg.max_cpu = bchData.cpu_time_us;
+                
+                if (exAgg.min_real > bchData.real_time_us) exAgg.min_real = bchData.real_time_us;
+                if (exAgg.max_real < bchData.real_time_us) exAgg.max_real = bchData.real_time_us;
+                
+                if ( !bchData.kbytes_sec.isEmpty() ) {
+                    if (exAgg.min_kbytes > bchData.kbytes_sec_dflt) exAgg.min_kbytes = bchData.kbytes_sec_dflt;
+                    if (exAgg.max_kbytes < bchData.kbytes_sec_dflt) exAgg.max_kbytes = bchData.kbytes_sec_dflt;
+                }
+                if ( !bchData.kitems_sec.isEmpty() ) {
+                    if (exAgg.min_kitems > bchData.kitems_sec_dflt) exAgg.min_kitems = bchData.kitems_sec_dflt;
+                    if (exAgg.max_kitems < bchData.kitems_sec_dflt) exAgg.max_kitems = bchData.kitems_sec_dflt;
+                }
             }
-            else {
-                qCritical() << "Results parsing: missing benchmark field 'cpu_time'";
-                continue;
+            
+            // State
+            exBchData.hasAggregate = true;
+            bchResults.meta.hasAggregate = true;
+            bchResults.meta.onlyAggregate = false;
+            
+            // Debug
+            if (PARSE_DEBUG) {
+                qDebug() << "** exBchData.min_cpu:"  << exAgg.min_cpu;
+                qDebug() << "** exBchData.max_cpu:"  << exAgg.max_cpu;
+                qDebug() << "** exBchData.min_real:" << exAgg.min_real;
+                qDebug() << "** exBchData.max_real:" << exAgg.max_real;
+                if ( !exBchData.kbytes_sec.isEmpty() ) {
+                    qDebug() << "** exBchData.min_kbytes:" << exAgg.min_kbytes;
+                    qDebug() << "** exBchData.max_kbytes:" << exAgg.max_kbytes;
+                }
+                if ( !exBchData.kitems_sec.isEmpty() ) {
+                    qDebug() << "** exBchData.min_kitems:" << exAgg.min_kitems;
+                    qDebug() << "** exBchData.max_kitems:" << exAgg.max_kitems;
+                }
             }
             
-            if (bchObj.contains("time_unit") && bchObj["time_unit"].isString())
+            // New  append line
+            if (PARSE_DEBUG) qDebug() << "|";
+        }
+    }
+    
+    /*
+     * New benchmark
+     */
+    else
+    {
+        /*
+         * Aggregate-only type
+         */
+        if (bchData.run_type == "aggregate")
+        {
+            if (PARSE_DEBUG) qDebug() << "-> new aggregate-only";
+            BenchAggregate &agg = bchData.editAggregates();
+            
+            // Name
+            QString aggregate_name;
+            if (entry.hasAggregateName)
             {
-                bchData.time_unit = bchObj["time_unit"].toString();
-                if (PARSE_DEBUG) qDebug() << "-> time_unit:" << bchData.time_unit;
+                aggregate_name = entry.aggregate_name.toString();
+                if (PARSE_DEBUG) qDebug() << "-> aggregate_name:" << aggregate_name;
             }
             else {
-                bchData.time_unit = "ns";
-                if (PARSE_DEBUG) qDebug() << "-> default time_unit:" << bchData.time_unit;
+                qCritical() << "Results parsing: missing benchmark field 'aggregate_name'";
+                return -1;
             }
-            // Time normalization (us)
-            double timeFactor = 1.;
-            if (bchData.time_unit == "ns")
-            {
-                timeFactor = 0.001;
-                if (bchResults.meta.time_unit.isEmpty())     bchResults.meta.time_unit = "ns";
-                else if (bchResults.meta.time_unit != "ns")  bchResults.meta.time_unit = "us";
+            // Type
+            if (aggregate_name == "mean") {
+                agg.mean_cpu  = bchData.cpu_time_us;
+                agg.mean_real = bchData.real_time_us;
+                if ( !bchData.kbytes_sec.isEmpty() )
+                    agg.mean_kbytes = bchData.kbytes_sec_dflt;
+                if ( !bchData.kitems_sec.isEmpty() )
+                    agg.mean_kitems = bchData.kitems_sec_dflt;
             }
-            else if (bchData.time_unit == "ms")
-            {
-                timeFactor = 1000.;
-                if (bchResults.meta.time_unit.isEmpty())     bchResults.meta.time_unit = "ms";
-                else if (bchResults.meta.time_unit != "ms")  bchResults.meta.time_unit = "us";
-                
+            else if (aggregate_name == "median") {
+                agg.median_cpu  = bchData.cpu_time_us;
+                agg.median_real = bchData.real_time_us;
+                if ( !bchData.kbytes_sec.isEmpty() )
+                    agg.median_kbytes = bchData.kbytes_sec_dflt;
+                if ( !bchData.kitems_sec.isEmpty() )
+                    agg.median_kitems = bchData.kitems_sec_dflt;
             }
-            else {
-                bchResults.meta.time_unit = "us";
+            else if (aggregate_name == "stddev") {
+                agg.stddev_cpu  = bchData.cpu_time_us;
+                agg.stddev_real = bchData.real_time_us;
+                if ( !bchData.kbytes_sec.isEmpty() )
+                    agg.stddev_kbytes = bchData.kbytes_sec_dflt;
+                if ( !bchData.kitems_sec.isEmpty() )
+                    agg.stddev_kitems = bchData.kitems_sec_dflt;
             }
-            bchData.real_time_us = bchData.real_time.back() * timeFactor;
-            bchData.cpu_time_us  = bchData.cpu_time.back()  * timeFactor;
-            
-            //
-            // Throughput
-            if (bchObj.contains("bytes_per_second") && bchObj["bytes_per_second"].isDouble())
-            {
-                bchData.kbytes_sec.append(bchObj["bytes_per_second"].toDouble() * 0.001);
-                bchData.kbytes_sec_dflt = bchData.kbytes_sec.back();
-                bchResults.meta.hasBytesSec = true;
-                if (PARSE_DEBUG) qDebug() << "-> kbytes_sec:" << bchData.kbytes_sec_dflt;
+            else if (aggregate_name == "cv") {
+                agg.cv_cpu  = bchData.cpu_time.back()  * 100;  // percent
+                agg.cv_real = bchData.real_time.back() * 100;
+                if ( !bchData.kbytes_sec.isEmpty() )
+                    agg.cv_kbytes = bchData.kbytes_sec_dflt * 100;
+                if ( !bchData.kitems_sec.isEmpty() )
+                    agg.cv_kitems = bchData.kitems_sec_dflt * 100;
+                bchResults.meta.hasCv = true;
             }
-            if (bchObj.contains("items_per_second") && bchObj["items_per_second"].isDouble())
-            {
-                bchData.kitems_sec.append(bchObj["items_per_second"].toDouble() * 0.001);
-                bchData.kitems_sec_dflt = bchData.kitems_sec.back();
-                bchResults.meta.hasItemsSec = true;
-                if (PARSE_DEBUG) qDebug() << "-> kitems_sec:" << bchData.kitems_sec_dflt;
+            else {
+                setCustomAggregate(bchResults.meta, agg, aggregate_name, entry, bchData);
             }
             
+            // Init
+            bchData.hasAggregate = true;
+            bchResults.meta.hasAggregate = true;
             
-            /*
-             * Existing benchmark
-             */
-            int idx = findExistingBenchmark(bchResults, bchData.run_name);
-            if (idx >= 0)
+            bchData.cpu_time_us  = -1;
+            bchData.real_time_us = -1;
+            agg.min_cpu  = agg.max_cpu  = -1;
+            agg.min_real = agg.max_real = -1;
+        }
+        
+        /*
+         * Add new benchmark
+         */
+        // Arguments (extract from 'run_name')
+        bchData.arguments = bchData.run_name.split('/');
+        QString bchName = bchData.arguments.front();
+        bchData.arguments.pop_front();
+        
+        // Debug: params
+        for (int prmIdx = 0; prmIdx < bchData.arguments.size(); ++prmIdx)
+            if (PARSE_DEBUG) qDebug() << "-> param[" << prmIdx << "]:" << bchData.arguments[prmIdx];
+        
+        // Templates (extract from 'run_name' too)
+        int tpltIdx = bchName.indexOf("<");
+        if (tpltIdx > 0)
+        {
+            int tpltLast = bchName.lastIndexOf(">");
+            if (tpltLast != bchName.size()-1) {
+                qCritical() << "Bad benchmark template formatting:" << bchName;
+                return -1;
+            }
+            QString tpltName = bchName.mid(tpltIdx+1, tpltLast-tpltIdx-1);
+            
+            // Split
+            int startIdx = 0;
+            int commaIdx = tpltName.indexOf(",");
+            while (commaIdx > 0)
             {
-                BenchData &exBchData = bchResults.benchmarks[idx];
+                QString leftString = tpltName.left(commaIdx);
+                int open = leftString.count('<');
+                int close = leftString.count('>');
                 
-                /*
-                 * Aggregate type
-                 */
-                if (bchData.run_type == "aggregate")
+                if (open <= close)
                 {
-                    if (PARSE_DEBUG) qDebug() << "-> append aggregate:" << exBchData.name;
-                    
-                    // Name
-                    QString aggregate_name;
-                    if (bchObj.contains("aggregate_name") && bchObj["aggregate_name"].isString())
-                    {
-                        aggregate_name = bchObj["aggregate_name"].toString();
-                        if (PARSE_DEBUG) qDebug() << "-> aggregate_name:" << aggregate_name;
-                    }
-                    else {
-                        qCritical() << "Results parsing: missing benchmark field 'aggregate_name'";
-                        continue;
-                    }
-                    // Type
-                    if (aggregate_name == "mean") {
-                        exBchData.mean_cpu  = bchData.cpu_time_us;
-                        exBchData.mean_real = bchData.real_time_us;
-                        if ( !bchData.kbytes_sec.isEmpty() )
-                            exBchData.mean_kbytes = bchData.kbytes_sec_dflt;
-                        if ( !bchData.kitems_sec.isEmpty() )
-                            exBchData.mean_kitems = bchData.kitems_sec_dflt;
-                    }
-                    else if (aggregate_name == "median") {
-                        exBchData.median_cpu  = bchData.cpu_time_us;
-                        exBchData.median_real = bchData.real_time_us;
-                        if ( !bchData.kbytes_sec.isEmpty() )
-                            exBchData.median_kbytes = bchData.kbytes_sec_dflt;
-                        if ( !bchData.kitems_sec.isEmpty() )
-                            exBchData.median_kitems = bchData.kitems_sec_dflt;
-                    }
-                    else if (aggregate_name == "stddev") {
-                        exBchData.stddev_cpu  = bchData.cpu_time_us;
-                        exBchData.stddev_real = bchData.real_time_us;
-                        if ( !bchData.kbytes_sec.isEmpty() )
-                            exBchData.stddev_kbytes = bchData.kbytes_sec_dflt;
-                        if ( !bchData.kitems_sec.isEmpty() )
-                            exBchData.stddev_kitems = bchData.kitems_sec_dflt;
-                    }
-                    else if (aggregate_name == "cv") {
-                        exBchData.cv_cpu  = bchData.cpu_time.back()  * 100;  // percent
-                        exBchData.cv_real = bchData.real_time.back() * 100;
-                        if ( !bchData.kbytes_sec.isEmpty() )
-                            exBchData.cv_kbytes = bchData.kbytes_sec_dflt * 100;
-                        if ( !bchData.kitems_sec.isEmpty() )
-                            exBchData.cv_kitems = bchData.kitems_sec_dflt * 100;
-                        bchResults.meta.hasCv = true;
-                    }
-                    else {
-                        qCritical() << "Results parsing: unknown benchmark value for 'aggregate_name' ->" << aggregate_name;
-                        continue;
-                    }
-                    
-                    // New aggregate line
-                    if (PARSE_DEBUG) qDebug() << "||";
+                    bchData.templates.append( tpltName.left(commaIdx).trimmed() );
+                    tpltName.remove(0, commaIdx+1);
+                    startIdx = 0;
                 }
-                
-                /*
-                 * Iteration type (from aggregate)
-                 */
-                else
-                {
-                    if (PARSE_DEBUG) qDebug() << "-> append iteration:" << exBchData.name;
-                    
-                    // Append data
-                    exBchData.cpu_time.append( bchData.cpu_time.back() );
-                    exBchData.cpu_time_us = std::min(exBchData.cpu_time_us, bchData.cpu_time_us);
-                    
-                    exBchData.real_time.append( bchData.real_time.back() );
-                    exBchData.real_time_us = std::min(exBchData.real_time_us, bchData.real_time_us);
-                    
-                    if ( !bchData.kbytes_sec.isEmpty() ) {
-                        exBchData.kbytes_sec.append( bchData.kbytes_sec_dflt );
-                        exBchData.kbytes_sec_dflt = std::min(exBchData.kbytes_sec_dflt, bchData.kbytes_sec_dflt);
-                    }
-                    if ( !bchData.kitems_sec.isEmpty() ) {
-                        exBchData.kitems_sec.append( bchData.kitems_sec_dflt );
-                        exBchData.kitems_sec_dflt = std::min(exBchData.kitems_sec_dflt, bchData.kitems_sec_dflt);
-                    }
-                    
-                    // Min/Max
-                    if (!exBchData.hasAggregate) //First -> init
-                    {
-                        exBchData.min_cpu  = exBchData.cpu_time_us;
-                        exBchData.max_cpu  = std::max(exBchData.cpu_time_us,  bchData.cpu_time_us);
-    
-                        exBchData.min_real = exBchData.real_time_us;
-                        exBchData.max_real = std::max(exBchData.real_time_us, bchData.real_time_us);
-                        
-                        if ( !bchData.kbytes_sec.isEmpty() ) {
-                            exBchData.min_kbytes = exBchData.kbytes_sec_dflt;
-                            exBchData.max_kbytes = std::max(exBchData.kbytes_sec_dflt, bchData.kbytes_sec_dflt);
-                        }
-                        if ( !bchData.kitems_sec.isEmpty() ) {
-                            exBchData.min_kitems = exBchData.kitems_sec_dflt;
-                            exBchData.max_kitems = std::max(exBchData.kitems_sec_dflt, bchData.kitems_sec_dflt);
-                        }
-                    }
-                    else
-                    {
-                        if (exBchData.min_cpu  > bchData.cpu_time_us)  exBchData.min_cpu = bchData.cpu_time_us;
-                        if (exBchData.max_cpu  < bchData.cpu_time_us)  exBchData.max_cpu = bchData.cpu_time_us;
-                        
-                        if (exBchData.min_real > bchData.real_time_us) exBchData.min_real = bchData.real_time_us;
-                        if (exBchData.max_real < bchData.real_time_us) exBchData.max_real = bchData.real_time_us;
-                        
-                        if ( !bchData.kbytes_sec.isEmpty() ) {
-                            if (exBchData.min_kbytes > bchData.kbytes_sec_dflt) exBchData.min_kbytes = bchData.kbytes_sec_dflt;
-                            if (exBchData.max_kbytes < bchData.kbytes_sec_dflt) exBchData.max_kbytes = bchData.kbytes_sec_dflt;
-                        }
-                        if ( !bchData.kitems_sec.isEmpty() ) {
-                            if (exBchData.min_kitems > bchData.kitems_sec_dflt) exBchData.min_kitems = bchData.kitems_sec_dflt;
-                            if (exBchData.max_kitems < bchData.kitems_sec_dflt) exBchData.max_kitems = bchData.kitems_sec_dflt;
-                        }
-                    }
-                    
-                    // State
-                    exBchData.hasAggregate = true;
-                    bchResults.meta.hasAggregate = true;
-                    bchResults.meta.onlyAggregate = false;
-                    
-                    // Debug
-                    if (PARSE_DEBUG) {
-                        qDebug() << "** exBchData.min_cpu:"  << exBchData.min_cpu;
-                        qDebug() << "** exBchData.max_cpu:"  << exBchData.max_cpu;
-                        qDebug() << "** exBchData.min_real:" << exBchData.min_real;
-                        qDebug() << "** exBchData.max_real:" << exBchData.max_real;
-                        if ( !exBchData.kbytes_sec.isEmpty() ) {
-                            qDebug() << "** exBchData.min_kbytes:" << exBchData.min_kbytes;
-                            qDebug() << "** exBchData.max_kbytes:" << exBchData.max_kbytes;
-                        }
-                        if ( !exBchData.kitems_sec.isEmpty() ) {
-                            qDebug() << "** exBchData.min_kitems:" << exBchData.min_kitems;
-                            qDebug() << "** exBchData.max_kitems:" << exBchData.max_kitems;
-                        }
-                    }
-                    
-                    // New  append line
-                    if (PARSE_DEBUG) qDebug() << "|";
+                else {
+                    startIdx = commaIdx+1;
                 }
+                commaIdx = tpltName.indexOf(",", startIdx);
             }
+            // Last
+            bchData.templates.append( tpltName.trimmed() );
             
-            /*
-             * New benchmark
-             */
-            else
+            // For base name
+            bchName.truncate(tpltIdx);
+        }
+        // Debug: templates
+        for (int idx = 0; idx < bchData.templates.size(); ++idx)
+            if (PARSE_DEBUG) qDebug() << "-> template[" << idx << "]:" << bchData.templates[idx];
+        
+        // Base name (i.e. name without templates/arguments)
+        bchData.base_name = bchName;
+        if (PARSE_DEBUG) qDebug() << "-> base_name:" << bchData.base_name;
+        
+        // JOMT
+        // Family / Container
+        if ( bchData.base_name.startsWith("JOMT_") )
+        {
+            // Examples: "JOMT_Fill_vector<int>/64" Vs "JOMT_Fill_deque<int>/64"
+            bchData.base_name = bchData.base_name.remove(0,5);  //remove prefix
+            int idx = bchData.base_name.indexOf('_');
+            if (idx > 0)
             {
-                /*
-                 * Aggregate-only type
-                 */
-                if (bchData.run_type == "aggregate")
-                {
-                    if (PARSE_DEBUG) qDebug() << "-> new aggregate-only";
-                    
-                    // Name
-                    QString aggregate_name;
-                    if (bchObj.contains("aggregate_name") && bchObj["aggregate_name"].isString())
-                    {
-                        aggregate_name = bchObj["aggregate_name"].toString();
-                        if (PARSE_DEBUG) qDebug() << "-> aggregate_name:" << aggregate_name;
-                    }
-                    else {
-                        qCritical() << "Results parsing: missing benchmark field 'aggregate_name'";
-                        continue;
-                    }
-                    // Type
-                    if (aggregate_name == "mean") {
-                        bchData.mean_cpu  = bchData.cpu_time_us;
-                        bchData.mean_real = bchData.real_time_us;
-                        if ( !bchData.kbytes_sec.isEmpty() )
-                            bchData.mean_kbytes = bchData.kbytes_sec_dflt;
-                        if ( !bchData.kitems_sec.isEmpty() )
-                            bchData.mean_kitems = bchData.kitems_sec_dflt;
-                    }
-                    else if (aggregate_name == "median") {
-                        bchData.median_cpu  = bchData.cpu_time_us;
-                        bchData.median_real = bchData.real_time_us;
-                        if ( !bchData.kbytes_sec.isEmpty() )
-                            bchData.median_kbytes = bchData.kbytes_sec_dflt;
-                        if ( !bchData.kitems_sec.isEmpty() )
-                            bchData.median_kitems = bchData.kitems_sec_dflt;
-                    }
-                    else if (aggregate_name == "stddev") {
-                        bchData.stddev_cpu  = bchData.cpu_time_us;
-                        bchData.stddev_real = bchData.real_time_us;
-                        if ( !bchData.kbytes_sec.isEmpty() )
-                            bchData.stddev_kbytes = bchData.kbytes_sec_dflt;
-                        if ( !bchData.kitems_sec.isEmpty() )
-                            bchData.stddev_kitems = bchData.kitems_sec_dflt;
-                    }
-                    else if (aggregate_name == "cv") {
-                        bchData.cv_cpu  = bchData.cpu_time.back()  * 100;  // percent
-                        bchData.cv_real = bchData.real_time.back() * 100;
-                        if ( !bchData.kbytes_sec.isEmpty() )
-                            bchData.cv_kbytes = bchData.kbytes_sec_dflt * 100;
-                        if ( !bchData.kitems_sec.isEmpty() )
-                            bchData.cv_kitems = bchData.kitems_sec_dflt * 100;
-                        bchResults.meta.hasCv = true;
-                    }
-                    else {
-                        qCritical() << "Results parsing: unknown benchmark value for 'aggregate_name' ->" << aggregate_name;
-                        continue;
-                    }
-                    
-                    // Init
-                    bchData.hasAggregate = true;
-                    bchResults.meta.hasAggregate = true;
-                    
-                    bchData.cpu_time_us  = -1;
-                    bchData.real_time_us = -1;
-                    bchData.min_cpu  = bchData.max_cpu  = -1;
-                    bchData.min_real = bchData.max_real = -1;
-                }
-                
-                /*
-                 * Add new benchmark
-                 */
-                // Arguments (extract from 'run_name')
-                bchData.arguments = bchData.run_name.split('/');
-                QString bchName = bchData.arguments.front();
-                bchData.arguments.pop_front();
-                
-                // Debug: params
-                for (int prmIdx = 0; prmIdx < bchData.arguments.size(); ++prmIdx)
-                    if (PARSE_DEBUG) qDebug() << "-> param[" << prmIdx << "]:" << bchData.arguments[prmIdx];
-                
-                // Templates (extract from 'run_name' too)
-                int tpltIdx = bchName.indexOf("<");
-                if (tpltIdx > 0)
-                {
-                    int tpltLast = bchName.lastIndexOf(">");
-                    if (tpltLast != bchName.size()-1) {
-                        qCritical() << "Bad benchmark template formatting:" << bchName;
-                        continue;
-                    }
-                    QString tpltName = bchName.mid(tpltIdx+1, tpltLast-tpltIdx-1);
-                    
-                    // Split
-                    int startIdx = 0;
-                    int commaIdx = tpltName.indexOf(",");
-                    while (commaIdx > 0)
-                    {
-                        QString leftString = tpltName.left(commaIdx);
-                        int open = leftString.count('<');
-                        int close = leftString.count('>');
-                        
-                        if (open <= close)
-                        {
-                            bchData.templates.append( tpltName.left(commaIdx).trimmed() );
-                            tpltName.remove(0, commaIdx+1);
-                            startIdx = 0;
-                        }
-                        else {
-                            startIdx = commaIdx+1;
-                        }
-                        commaIdx = tpltName.indexOf(",", startIdx);
-                    }
-                    // Last
-                    bchData.templates.append( tpltName.trimmed() );
-                    
-                    // For base name
-                    bchName.truncate(tpltIdx);
-                }
-                // Debug: templates
-                for (int idx = 0; idx < bchData.templates.size(); ++idx)
-                    if (PARSE_DEBUG) qDebug() << "-> template[" << idx << "]:" << bchData.templates[idx];
-                
-                // Base name (i.e. name without templates/arguments)
-                bchData.base_name = bchName;
-                if (PARSE_DEBUG) qDebug() << "-> base_name:" << bchData.base_name;
-                
-                // JOMT
-                // Family / Container
-                if ( bchData.base_name.startsWith("JOMT_") )
-                {
-                    // Examples: "JOMT_Fill_vector<int>/64" Vs "JOMT_Fill_deque<int>/64"
-                    bchData.base_name = bchData.base_name.remove(0,5);  //remove prefix
-                    int idx = bchData.base_name.indexOf('_');
-                    if (idx > 0)
-                    {
-                        bchData.family = bchData.base_name.left(idx);
-                        bchData.container = bchData.base_name;
-                        bchData.container = bchData.container.remove(0,idx+1);
-                    }
-                }
-                // Classic (base name as family name)
-                else
-                    bchData.family = bchData.base_name;
-                
-                if (PARSE_DEBUG) qDebug() << "-> family:" << bchData.family;
-                if (PARSE_DEBUG) qDebug() << "-> container:" << bchData.container;
+                bchData.family = bchData.base_name.left(idx);
+                bchData.container = bchData.base_name;
+                bchData.container = bchData.container.remove(0,idx+1);
+            }
+        }
+        // Classic (base name as family name)
+        else
+            bchData.family = bchData.base_name;
+        
+        if (PARSE_DEBUG) qDebug() << "-> family:" << bchData.family;
+        if (PARSE_DEBUG) qDebug() << "-> container:" << bchData.container;
+        
+        
+        //
+        // Meta
+        if (entry.hasRepetitions)
+        {
+            bchData.repetitions = toInt(entry.repetitions);
+            if (PARSE_DEBUG) qDebug() << "-> repetitions:" << bchData.repetitions;
+        }
+        if (entry.hasRepetitionIndex)
+        {
+            bchData.repetition_index = toInt(entry.repetition_index);
+            if (PARSE_DEBUG) qDebug() << "-> repetition_index:" << bchData.repetition_index;
+        }
+        if (entry.hasThreads)
+        {
+            bchData.threads = toInt(entry.threads);
+            if (PARSE_DEBUG) qDebug() << "-> threads:" << bchData.threads;
+        }
+        
+        //
+        // Global Meta
+        if (bchData.arguments.size() > bchResults.meta.maxArguments)
+            bchResults.meta.maxArguments = bchData.arguments.size();
+        if (bchData.templates.size() > bchResults.meta.maxTemplates)
+            bchResults.meta.maxTemplates = bchData.templates.size();
+        bchResults.meta.onlyAggregate &= bchData.aggregates().min_real < 0.;
+        
+        //
+        // Push new BenchData (pooled strings)
+        bchResults.strings.intern(bchData);
+        bchIndex.insert(bchData.run_name, bchResults.benchmarks.size());
+        bchResults.benchmarks.append(bchData);
+        
+        // New line between benchmarks
+        if (PARSE_DEBUG) qDebug() << "";
+    }
     
+    return idx >= 0 ? idx : bchResults.benchmarks.size() - 1;
+}
+
+/**************************************************************************************************/
+
+// Parse benchmarks array content (reader inside array)
+static bool parseBenchmarks(JsonReader &reader, BenchResults &bchResults, BenchIndex &bchIndex,
+                            ParseState *state, ParseProgress *progress)
+{
+    qint64 progressOffset = reader.offset();
+    while (reader.readNext() != JsonReader::EndArray)
+    {
+        if (reader.token() == JsonReader::Invalid)
+            return false;
+        
+        // Benchmark
+        BenchEntry entry;
+        if (reader.token() == JsonReader::BeginObject) {
+            if ( !parseBenchEntry(reader, entry) )
+                return false;
+        }
+        else if ( !reader.skipCurrent() )
+            return false;
+        
+        int changedIdx = addBenchmark(bchResults, bchIndex, entry);
+        ++bchResults.revision;  // derived data outdated
+        
+        // Last complete benchmark
+        if (state != nullptr) {
+            state->offset = reader.offset();
+            state->hasBenchmarks = true;
+            if (changedIdx >= 0 && changedIdx < state->changedFrom)
+                state->changedFrom = changedIdx;
+        }
+        
+        // Cancel (each benchmark), progress (by blocks of data)
+        if (progress != nullptr)
+        {
+            if ( progress->isCanceled() )
+                return false;
+            if (reader.offset() - progressOffset >= progress_step) {
+                progress->addParsed(reader.offset() - progressOffset);
+                progressOffset = reader.offset();
+            }
+        }
+    }
+    if (progress != nullptr)
+        progress->addParsed(reader.offset() - progressOffset);
     
-                //
-                // Meta
-                if (bchObj.contains("repetitions") && bchObj["repetitions"].isDouble())
-                {
-                    bchData.repetitions = bchObj["repetitions"].toInt();
-                    if (PARSE_DEBUG) qDebug() << "-> repetitions:" << bchData.repetitions;
-                }
-                if (bchObj.contains("repetition_index") && bchObj["repetition_index"].isDouble())
-                {
-                    bchData.repetition_index = bchObj["repetition_index"].toInt();
-                    if (PARSE_DEBUG) qDebug() << "-> repetition_index:" << bchData.repetition_index;
-                }
-                if (bchObj.contains("threads") && bchObj["threads"].isDouble())
-                {
-                    bchData.threads = bchObj["threads"].toInt();
-                    if (PARSE_DEBUG) qDebug() << "-> threads:" << bchData.threads;
-                }
-                
-                //
-                // Global Meta
-                if (bchData.arguments.size() > bchResults.meta.maxArguments)
-                    bchResults.meta.maxArguments = bchData.arguments.size();
-                if (bchData.templates.size() > bchResults.meta.maxTemplates)
-                    bchResults.meta.maxTemplates = bchData.templates.size();
-                bchResults.meta.onlyAggregate &= bchData.min_real < 0.;
-                
-                //
-                // Push new BenchData
-                bchResults.benchmarks.append(bchData);
+    return true;
+}
+
+// Fields found in root object
+struct RootFields
+{
+    bool isEmpty = true;
+    bool hasContext = false;
+    bool hasBenchmarks = false;
+};
+
+// Parse remaining fields of root object (stops at first error, reader tells if data was missing)
+static void parseRootFields(JsonReader &reader, BenchResults &bchResults, BenchIndex &bchIndex,
+                            ParseState *state, ParseProgress *progress, RootFields &fields)
+{
+    while (reader.readNext() == JsonReader::Name)
+    {
+        fields.isEmpty = false;
+        
+        /*
+         * Context
+         */
+        if (reader.isName("context"))
+        {
+            if (reader.readNext() == JsonReader::BeginObject) {
+                fields.hasContext = parseContext(reader, bchResults);
                 
-                // New line between benchmarks
+                // New line between context and benchmarks
                 if (PARSE_DEBUG) qDebug() << "";
             }
+            else
+                reader.skipCurrent();
+        }
+        
+        /*
+         * Benchmarks
+         */
+        else if (reader.isName("benchmarks"))
+        {
+            if (reader.readNext() != JsonReader::BeginArray) {
+                reader.skipCurrent();
+                continue;
+            }
+            fields.hasBenchmarks = true;
+            if (state != nullptr) {
+                state->headSize = state->offset = reader.offset();
+                state->hasBenchmarks = false;
+            }
+            
+            if ( !parseBenchmarks(reader, bchResults, bchIndex, state, progress) )
+                return;
         }
+        else
+            reader.skipValue();
     }
-    else
+}
+
+// Check end of root object
+static bool endRootObject(JsonReader &reader)
+{
+    return reader.token() == JsonReader::EndObject && reader.readNext() == JsonReader::EndDocument;
+}
+
+// Error of invalid document (reader error with offset logged)
+static QString parseError(const JsonReader &reader)
+{
+    if ( reader.hasError() )
+        qWarning() << "Results parsing: invalid json," << reader.errorString();
+    return "Not a json benchmark results file.";
+}
+
+// Parse benchmark results from json document
+static BenchResults parseJsonDocument(JsonReader &reader, QString& errorMsg, ParseState *state = nullptr,
+                                      ParseProgress *progress = nullptr)
+{
+    BenchResults bchResults;
+    BenchIndex localIndex;
+    BenchIndex &bchIndex = state != nullptr ? state->bchIndex : localIndex;
+    
+    // Json main object
+    if (reader.readNext() != JsonReader::BeginObject) {
+        errorMsg = "Not a json benchmark results file.";
+        return bchResults;
+    }
+    RootFields fields;
+    parseRootFields(reader, bchResults, bchIndex, state, progress, fields);
+    if (progress != nullptr && progress->isCanceled()) {
+        errorMsg = "Parsing canceled.";
+        return BenchResults();
+    }
+    
+    // Check whole document was valid (or data missing after benchmarks start if tolerated)
+    bool isComplete = endRootObject(reader);
+    bool isTruncated = !isComplete && state != nullptr && fields.hasBenchmarks && reader.isEndOfData();
+    if ( !isComplete && !isTruncated ) {
+        if (PARSE_DEBUG) qDebug() << "Json error:" << reader.errorString();
+        errorMsg = parseError(reader);
+        return BenchResults();
+    }
+    if (fields.isEmpty) {
+        errorMsg = "Empty json benchmark results file.";
+        return bchResults;
+    }
+    if (state != nullptr) {
+        state->isComplete = isComplete;
+        state->isTruncated = isTruncated;
+    }
+    if (isTruncated)
+    {
+        if (PARSE_DEBUG) qDebug() << "Json truncated:" << reader.errorString();
+        if ( bchResults.benchmarks.isEmpty() ) {
+            errorMsg = "No complete benchmark in truncated json results file.";
+            return bchResults;
+        }
+        qWarning() << "Results parsing: truncated file, ignoring data after offset" << state->offset;
+    }
+    
+    if (!fields.hasContext)
+        qCritical() << "Results parsing: missing field 'context'";
+    if (!fields.hasBenchmarks)
         qCritical() << "Results parsing: missing field 'benchmarks'";
     
     // Debug
@@ -663,7 +977,312 @@ BenchResults ResultParser::parseJsonFile(const QString &filename, QString& error
         qDebug() << "meta.maxTemplates:"    << bchResults.meta.maxTemplates;
         qDebug() << "meta.hasAggregate:"    << bchResults.meta.hasAggregate;
     }
+    bchResults.updateDerived();
+    
     
+    return bchResults;
+}
+
+// Create reader on file from offset (mapped if possible, unmapped on close)
+// Files possibly still written are never mapped (access after truncation would crash),
+// but read by chunks up to current size
+static JsonReader* createReader(QFile &benchFile, qint64 offset, bool isLive, ParseProgress *progress)
+{
+    qint64 fileSize = benchFile.size();
+    if (progress != nullptr)
+        progress->addTotal(fileSize - offset);
+    uchar *fileData = !isLive && fileSize > offset ? benchFile.map(offset, fileSize - offset) : nullptr;
+    if (fileData != nullptr)
+    {
+        if (PARSE_DEBUG) qDebug() << "Parsing mapped file:" << benchFile.fileName();
+        return new JsonReader(reinterpret_cast<const char*>(fileData), fileSize - offset);
+    }
+    
+    // Fallback to chunked reads
+    if (PARSE_DEBUG) qDebug() << "Parsing streamed file:" << benchFile.fileName();
+    if (offset > 0)
+        benchFile.seek(offset);
+    return new JsonReader(&benchFile, 1 << 20, qMax<qint64>(fileSize - offset, 0));
+}
+
+// Hash of file head (up to benchmarks array)
+static size_t hashFileHead(QFile &benchFile, qint64 headSize)
+{
+    benchFile.seek(0);
+    QByteArray head = benchFile.read(headSize);
+    if (head.size() != headSize)
+        return 0;
+    
+    return qHash(head);
+}
+
+// Fingerprint for results cache (known one if same file size and modification time)
+static FileFingerprint sourceFingerprint(QFile &benchFile, const FileFingerprint *source, ParseProgress *progress)
+{
+    if ( !ResultCache::isEnabled() )
+        return FileFingerprint();
+    
+    if (source != nullptr && source->isValid())
+    {
+        QFileInfo fileInfo(benchFile);
+        if (source->path == fileInfo.absoluteFilePath() && source->size == fileInfo.size()
+                && source->mtime == fileInfo.lastModified().toMSecsSinceEpoch())
+            return *source;
+    }
+    return ResultCache::fingerprint(benchFile, progress);
+}
+
+// Parse benchmark results from json file
+BenchResults ResultParser::parseJsonFile(const QString &filename, QString& errorMsg, ParseReport *report,
+                                         ParseProgress *progress, const FileFingerprint *source)
+{
+    // Open file
+    QFile benchFile(filename);
+    if ( !benchFile.open(QIODevice::ReadOnly) ) {
+        errorMsg = "Couldn't open benchmark results file.";
+        return BenchResults();
+    }
+    
+    qint64 fileSize = benchFile.size();
+    
+    // Cached results
+    BenchResults bchResults;
+    FileFingerprint fingerprint = sourceFingerprint(benchFile, source, progress);
+    if (progress != nullptr && progress->isCanceled()) {
+        errorMsg = "Parsing canceled.";
+        return BenchResults();
+    }
+    if ( ResultCache::load(fingerprint, bchResults) ) {
+        if (report != nullptr)
+            *report = {false, fileSize, 0};
+        return bchResults;
+    }
+    
+    // Recovery mode for files possibly still written
+    QScopedPointer<JsonReader> reader( createReader(benchFile, 0, report != nullptr, progress) );
+    if (report == nullptr) {
+        bchResults = parseJsonDocument(*reader, errorMsg, nullptr, progress);
+        if ( !bchResults.benchmarks.isEmpty() )
+            ResultCache::save(fingerprint, bchResults);
+        return bchResults;
+    }
+    
+    // Recovery mode
+    ParseState state;
+    bchResults = parseJsonDocument(*reader, errorMsg, &state, progress);
+    if ( !bchResults.benchmarks.isEmpty() && !state.isTruncated )
+        ResultCache::save(fingerprint, bchResults);
+    
+    report->isTruncated = state.isTruncated;
+    report->parsedBytes = state.isTruncated ? state.offset : fileSize;
+    report->skippedBytes = fileSize - report->parsedBytes;
+    
+    return bchResults;
+}
+
+// Parse new benchmarks appended to json file since previous call
+bool ResultParser::parseJsonFileIncremental(const QString &filename, BenchResults &bchResults,
+                                            ParseState &state, QString& errorMsg, ParseProgress *progress,
+                                            const FileFingerprint *source)
+{
+    // Open file
+    QFile benchFile(filename);
+    if ( !benchFile.open(QIODevice::ReadOnly) ) {
+        errorMsg = "Couldn't open benchmark results file.";
+        return false;
+    }
+    qint64 fileSize = benchFile.size();
+    
+    // Check file only grew since previous parsing
+    bool canResume = state.filename == filename && state.headSize > 0
+                     && fileSize >= state.offset && fileSize >= state.fileSize;
+    if (canResume)
+    {
+        // Same head (context) and same data before offset
+        canResume = hashFileHead(benchFile, state.headSize) == state.headHash;
+        if (canResume) {
+            qint64 tailSize = qMin<qint64>(state.offset, 16);
+            benchFile.seek(state.offset - tailSize);
+            canResume = benchFile.read(tailSize) == state.tail;
+        }
+        // Unchanged
+        state.isUnchanged = canResume && fileSize == state.fileSize;
+        if (state.isUnchanged)
+            return true;
+        canResume &= !state.isComplete;
+    }
+    
+    /*
+     * Full parsing
+     */
+    if (!canResume)
+    {
+        if (PARSE_DEBUG) qDebug() << "Incremental parsing from start:" << filename;
+        state = ParseState();
+        
+        // Cached results (complete file, never resumed)
+        BenchResults newResults;
+        FileFingerprint fingerprint = sourceFingerprint(benchFile, source, progress);
+        if (progress != nullptr && progress->isCanceled()) {
+            errorMsg = "Parsing canceled.";
+            state = ParseState();
+            return false;
+        }
+        if ( ResultCache::load(fingerprint, newResults) ) {
+            state.offset = fileSize;
+            state.isComplete = true;
+            state.hasBenchmarks = !newResults.benchmarks.isEmpty();
+            for (int i=0; i<newResults.benchmarks.size(); ++i)
+                state.bchIndex.insert(newResults.benchmarks[i].run_name, i);
+            bchResults = newResults;
+        }
+        else
+        {
+            QScopedPointer<JsonReader> reader( createReader(benchFile, 0, true, progress) );
+            newResults = parseJsonDocument(*reader, errorMsg, &state, progress);
+            if ( newResults.benchmarks.isEmpty() ) {
+                state = ParseState();
+                return false;
+            }
+            if (state.isComplete)
+                ResultCache::save(fingerprint, newResults);
+            bchResults = newResults;
+            state.headHash = hashFileHead(benchFile, state.headSize);
+        }
+    }
+    
+    /*
+     * Resume in benchmarks array
+     */
+    else
+    {
+        if (PARSE_DEBUG) qDebug() << "Incremental parsing from offset" << state.offset << ":" << filename;
+        
+        QScopedPointer<JsonReader> reader( createReader(benchFile, state.offset, true, progress) );
+        reader->resumeInArray(state.offset, state.hasBenchmarks);
+        state.changedFrom = bchResults.benchmarks.size();
+        bool hasDerived = bchResults.hasColumns() && bchResults.hasDimensions();
+        
+        if ( parseBenchmarks(*reader, bchResults, state.bchIndex, &state, progress) )
+        {
+            RootFields fields;
+            parseRootFields(*reader, bchResults, state.bchIndex, &state, progress, fields);
+            state.isComplete = endRootObject(*reader);
+        }
+        
+        if (progress != nullptr && progress->isCanceled()) {
+            errorMsg = "Parsing canceled.";
+            return false;
+        }
+        // Only missing data tolerated (invalid appended data is an error)
+        if ( !state.isComplete && !reader->isEndOfData() ) {
+            if (PARSE_DEBUG) qDebug() << "Json error:" << reader->errorString();
+            errorMsg = parseError(*reader);
+            return false;
+        }
+        state.isTruncated = !state.isComplete;
+        if (hasDerived)
+            bchResults.updateDerived(state.changedFrom);
+        else
+            bchResults.updateDerived();
+    }
+    
+    // Save position
+    state.filename = filename;
+    state.fileSize = fileSize;
+    state.report.isTruncated = state.isTruncated;
+    state.report.parsedBytes = state.isTruncated ? state.offset : fileSize;
+    state.report.skippedBytes = fileSize - state.report.parsedBytes;
+    qint64 tailSize = qMin<qint64>(state.offset, 16);
+    benchFile.seek(state.offset - tailSize);
+    state.tail = benchFile.read(tailSize);
+    
+    return true;
+}
+
+// Parse multiple json files concurrently
+QVector<BenchResults> ResultParser::parseJsonFiles(const QStringList &filenames, QStringList& errorMsgs,
+                                                   QVector<ParseReport> *reports, ParseProgress *progress,
+                                                   const QVector<FileFingerprint> *sources)
+{
+    QVector<BenchResults> results(filenames.size());
+    QVector<QString> errors(filenames.size());
+    if (reports != nullptr)
+        *reports = QVector<ParseReport>(filenames.size());
+    ParseReport *reportsData = reports != nullptr ? reports->data() : nullptr;
+    const FileFingerprint *sourcesData = sources != nullptr && sources->size() == filenames.size() ? sources->constData()
+                                                                                                   : nullptr;
+    
+    if (filenames.size() == 1)
+        results[0] = parseJsonFile(filenames[0], errors[0], reportsData, progress, sourcesData);
+    else if (filenames.size() > 1)
+    {
+        // One task per file, each writing its own slot
+        QVector<int> fileIdxs(filenames.size());
+        for (int i=0; i<fileIdxs.size(); ++i)
+            fileIdxs[i] = i;
+        
+        BenchResults *resultsData = results.data();
+        QString *errorsData = errors.data();
+        QtConcurrent::blockingMap(fileIdxs, [&](int idx) {
+            resultsData[idx] = parseJsonFile(filenames[idx], errorsData[idx],
+                                             reportsData != nullptr ? reportsData + idx : nullptr, progress,
+                                             sourcesData != nullptr ? sourcesData + idx : nullptr);
+        });
+    }
+    errorMsgs = errors;
+    
+    return results;
+}
+
+// Load and merge original and additional json files
+BenchResults ResultParser::loadJsonFiles(const QString &filename, const QVector<FileReload> &addFilenames,
+                                         QString& errorMsg, int& errorIdx, ParseReport *report,
+                                         ParseProgress *progress, const QVector<FileFingerprint> *sources)
+{
+    QStringList filenames;
+    filenames.append(filename);
+    for (const auto& addFile : addFilenames)
+        filenames.append(addFile.filename);
+    
+    QStringList errorMsgs;
+    QVector<ParseReport> reports;
+    QVector<BenchResults> results = parseJsonFiles(filenames, errorMsgs, report != nullptr ? &reports : nullptr, progress,
+                                                   sources);
+    
+    // Check in order
+    for (int i=0; i<results.size(); ++i)
+    {
+        if ( results[i].benchmarks.isEmpty() ) {
+            errorMsg = errorMsgs[i];
+            errorIdx = i - 1;
+            return BenchResults();
+        }
+    }
+    
+    // Recovery mode summary
+    if (report != nullptr)
+    {
+        *report = ParseReport();
+        for (const auto& fileReport : std::as_const(reports))
+        {
+            report->isTruncated  |= fileReport.isTruncated;
+            report->parsedBytes  += fileReport.parsedBytes;
+            report->skippedBytes += fileReport.skippedBytes;
+        }
+    }
+    
+    // Append / Overwrite
+    BenchResults bchResults = std::move(results[0]);
+    for (int i=0; i<addFilenames.size(); ++i)
+    {
+        if (addFilenames[i].isAppend)
+            bchResults.appendResults(std::move(results[i+1]), false);
+        else
+            bchResults.overwriteResults(std::move(results[i+1]), false);
+    }
+    if ( !addFilenames.isEmpty() )
+        bchResults.updateDerived();
     
     return bchResults;
 }
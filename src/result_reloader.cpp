@@ -0,0 +1,440 @@
+// Copyright 2019 Guillaume AUJAY. All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include "result_reloader.h"
+#include "result_snapshots.h"
+#include "result_cache.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QMessageBox>
+#include <QtConcurrent>
+
+#include <utility>
+
+#define RELOAD_DEBUG false
+#include <QDebug>
+
+// Changed files reloaded once size and modification time are the same for a whole period
+static const int settle_period_ms = 250;
+static const int settle_max_tries = 40;     // while missing or empty (e.g. being replaced)
+
+
+ResultReloader::ResultReloader(QObject *parent)
+    : QObject(parent)
+{
+    connect(&mWatcher, &QFileSystemWatcher::fileChanged, this, &ResultReloader::onFileChanged);
+    
+    mSettleTimer.setSingleShot(true);
+    connect(&mSettleTimer, &QTimer::timeout, this, &ResultReloader::onSettleTimeout);
+}
+
+ResultReloader* ResultReloader::instance()
+{
+    static ResultReloader reloader;
+    return &reloader;
+}
+
+/**************************************************************************************************/
+
+void ResultReloader::watch(QObject *window, const QString &filename, const QVector<FileReload> &addFilenames)
+{
+    unwatch(window);
+    
+    QSharedPointer<Source> src = source(filename, addFilenames);
+    src->windows.insert(window);
+    connect(window, &QObject::destroyed, this, &ResultReloader::onWindowDestroyed, Qt::UniqueConnection);
+    
+    updateWatchList();
+}
+
+void ResultReloader::unwatch(QObject *window)
+{
+    const QStringList keys = mSources.keys();
+    for (const auto& key : keys)
+    {
+        if ( mSources[key]->windows.remove(window) )
+            releaseSource(key);
+    }
+    
+    updateWatchList();
+}
+
+void ResultReloader::onWindowDestroyed(QObject *window)
+{
+    unwatch(window);
+}
+
+/**************************************************************************************************/
+
+void ResultReloader::reload(const QString &filename, const QVector<FileReload> &addFilenames, QWidget *requester,
+                            const QSharedPointer<ParseProgress> &progress)
+{
+    QSharedPointer<Source> src = source(filename, addFilenames);
+    if (requester != nullptr)
+        src->requester = requester;
+    if ( !progress.isNull() )
+        src->progress = progress;
+    
+    startReload( ResultSnapshots::sourceKey(filename, addFilenames) );
+}
+
+bool ResultReloader::isReloading(const QString &sourceKey) const
+{
+    QSharedPointer<Source> src = mSources.value(sourceKey);
+    return !src.isNull() && (src->loader.isRunning() || src->isPending);
+}
+
+void ResultReloader::setLoaded(const QString &filename, const BenchSnapshot &bchResults, const ParseState &parseState)
+{
+    QSharedPointer<Source> src = source(filename, {});
+    src->latest       = bchResults;
+    src->parseState   = parseState;
+    src->stateVersion = bchResults->version;
+    src->files.clear();
+    src->report       = parseState.report;
+}
+
+/**************************************************************************************************/
+
+QSharedPointer<ResultReloader::Source> ResultReloader::source(const QString &filename,
+                                                              const QVector<FileReload> &addFilenames)
+{
+    QString key = ResultSnapshots::sourceKey(filename, addFilenames);
+    QSharedPointer<Source> src = mSources.value(key);
+    if ( src.isNull() )
+    {
+        src = QSharedPointer<Source>::create();
+        src->filename     = filename;
+        src->addFilenames = addFilenames;
+        connect(&src->loader, &QFutureWatcher<ReloadResult>::finished, this, [this, key]() { finishReload(key); });
+        mSources.insert(key, src);
+    }
+    
+    return src;
+}
+
+void ResultReloader::releaseSource(const QString &sourceKey)
+{
+    // Still needed by windows or running
+    QSharedPointer<Source> src = mSources.value(sourceKey);
+    if (src.isNull() || !src->windows.isEmpty() || !src->latest.isNull() || src->loader.isRunning())
+        return;
+    
+    mSources.remove(sourceKey);
+}
+
+void ResultReloader::updateWatchList()
+{
+    // Paths of auto-reloaded sources
+    QSet<QString> paths;
+    for (const auto& src : std::as_const(mSources))
+    {
+        if ( src->windows.isEmpty() )
+            continue;
+        paths.insert(src->filename);
+        for (const auto& addFilename : std::as_const(src->addFilenames))
+            paths.insert(addFilename.filename);
+    }
+    
+    mWatchedPaths = paths;
+    
+    // Update watcher
+    const QStringList watched = mWatcher.files();
+    for (const auto& path : watched)
+        if ( !paths.remove(path) )
+            mWatcher.removePath(path);
+    for (const auto& path : std::as_const(paths))
+        mWatcher.addPath(path);
+}
+
+/**************************************************************************************************/
+
+void ResultReloader::onFileChanged(const QString &path)
+{
+    // Coalesce notifications (several while file is written)
+    if (RELOAD_DEBUG) qDebug() << "File changed:" << path;
+    if ( !mChangedFiles.contains(path) )
+        mChangedFiles.insert(path, FileProbe());
+    if ( !mSettleTimer.isActive() )
+        mSettleTimer.start(settle_period_ms);
+}
+
+void ResultReloader::onSettleTimeout()
+{
+    QStringList stablePaths;
+    for (auto it = mChangedFiles.begin(); it != mChangedFiles.end(); )
+    {
+        const QString path = it.key();
+        if ( !mWatchedPaths.contains(path) ) {
+            it = mChangedFiles.erase(it);
+            continue;
+        }
+        
+        // Missing or empty, may be replaced (retry)
+        QFileInfo fi(path);
+        FileProbe probe;
+        probe.tries = it->tries + 1;
+        if ( !fi.exists() || !fi.isReadable() || fi.size() <= 0 )
+        {
+            if (probe.tries < settle_max_tries) {
+                *it = probe;
+                ++it;
+            }
+            else {
+                qWarning() << "Unable to auto-reload file: " << path;
+                it = mChangedFiles.erase(it);
+            }
+            continue;
+        }
+        // Watch again if replaced (e.g. written to temporary file then renamed)
+        if ( !mWatcher.files().contains(path) ) {
+            if (RELOAD_DEBUG) qDebug() << "Watching replaced file:" << path;
+            mWatcher.addPath(path);
+        }
+        
+        // Stable since previous probe
+        probe.size  = fi.size();
+        probe.mtime = fi.lastModified().toMSecsSinceEpoch();
+        if (probe.size == it->size && probe.mtime == it->mtime) {
+            stablePaths.append(path);
+            it = mChangedFiles.erase(it);
+        }
+        else {
+            *it = probe;
+            ++it;
+        }
+    }
+    if ( !mChangedFiles.isEmpty() )
+        mSettleTimer.start(settle_period_ms);
+    
+    for (const auto& path : std::as_const(stablePaths))
+        reloadUsing(path);
+}
+
+void ResultReloader::reloadUsing(const QString &path)
+{
+    // Each source using file (once for all its windows)
+    for (auto it = mSources.cbegin(); it != mSources.cend(); ++it)
+    {
+        const Source &src = *it.value();
+        if ( src.windows.isEmpty() )
+            continue;
+        
+        bool isUsed = src.filename == path;
+        for (int idx = 0; !isUsed && idx < src.addFilenames.size(); ++idx)
+            isUsed = src.addFilenames[idx].filename == path;
+        if (isUsed)
+            startReload( it.key() );
+    }
+}
+
+/**************************************************************************************************/
+
+// Size and modification time of each file, content hashed if requested (invalid if unreadable)
+static QVector<FileFingerprint> probeFiles(const QString &filename, const QVector<FileReload> &addFilenames,
+                                           bool hashContent)
+{
+    QStringList filenames(filename);
+    for (const auto& addFilename : addFilenames)
+        filenames.append(addFilename.filename);
+    
+    QVector<FileFingerprint> files;
+    files.reserve(filenames.size());
+    for (const auto& path : std::as_const(filenames))
+    {
+        if (hashContent) {
+            QFile file(path);
+            files.append( file.open(QIODevice::ReadOnly) ? ResultCache::fingerprint(file) : FileFingerprint() );
+            continue;
+        }
+        QFileInfo fileInfo(path);
+        FileFingerprint print;
+        if ( fileInfo.isReadable() ) {
+            print.path  = fileInfo.absoluteFilePath();
+            print.size  = fileInfo.size();
+            print.mtime = fileInfo.lastModified().toMSecsSinceEpoch();
+        }
+        files.append(print);
+    }
+    
+    return files;
+}
+
+// Same files (size and modification time), or same content if hashed
+static bool isSameFiles(const QVector<FileFingerprint> &files, const QVector<FileFingerprint> &known, bool byContent)
+{
+    if (files.isEmpty() || files.size() != known.size())
+        return false;
+    for (int i=0; i<files.size(); ++i)
+    {
+        const FileFingerprint &file = files[i];
+        if (!file.isValid() || !known[i].isValid())
+            return false;
+        bool isSame = byContent ? file.hash != 0 && file.hash == known[i].hash
+                                : file.size == known[i].size && file.mtime == known[i].mtime;
+        if (!isSame)
+            return false;
+    }
+    return true;
+}
+
+void ResultReloader::startReload(const QString &sourceKey)
+{
+    QSharedPointer<Source> src = mSources.value(sourceKey);
+    if ( src.isNull() )
+        return;
+    
+    // Reload again when current one is done (e.g. file changed meanwhile)
+    if ( src->loader.isRunning() ) {
+        src->isPending = true;
+        return;
+    }
+    if (RELOAD_DEBUG) qDebug() << "Reload:" << sourceKey << "| windows:" << src->windows.size();
+    
+    // Worker only uses copies
+    QString filename = src->filename;
+    QVector<FileReload> addFilenames = src->addFilenames;
+    BenchSnapshot latest = src->latest.toStrongRef();
+    QVector<FileFingerprint> knownFiles = !latest.isNull() ? src->files : QVector<FileFingerprint>();
+    
+    // Single file: only parsing appended data if possible (latest copied in worker)
+    bool canResume = addFilenames.isEmpty() && !latest.isNull() && latest->version == src->stateVersion;
+    BenchSnapshot base = canResume ? latest : BenchSnapshot();
+    ParseState parseState = canResume ? src->parseState : ParseState();
+    QSharedPointer<ParseProgress> progress = src->progress;
+    
+    QFuture<ReloadResult> future = QtConcurrent::run([filename, addFilenames, knownFiles, base, parseState, progress]() {
+        ReloadResult result;
+        
+        // Untouched since latest (nothing read)
+        result.files = probeFiles(filename, addFilenames, false);
+        if ( isSameFiles(result.files, knownFiles, false) ) {
+            result.isUnchanged = true;
+            result.isValid = true;
+            return result;
+        }
+        
+        // Resumed: only appended data read (same head and tail checked by parser, content not hashed)
+        if ( !base.isNull() )
+        {
+            result.bchResults = *base;
+            result.parseState = parseState;
+            result.isValid = ResultParser::parseJsonFileIncremental(filename, result.bchResults, result.parseState,
+                                                                   result.errorMsg, progress.data());
+            result.isCanceled = !progress.isNull() && progress->isCanceled();
+            result.isValid = result.isValid && !result.isCanceled;
+            result.isUnchanged = result.isValid && result.parseState.isUnchanged;
+            result.report = result.parseState.report;
+            return result;
+        }
+        
+        // Same content as latest (e.g. touched, or rewritten identically)
+        // Hashed once, fingerprints reused by parser for results cache
+        result.files = probeFiles(filename, addFilenames, true);
+        if ( isSameFiles(result.files, knownFiles, true) ) {
+            result.isUnchanged = true;
+            result.isValid = true;
+            return result;
+        }
+        
+        // Incomplete files accepted
+        if ( addFilenames.isEmpty() )
+        {
+            result.isValid = ResultParser::parseJsonFileIncremental(filename, result.bchResults, result.parseState,
+                                                                   result.errorMsg, progress.data(), &result.files[0]);
+            result.report = result.parseState.report;
+        }
+        else
+        {
+            result.bchResults = ResultParser::loadJsonFiles(filename, addFilenames, result.errorMsg, result.errorIdx,
+                                                            &result.report, progress.data(), &result.files);
+            result.isValid = !result.bchResults.benchmarks.isEmpty();
+        }
+        result.isCanceled = !progress.isNull() && progress->isCanceled();
+        result.isValid = result.isValid && !result.isCanceled;
+        return result;
+    });
+    src->loader.setFuture(future);
+}
+
+void ResultReloader::finishReload(const QString &sourceKey)
+{
+    QSharedPointer<Source> src = mSources.value(sourceKey);
+    if ( src.isNull() )
+        return;
+    
+    ReloadResult result = src->loader.result();
+    if (result.isUnchanged)
+    {
+        // Nothing to publish (windows already up to date)
+        if (RELOAD_DEBUG) qDebug() << "Unchanged content:" << sourceKey;
+        result.report = src->report;
+        src->files = result.files;
+    }
+    else if (result.isValid)
+    {
+        // Publish to all windows
+        BenchSnapshot snapshot = makeSnapshot( std::move(result.bchResults) );
+        if ( src->addFilenames.isEmpty() ) {
+            src->parseState   = result.parseState;
+            src->stateVersion = snapshot->version;
+        }
+        src->latest     = snapshot;
+        src->files      = result.files;
+        src->report     = result.report;
+        ResultSnapshots::instance()->publish(sourceKey, snapshot);
+        
+        // Partial results (to requester, logged if auto-reloaded)
+        if (result.report.isTruncated)
+        {
+            QString incomplete = QString::number(result.report.skippedBytes) + " bytes skipped after last complete benchmark.";
+            if ( !src->requester.isNull() )
+                QMessageBox::information(src->requester, "Reload benchmark results",
+                                         "Incomplete file (benchmarks still running?): " + src->filename + "\n" + incomplete);
+            else
+                qWarning() << "Incomplete file reloaded:" << sourceKey << "->" << incomplete;
+        }
+    }
+    else if (result.isCanceled)
+    {
+        // Canceled by requester (latest kept)
+        if (RELOAD_DEBUG) qDebug() << "Reload canceled:" << sourceKey;
+    }
+    else
+    {
+        const QString& errorFile = result.errorIdx < 0 ? src->filename : src->addFilenames[result.errorIdx].filename;
+        if ( !src->requester.isNull() )
+            QMessageBox::critical(src->requester, "Reload benchmark results",
+                                  "Error parsing file: " + errorFile + " -> " + result.errorMsg);
+        else
+            qWarning() << "Unable to reload file:" << errorFile << "->" << result.errorMsg;
+    }
+    // Requester kept for pending reload
+    if ( !src->isPending ) {
+        src->requester.clear();
+        src->progress.clear();
+    }
+    emit reloadFinished(sourceKey, result.isValid, result.report);
+    
+    if (src->isPending) {
+        src->isPending = false;
+        startReload(sourceKey);
+    }
+    else // once loader signal returned
+        QMetaObject::invokeMethod(this, [this, sourceKey]() { releaseSource(sourceKey); }, Qt::QueuedConnection);
+}
@@ -17,6 +17,8 @@
 #include "ui_result_selector.h"
 
 #include "result_parser.h"
+#include "result_reloader.h"
+#include "result_snapshots.h"
 #include "plot_parameters.h"
 
 #include "plotter_linechart.h"
@@ -34,6 +36,7 @@
 #include <QJsonDocument>
 #include <QScreen>
 #include <QGuiApplication>
+#include <QtConcurrent>
 
 #include <utility>
 
@@ -43,7 +46,7 @@ static const char* config_file = "config_selector.json";
 ResultSelector::ResultSelector(QWidget *parent)
     : QWidget(parent)
     , ui(new Ui::ResultSelector)
-    , mWatcher(parent)
+    , mBchResults(makeSnapshot( BenchResults() ))
 {
     ui->setupUi(this);
     
@@ -55,16 +58,17 @@ ResultSelector::ResultSelector(QWidget *parent)
     ui->pushButtonSelectAll->setEnabled(false);
     ui->pushButtonSelectNone->setEnabled(false);
     ui->pushButtonPlot->setEnabled(false);
+    ui->progressBarLoad->setVisible(false);
+    ui->pushButtonCancel->setVisible(false);
     
     connectUI();
     loadConfig();
 }
 
-ResultSelector::ResultSelector(const BenchResults &bchResults, const QString &fileName, QWidget *parent)
+ResultSelector::ResultSelector(const BenchSnapshot &bchResults, const QString &fileName, QWidget *parent)
     : QWidget(parent)
     , ui(new Ui::ResultSelector)
     , mBchResults(bchResults)
-    , mWatcher(parent)
 {
     ui->setupUi(this);
     
@@ -74,6 +78,8 @@ ResultSelector::ResultSelector(const BenchResults &bchResults, const QString &fi
     }
     mOrigFilename = fileName; // For reload
     updateResults(false);
+    ui->progressBarLoad->setVisible(false);
+    ui->pushButtonCancel->setVisible(false);
     
     connectUI();
     loadConfig();
@@ -84,6 +90,11 @@ ResultSelector::ResultSelector(const BenchResults &bchResults, const QString &fi
 
 ResultSelector::~ResultSelector()
 {
+    // Stop loading
+    if ( mLoadWatcher.isRunning() ) {
+        mLoadProgress->cancel();
+        mLoadWatcher.waitForFinished();
+    }
     saveConfig();
     delete ui;
 }
@@ -97,14 +108,19 @@ void ResultSelector::connectUI()
     connect(ui->comboBoxX,    QOverload<int>::of(&QComboBox::activated), this, &ResultSelector::onComboXChanged);
     connect(ui->comboBoxZ,    QOverload<int>::of(&QComboBox::activated), this, &ResultSelector::onComboZChanged);
     
-    connect(&mWatcher,              &QFileSystemWatcher::fileChanged, this, &ResultSelector::onAutoReload);
-    connect(ui->checkBoxAutoReload, &QCheckBox::stateChanged,         this, &ResultSelector::onCheckAutoReload);
-    connect(ui->pushButtonReload,   &QPushButton::clicked,            this, &ResultSelector::onReloadClicked);
+    connect(ui->checkBoxAutoReload, &QCheckBox::stateChanged, this, &ResultSelector::onCheckAutoReload);
+    connect(ui->pushButtonReload,   &QPushButton::clicked,    this, &ResultSelector::onReloadClicked);
+    connect(ResultReloader::instance(),  &ResultReloader::reloadFinished, this, &ResultSelector::onReloadFinished);
+    connect(ResultSnapshots::instance(), &ResultSnapshots::published,     this, &ResultSelector::onResultsPublished);
     
     connect(ui->pushButtonNew,       &QPushButton::clicked, this, &ResultSelector::onNewClicked);
     connect(ui->pushButtonAppend,    &QPushButton::clicked, this, &ResultSelector::onAppendClicked);
     connect(ui->pushButtonOverwrite, &QPushButton::clicked, this, &ResultSelector::onOverwriteClicked);
     
+    connect(&mLoadWatcher,          &QFutureWatcher<LoadResult>::finished, this, &ResultSelector::onLoadFinished);
+    connect(&mProgressTimer,        &QTimer::timeout,                      this, &ResultSelector::onLoadProgress);
+    connect(ui->pushButtonCancel,   &QPushButton::clicked,                 this, &ResultSelector::onCancelClicked);
+    
     connect(ui->pushButtonSelectAll,  &QPushButton::clicked, this, &ResultSelector::onSelectAllClicked);
     connect(ui->pushButtonSelectNone, &QPushButton::clicked, this, &ResultSelector::onSelectNoneClicked);
     
@@ -162,6 +178,23 @@ void ResultSelector::saveConfig()
         qWarning() << "Couldn't update: " << QString(config_folder) + config_file;
 }
 
+// Y-value of user-defined aggregate (in percent or same unit as metric)
+static void addCustomAggregate(QComboBox *comboBox, const BenchMeta &meta, int aggId, const QString &prefix,
+                               PlotValueType metric, PlotValueType cvMetric)
+{
+    bool isPercent = meta.percentAggregates.contains(aggId);
+    PlotValueType yType = customAggregateType(isPercent ? cvMetric : metric, aggId);
+    if (yType == UnknownValueType)
+        return;
+    
+    QString name = prefix + " " + AggregateNames::name(aggId);
+    if (isPercent)
+        name += " percent";
+    else if (metric == CpuTimeType || metric == RealTimeType)
+        name += " time";
+    comboBox->addItem(name, QVariant(yType));
+}
+
 void ResultSelector::updateComboBoxY()
 {
     PlotChartType chartType = (PlotChartType)ui->comboBoxType->currentData().toInt();
@@ -170,16 +203,16 @@ void ResultSelector::updateComboBoxY()
         prevYType = (PlotValueType)ui->comboBoxY->currentData().toInt();
     
     // Classic or Boxes
-    if (!mBchResults.meta.hasAggregate || chartType == ChartBoxType)
+    if (!mBchResults->meta.hasAggregate || chartType == ChartBoxType)
     {
         ui->comboBoxY->clear();
         
         ui->comboBoxY->addItem("Real time",     QVariant(RealTimeType));
         ui->comboBoxY->addItem("CPU time",      QVariant(CpuTimeType));
         ui->comboBoxY->addItem("Iterations",    QVariant(IterationsType));
-        if (mBchResults.meta.hasBytesSec)
+        if (mBchResults->meta.hasBytesSec)
             ui->comboBoxY->addItem("Bytes/s",   QVariant(BytesType));
-        if (mBchResults.meta.hasItemsSec)
+        if (mBchResults->meta.hasItemsSec)
             ui->comboBoxY->addItem("Items/s",   QVariant(ItemsType));
     }
     // Aggregate
@@ -187,39 +220,47 @@ void ResultSelector::updateComboBoxY()
     {
         ui->comboBoxY->clear();
         
-        if (!mBchResults.meta.onlyAggregate)
+        if (!mBchResults->meta.onlyAggregate)
             ui->comboBoxY->addItem("Real min time",     QVariant(RealTimeMinType));
         ui->comboBoxY->addItem("Real mean time",        QVariant(RealTimeMeanType));
         ui->comboBoxY->addItem("Real median time",      QVariant(RealTimeMedianType));
         ui->comboBoxY->addItem("Real stddev time",      QVariant(RealTimeStddevType));
-        if (mBchResults.meta.hasCv)
+        if (mBchResults->meta.hasCv)
             ui->comboBoxY->addItem("Real cv percent",   QVariant(RealTimeCvType));
+        for (int aggId : std::as_const(mBchResults->meta.customAggregates))
+            addCustomAggregate(ui->comboBoxY, mBchResults->meta, aggId, "Real", RealTimeType, RealTimeCvType);
         
-        if (!mBchResults.meta.onlyAggregate)
+        if (!mBchResults->meta.onlyAggregate)
             ui->comboBoxY->addItem("CPU min time",      QVariant(CpuTimeMinType));
         ui->comboBoxY->addItem("CPU mean time",         QVariant(CpuTimeMeanType));
         ui->comboBoxY->addItem("CPU median time",       QVariant(CpuTimeMedianType));
         ui->comboBoxY->addItem("CPU stddev time",       QVariant(CpuTimeStddevType));
-        if (mBchResults.meta.hasCv)
+        if (mBchResults->meta.hasCv)
             ui->comboBoxY->addItem("CPU cv percent",    QVariant(CpuTimeCvType));
+        for (int aggId : std::as_const(mBchResults->meta.customAggregates))
+            addCustomAggregate(ui->comboBoxY, mBchResults->meta, aggId, "CPU", CpuTimeType, CpuTimeCvType);
         
         ui->comboBoxY->addItem("Iterations",            QVariant(IterationsType));
         
-        if (mBchResults.meta.hasBytesSec) {
+        if (mBchResults->meta.hasBytesSec) {
             ui->comboBoxY->addItem("Bytes/s min",       QVariant(BytesMinType));
             ui->comboBoxY->addItem("Bytes/s mean",      QVariant(BytesMeanType));
             ui->comboBoxY->addItem("Bytes/s median",    QVariant(BytesMedianType));
             ui->comboBoxY->addItem("Bytes/s stddev",    QVariant(BytesStddevType));
-            if (mBchResults.meta.hasCv)
+            if (mBchResults->meta.hasCv)
                 ui->comboBoxY->addItem("Bytes/s cv",    QVariant(BytesCvType));
+            for (int aggId : std::as_const(mBchResults->meta.customAggregates))
+                addCustomAggregate(ui->comboBoxY, mBchResults->meta, aggId, "Bytes/s", BytesType, BytesCvType);
         }
-        if (mBchResults.meta.hasItemsSec) {
+        if (mBchResults->meta.hasItemsSec) {
             ui->comboBoxY->addItem("Items/s min",       QVariant(ItemsMinType));
             ui->comboBoxY->addItem("Items/s mean",      QVariant(ItemsMeanType));
             ui->comboBoxY->addItem("Items/s median",    QVariant(ItemsMedianType));
             ui->comboBoxY->addItem("Items/s stddev",    QVariant(ItemsStddevType));
-            if (mBchResults.meta.hasCv)
+            if (mBchResults->meta.hasCv)
                 ui->comboBoxY->addItem("Items/s cv",    QVariant(ItemsCvType));
+            for (int aggId : std::as_const(mBchResults->meta.customAggregates))
+                addCustomAggregate(ui->comboBoxY, mBchResults->meta, aggId, "Items/s", ItemsType, ItemsCvType);
         }
     }
     // Restore
@@ -248,8 +289,8 @@ static QTreeWidgetItem* buildTreeItem(const BenchData &bchData, double timeFacto
 {
     QStringList labels = {
         bchData.base_name, bchData.templates.join(", "), bchData.arguments.join("/"),
-        QString::number((!onlyAggregate ? bchData.real_time_us : bchData.mean_real) * timeFactor),
-        QString::number((!onlyAggregate ? bchData.cpu_time_us  : bchData.mean_cpu)  * timeFactor)
+        QString::number((!onlyAggregate ? bchData.real_time_us : bchData.aggregates().mean_real) * timeFactor),
+        QString::number((!onlyAggregate ? bchData.cpu_time_us  : bchData.aggregates().mean_cpu)  * timeFactor)
     };
     if ( !bchData.kbytes_sec.isEmpty() )
         labels.append( QString::number(bchData.kbytes_sec_dflt) );
@@ -319,7 +360,7 @@ void ResultSelector::updateResults(bool clear, const QSet<QString> unselected)
     if (clear)
     {
 //        if (keepSelection)
-//            unselected = getUnselectedBenchmarks(ui->treeWidget, mBchResults);
+//            unselected = getUnselectedBenchmarks(ui->treeWidget, *mBchResults);
         ui->treeWidget->clear();
     }
     else
@@ -328,21 +369,22 @@ void ResultSelector::updateResults(bool clear, const QSet<QString> unselected)
     
     // Columns
     int iCol = 5;
-    if (mBchResults.meta.hasBytesSec) ++iCol;
-    if (mBchResults.meta.hasItemsSec) ++iCol;
+    if (mBchResults->meta.hasBytesSec) ++iCol;
+    if (mBchResults->meta.hasItemsSec) ++iCol;
     ui->treeWidget->setColumnCount(iCol);
     
     // Time unit
     double timeFactor = 1.;
-    if (     mBchResults.meta.time_unit == "ns") timeFactor = 1000.;
-    else if (mBchResults.meta.time_unit == "ms") timeFactor = 0.001;
-    else                                         mBchResults.meta.time_unit = "us";
+    QString timeUnit = mBchResults->meta.time_unit;
+    if (     timeUnit == "ns") timeFactor = 1000.;
+    else if (timeUnit == "ms") timeFactor = 0.001;
+    else                       timeUnit = "us";
     
     // Populate tree
     bool anySelected = false;
     QList<QTreeWidgetItem *> items;
     
-    QVector<BenchSubset> bchFamilies = mBchResults.segmentFamilies();
+    QVector<BenchSubset> bchFamilies = mBchResults->segmentFamilies();
     for (const auto &bchFamily : std::as_const(bchFamilies))
     {
         bool oneTopSelected = false;
@@ -350,9 +392,9 @@ void ResultSelector::updateResults(bool clear, const QSet<QString> unselected)
         QTreeWidgetItem* topItem = new QTreeWidgetItem( QStringList(bchFamily.name) );
         
         // JOMT: family + container
-        if ( !mBchResults.benchmarks[bchFamily.idxs[0]].container.isEmpty() )
+        if ( !mBchResults->benchmarks[bchFamily.idxs[0]].container.isEmpty() )
         {
-            QVector<BenchSubset> bchContainers = mBchResults.segmentContainers(bchFamily.idxs);
+            QVector<BenchSubset> bchContainers = mBchResults->segmentContainers(bchFamily.idxs);
             for (const auto &bchContainer : std::as_const(bchContainers))
             {
                 bool oneMidSelected = false;
@@ -361,8 +403,8 @@ void ResultSelector::updateResults(bool clear, const QSet<QString> unselected)
                 
                 for (int idx : bchContainer.idxs)
                 {
-                    QTreeWidgetItem *child = buildTreeItem(mBchResults.benchmarks[idx], timeFactor, mBchResults.meta.onlyAggregate);
-                    bool selected = !unselected.contains( mBchResults.getBenchName(idx) );
+                    QTreeWidgetItem *child = buildTreeItem(mBchResults->benchmarks[idx], timeFactor, mBchResults->meta.onlyAggregate);
+                    bool selected = !unselected.contains( mBchResults->getBenchName(idx) );
                     oneMidSelected |= selected;
                     allMidSelected &= selected;
                     child->setCheckState(0, selected ? Qt::Checked : Qt::Unchecked);
@@ -382,16 +424,16 @@ void ResultSelector::updateResults(bool clear, const QSet<QString> unselected)
             if (bchFamily.idxs.size() == 1)
             {
                 int idx = bchFamily.idxs[0];
-                buildTreeItem(mBchResults.benchmarks[idx], timeFactor, mBchResults.meta.onlyAggregate, topItem);
-                oneTopSelected = !unselected.contains( mBchResults.getBenchName(idx) );
+                buildTreeItem(mBchResults->benchmarks[idx], timeFactor, mBchResults->meta.onlyAggregate, topItem);
+                oneTopSelected = !unselected.contains( mBchResults->getBenchName(idx) );
                 topItem->setData(0, Qt::UserRole, idx);
             }
             else // Family
             {
                 for (int idx : bchFamily.idxs)
                 {
-                    QTreeWidgetItem *child = buildTreeItem(mBchResults.benchmarks[idx], timeFactor, mBchResults.meta.onlyAggregate);
-                    bool selected = !unselected.contains( mBchResults.getBenchName(idx) );
+                    QTreeWidgetItem *child = buildTreeItem(mBchResults->benchmarks[idx], timeFactor, mBchResults->meta.onlyAggregate);
+                    bool selected = !unselected.contains( mBchResults->getBenchName(idx) );
                     oneTopSelected |= selected;
                     allTopSelected &= selected;
                     child->setCheckState(0, selected ? Qt::Checked : Qt::Unchecked);
@@ -410,23 +452,23 @@ void ResultSelector::updateResults(bool clear, const QSet<QString> unselected)
     
     // Headers
     QStringList labels = {"Benchmark", "Templates", "Arguments"};
-    if (!mBchResults.meta.hasAggregate) {
-        labels << "Real time (" + mBchResults.meta.time_unit + ")"
-               << "CPU time ("  + mBchResults.meta.time_unit + ")";
-        if (mBchResults.meta.hasBytesSec) labels << "Bytes/s (k)";
-        if (mBchResults.meta.hasItemsSec) labels << "Items/s (k)";
+    if (!mBchResults->meta.hasAggregate) {
+        labels << "Real time (" + timeUnit + ")"
+               << "CPU time ("  + timeUnit + ")";
+        if (mBchResults->meta.hasBytesSec) labels << "Bytes/s (k)";
+        if (mBchResults->meta.hasItemsSec) labels << "Items/s (k)";
     }
     else {
-        if (!mBchResults.meta.onlyAggregate) {
-            labels << "Real min time (" + mBchResults.meta.time_unit + ")"
-                   << "CPU min time ("  + mBchResults.meta.time_unit + ")";
+        if (!mBchResults->meta.onlyAggregate) {
+            labels << "Real min time (" + timeUnit + ")"
+                   << "CPU min time ("  + timeUnit + ")";
         }
         else {
-            labels << "Real mean time (" + mBchResults.meta.time_unit + ")"
-                   << "CPU mean time ("  + mBchResults.meta.time_unit + ")";
+            labels << "Real mean time (" + timeUnit + ")"
+                   << "CPU mean time ("  + timeUnit + ")";
         }
-        if (mBchResults.meta.hasBytesSec) labels << "Bytes/s min (k)";
-        if (mBchResults.meta.hasItemsSec) labels << "Items/s min (k)";
+        if (mBchResults->meta.hasBytesSec) labels << "Bytes/s min (k)";
+        if (mBchResults->meta.hasItemsSec) labels << "Items/s min (k)";
     }
     
     ui->treeWidget->setHeaderLabels(labels);
@@ -461,27 +503,27 @@ void ResultSelector::updateResults(bool clear, const QSet<QString> unselected)
     }
     
     // Type
-    if (mBchResults.meta.maxArguments > 0 || mBchResults.meta.maxTemplates > 0) {
+    if (mBchResults->meta.maxArguments > 0 || mBchResults->meta.maxTemplates > 0) {
         ui->comboBoxType->addItem("Lines",      ChartLineType);
         ui->comboBoxType->addItem("Splines",    ChartSplineType);
     }
     ui->comboBoxType->addItem("Bars",   ChartBarType);
     ui->comboBoxType->addItem("HBars",  ChartHBarType);
-    if (mBchResults.meta.hasAggregate && !mBchResults.meta.onlyAggregate)
+    if (mBchResults->meta.hasAggregate && !mBchResults->meta.onlyAggregate)
         ui->comboBoxType->addItem("Boxes",  ChartBoxType);
     ui->comboBoxType->addItem("3D Bars",    Chart3DBarsType);
-    if (mBchResults.meta.maxArguments > 0 || mBchResults.meta.maxTemplates > 0)
+    if (mBchResults->meta.maxArguments > 0 || mBchResults->meta.maxTemplates > 0)
         ui->comboBoxType->addItem("3D Surface", Chart3DSurfaceType);
     
     
     // X-axis
-    for (int i=0; i<mBchResults.meta.maxArguments; ++i)
+    for (int i=0; i<mBchResults->meta.maxArguments; ++i)
     {
         QList<QVariant> qvList;
         qvList.append(PlotArgumentType); qvList.append(i);
         ui->comboBoxX->addItem("Argument " + QString::number(i+1), qvList);
     }
-    for (int i=0; i<mBchResults.meta.maxTemplates; ++i)
+    for (int i=0; i<mBchResults->meta.maxTemplates; ++i)
     {
         QList<QVariant> qvList;
         qvList.append(PlotTemplateType); qvList.append(i);
@@ -510,13 +552,13 @@ void ResultSelector::updateResults(bool clear, const QSet<QString> unselected)
         else
             ui->comboBoxZ->setEnabled(false);
 
-        for (int i=0; i<mBchResults.meta.maxArguments; ++i)
+        for (int i=0; i<mBchResults->meta.maxArguments; ++i)
         {
             QList<QVariant> qvList;
             qvList.append(PlotArgumentType); qvList.append(i);
             ui->comboBoxZ->addItem("Argument " + QString::number(i+1), qvList);
         }
-        for (int i=0; i<mBchResults.meta.maxTemplates; ++i)
+        for (int i=0; i<mBchResults->meta.maxTemplates; ++i)
         {
             QList<QVariant> qvList;
             qvList.append(PlotTemplateType); qvList.append(i);
@@ -662,7 +704,7 @@ void ResultSelector::onComboTypeChanged(int /*index*/)
     else
         ui->comboBoxZ->setEnabled(false);
     
-    if (mBchResults.meta.hasAggregate)
+    if (mBchResults->meta.hasAggregate)
         updateComboBoxY();
 }
 
@@ -703,44 +745,19 @@ void ResultSelector::onComboZChanged(int /*index*/)
 }
 
 // Reload
-void ResultSelector::onAutoReload(const QString &path)
-{
-    QFileInfo fi(path);
-    if (fi.exists() && fi.isReadable() && fi.size() > 0)
-        onReloadClicked();
-    else
-        qWarning() << "Unable to auto-reload file: " << path;
-}
-
 void ResultSelector::updateReloadWatchList()
 {
+    // Watched once for all windows of same files
     if (ui->checkBoxAutoReload->isChecked())
-    {
-        if (!mWatcher.files().empty())
-            mWatcher.removePaths( mWatcher.files() );
-        
-        mWatcher.addPath(mOrigFilename);
-        for (const auto& addFilename : std::as_const(mAddFilenames))
-            mWatcher.addPath( addFilename.filename );
-    }
+        ResultReloader::instance()->watch(this, mOrigFilename, mAddFilenames);
 }
 
 void ResultSelector::onCheckAutoReload(int state)
 {
     if (state == Qt::Checked)
-    {
-        if (mWatcher.files().empty())
-        {
-            mWatcher.addPath(mOrigFilename);
-            for (const auto& addFilename : std::as_const(mAddFilenames))
-                mWatcher.addPath( addFilename.filename );
-        }
-    }
+        ResultReloader::instance()->watch(this, mOrigFilename, mAddFilenames);
     else
-    {
-        if (!mWatcher.files().empty())
-            mWatcher.removePaths( mWatcher.files() );
-    }
+        ResultReloader::instance()->unwatch(this);
 }
 
 void ResultSelector::onReloadClicked()
@@ -755,41 +772,44 @@ void ResultSelector::onReloadClicked()
                              "File to reload does no exist:" + mOrigFilename);
         return;
     }
-    // Load original
-    QString errorMsg;
-    BenchResults newResults = ResultParser::parseJsonFile(mOrigFilename, errorMsg);
-    if (newResults.benchmarks.size() <= 0) {
-        QMessageBox::warning(this, "Reload benchmark results",
-                             "Error parsing file: " + mOrigFilename + "\n" + errorMsg);
+    // Parsed once for all windows of same files (updated on publication)
+    mLoadProgress = QSharedPointer<ParseProgress>::create();
+    setLoading(true);
+    ResultReloader::instance()->reload(mOrigFilename, mAddFilenames, this, mLoadProgress);
+}
+
+void ResultSelector::onReloadFinished(const QString &sourceKey, bool isValid, const ParseReport &report)
+{
+    if ( sourceKey != ResultSnapshots::sourceKey(mOrigFilename, mAddFilenames) )
         return;
-    }
     
-    // Load additionnals
-    for (const auto &addFile : std::as_const(mAddFilenames))
-    {
-        QString errorMsg;
-        BenchResults addResults = ResultParser::parseJsonFile(addFile.filename, errorMsg);
-        if (addResults.benchmarks.size() <= 0) {
-            QMessageBox::warning(this, "Reload benchmark results",
-                                 "Error parsing file: " + addFile.filename + "\n" + errorMsg);
-            return;
-        }
-        // Append / Overwrite
-        if (addFile.isAppend)
-            newResults.appendResults(addResults);
-        else
-            newResults.overwriteResults(addResults);
-    }
-    
-    // Replace & update
-    auto unselected = getUnselectedBenchmarks(ui->treeWidget, mBchResults);
-    mBchResults = newResults;
-    updateResults(true, unselected);
+    // Requested reload done (not running again)
+    if ( mProgressTimer.isActive() && !mLoadWatcher.isRunning()
+         && !ResultReloader::instance()->isReloading(sourceKey) )
+        setLoading(false);
+    if ( !isValid )
+        return;
     
     // Update timestamp
     QDateTime today = QDateTime::currentDateTime();
     QTime now = today.time();
-    ui->labelLastReload->setText("(Last: " + now.toString() + ")");
+    QString incomplete;
+    if (report.isTruncated)
+        incomplete = ", incomplete: " + QString::number(report.skippedBytes) + " bytes skipped";
+    ui->labelLastReload->setText("(Last: " + now.toString() + incomplete + ")");
+}
+
+void ResultSelector::onResultsPublished(const QString &sourceKey, const BenchSnapshot &bchResults)
+{
+    // Same files and newer results only (own publications included)
+    if ( sourceKey != ResultSnapshots::sourceKey(mOrigFilename, mAddFilenames)
+         || bchResults->version <= mBchResults->version )
+        return;
+    
+    // Replace & update
+    auto unselected = getUnselectedBenchmarks(ui->treeWidget, *mBchResults);
+    mBchResults = bchResults;
+    updateResults(true, unselected);
 }
 
 // File
@@ -799,38 +819,7 @@ void ResultSelector::onNewClicked()
         tr("Open benchmark results"), mWorkingDir, tr("Benchmark results (*.json)"));
     
     if ( !fileName.isEmpty() && QFile::exists(fileName) )
-    {
-        QString errorMsg;
-        BenchResults newResults = ResultParser::parseJsonFile(fileName, errorMsg);
-        if (newResults.benchmarks.size() <= 0) {
-            QMessageBox::warning(this, "Open benchmark results",
-                                 "Error parsing file: " + fileName + "\n" + errorMsg);
-            return;
-        }
-        // Replace & upate
-        mBchResults = newResults;
-        ui->treeWidget->sortByColumn(-1, Qt::SortOrder::AscendingOrder); // reset sorting
-        updateResults(true);
-        
-        // Update UI
-        ui->pushButtonAppend->setEnabled(true);
-        ui->pushButtonOverwrite->setEnabled(true);
-        ui->pushButtonReload->setEnabled(true);
-        ui->pushButtonSelectAll->setEnabled(true);
-        ui->pushButtonSelectNone->setEnabled(true);
-        ui->pushButtonPlot->setEnabled(true);
-        
-        // Save for reload
-        mOrigFilename = fileName;
-        mAddFilenames.clear();
-        updateReloadWatchList();
-        
-        // Window title
-        QFileInfo fileInfo(fileName);
-        this->setWindowTitle("JOMT - " +  fileInfo.fileName());
-        
-        mWorkingDir = fileInfo.absoluteDir().absolutePath();
-    }
+        startLoading(LoadNew, fileName);
 }
 
 void ResultSelector::onAppendClicked()
@@ -839,30 +828,7 @@ void ResultSelector::onAppendClicked()
         tr("Append benchmark results"), mWorkingDir, tr("Benchmark results (*.json)"));
     
     if ( !fileName.isEmpty() && QFile::exists(fileName) )
-    {
-        QString errorMsg;
-        BenchResults newResults = ResultParser::parseJsonFile(fileName, errorMsg);
-        if (newResults.benchmarks.size() <= 0) {
-            QMessageBox::warning(this, "Open benchmark results",
-                                 "Error parsing file: " + fileName + "\n" + errorMsg);
-            return;
-        }
-        // Append & upate
-        auto unselected = getUnselectedBenchmarks(ui->treeWidget, mBchResults);
-        mBchResults.appendResults(newResults);
-        updateResults(true, unselected);
-        
-        // Save for reload
-        mAddFilenames.append( {fileName, true} );
-        updateReloadWatchList();
-        
-        // Window title
-        if ( !this->windowTitle().endsWith(" + ...") )
-            this->setWindowTitle( this->windowTitle() + " + ..." );
-        
-        QFileInfo fileInfo(fileName);
-        mWorkingDir = fileInfo.absoluteDir().absolutePath();
-    }
+        startLoading(LoadAppend, fileName);
 }
 
 void ResultSelector::onOverwriteClicked()
@@ -871,30 +837,174 @@ void ResultSelector::onOverwriteClicked()
         tr("Overwrite benchmark results"), mWorkingDir, tr("Benchmark results (*.json)"));
     
     if ( !fileName.isEmpty() && QFile::exists(fileName) )
+        startLoading(LoadOverwrite, fileName);
+}
+
+// Loading
+void ResultSelector::startLoading(LoadKind kind, const QString &fileName)
+{
+    mLoadKind = kind;
+    mLoadFilename = fileName;
+    mLoadProgress = QSharedPointer<ParseProgress>::create();
+    
+    // Worker only uses copies (current results stay usable until swapped)
+    QSharedPointer<ParseProgress> progress = mLoadProgress;
+    QFuture<LoadResult> future;
+    if (kind == LoadNew)
     {
-        QString errorMsg;
-        BenchResults newResults = ResultParser::parseJsonFile(fileName, errorMsg);
-        if (newResults.benchmarks.size() <= 0) {
-            QMessageBox::warning(this, "Open benchmark results",
-                                 "Error parsing file: " + fileName + "\n" + errorMsg);
-            return;
-        }
-        // Overwrite & upate
-        auto unselected = getUnselectedBenchmarks(ui->treeWidget, mBchResults);
-        mBchResults.overwriteResults(newResults);
-        updateResults(true, unselected);
-        
-        // Save for reload
-        mAddFilenames.append( {fileName, false} );
-        updateReloadWatchList();
-        
-        // Window title
-        if ( !this->windowTitle().endsWith(" + ...") )
-            this->setWindowTitle( this->windowTitle() + " + ..." );
-        
-        QFileInfo fileInfo(fileName);
-        mWorkingDir = fileInfo.absoluteDir().absolutePath();
+        // With state for later reloads, only parsing appended data if possible (incomplete file accepted)
+        future = QtConcurrent::run([fileName, progress]() {
+            LoadResult result;
+            result.isValid = ResultParser::parseJsonFileIncremental(fileName, result.bchResults, result.parseState,
+                                                                   result.errorMsg, progress.data());
+            result.report = result.parseState.report;
+            return result;
+        });
+    }
+    else
+    {
+        // Merged into current results too (copied there, not in GUI thread)
+        BenchSnapshot current = mBchResults;
+        bool isAppend = kind == LoadAppend;
+        future = QtConcurrent::run([fileName, progress, current, isAppend]() {
+            LoadResult result;
+            result.addResults = ResultParser::parseJsonFile(fileName, result.errorMsg, nullptr, progress.data());
+            result.isValid = !result.addResults.benchmarks.isEmpty();
+            if (!result.isValid || progress->isCanceled())
+                return result;
+            
+            result.bchResults = *current;   // data shared until merged
+            result.baseVersion = current->version;
+            if (isAppend)
+                result.bchResults.appendResults( BenchResults(result.addResults) );
+            else
+                result.bchResults.overwriteResults( BenchResults(result.addResults) );
+            return result;
+        });
+    }
+    mLoadWatcher.setFuture(future);
+    setLoading(true);
+}
+
+void ResultSelector::setLoading(bool loading)
+{
+    bool hasFile = !mOrigFilename.isEmpty();
+    ui->pushButtonNew->setEnabled(!loading);
+    ui->pushButtonAppend->setEnabled(!loading && hasFile);
+    ui->pushButtonOverwrite->setEnabled(!loading && hasFile);
+    ui->pushButtonReload->setEnabled(!loading && hasFile);
+    
+    ui->progressBarLoad->setValue(0);
+    ui->progressBarLoad->setVisible(loading);
+    ui->pushButtonCancel->setVisible(loading);
+    if (loading)
+        mProgressTimer.start(100);
+    else
+        mProgressTimer.stop();
+}
+
+void ResultSelector::onLoadProgress()
+{
+    qint64 totalBytes = mLoadProgress->totalBytes();
+    if (totalBytes > 0)
+        ui->progressBarLoad->setValue( static_cast<int>(ui->progressBarLoad->maximum()
+                                                         * mLoadProgress->parsedBytes() / totalBytes) );
+}
+
+void ResultSelector::onCancelClicked()
+{
+    if ( !mLoadProgress.isNull() )
+        mLoadProgress->cancel();
+}
+
+void ResultSelector::onLoadFinished()
+{
+    setLoading(false);
+    if ( mLoadProgress->isCanceled() )
+        return;
+    
+    // Swap in new results
+    LoadResult result = mLoadWatcher.result();
+    switch (mLoadKind)
+    {
+        case LoadNew:       finishNew(result); break;
+        case LoadAppend:    finishAdd(result, true); break;
+        case LoadOverwrite: finishAdd(result, false); break;
+    }
+}
+
+void ResultSelector::finishNew(LoadResult &result)
+{
+    const QString& fileName = mLoadFilename;
+    if ( !result.isValid ) {
+        QMessageBox::warning(this, "Open benchmark results",
+                             "Error parsing file: " + fileName + "\n" + result.errorMsg);
+        return;
     }
+    if (result.report.isTruncated) {
+        QMessageBox::information(this, "Open benchmark results",
+                                 "Incomplete file (benchmarks still running?): " + fileName + "\n"
+                                 + QString::number(result.report.skippedBytes) + " bytes skipped after last complete benchmark.");
+    }
+    // Replace & upate
+    mBchResults = makeSnapshot( std::move(result.bchResults) );
+    ui->treeWidget->sortByColumn(-1, Qt::SortOrder::AscendingOrder); // reset sorting
+    updateResults(true);
+    
+    // Update UI
+    ui->pushButtonAppend->setEnabled(true);
+    ui->pushButtonOverwrite->setEnabled(true);
+    ui->pushButtonReload->setEnabled(true);
+    ui->pushButtonSelectAll->setEnabled(true);
+    ui->pushButtonSelectNone->setEnabled(true);
+    ui->pushButtonPlot->setEnabled(true);
+    
+    // Save for reload
+    mOrigFilename = fileName;
+    mAddFilenames.clear();
+    ResultReloader::instance()->setLoaded(mOrigFilename, mBchResults, result.parseState);
+    updateReloadWatchList();
+    ResultSnapshots::instance()->publish(ResultSnapshots::sourceKey(mOrigFilename, mAddFilenames), mBchResults);
+    
+    // Window title
+    QFileInfo fileInfo(fileName);
+    this->setWindowTitle("JOMT - " +  fileInfo.fileName());
+    
+    mWorkingDir = fileInfo.absoluteDir().absolutePath();
+}
+
+void ResultSelector::finishAdd(LoadResult &result, bool isAppend)
+{
+    const QString& fileName = mLoadFilename;
+    if ( !result.isValid ) {
+        QMessageBox::warning(this, "Open benchmark results",
+                             "Error parsing file: " + fileName + "\n" + result.errorMsg);
+        return;
+    }
+    // Append/Overwrite & upate (merged again if results replaced while loading, e.g. reloaded)
+    auto unselected = getUnselectedBenchmarks(ui->treeWidget, *mBchResults);
+    if (result.baseVersion != mBchResults->version)
+    {
+        result.bchResults = *mBchResults;
+        if (isAppend)
+            result.bchResults.appendResults( std::move(result.addResults) );
+        else
+            result.bchResults.overwriteResults( std::move(result.addResults) );
+    }
+    mBchResults = makeSnapshot( std::move(result.bchResults) );
+    updateResults(true, unselected);
+    
+    // Save for reload
+    mAddFilenames.append( {fileName, isAppend} );
+    updateReloadWatchList();
+    ResultSnapshots::instance()->publish(ResultSnapshots::sourceKey(mOrigFilename, mAddFilenames), mBchResults);
+    
+    // Window title
+    if ( !this->windowTitle().endsWith(" + ...") )
+        this->setWindowTitle( this->windowTitle() + " + ..." );
+    
+    QFileInfo fileInfo(fileName);
+    mWorkingDir = fileInfo.absoluteDir().absolutePath();
 }
 
 // Selection
@@ -0,0 +1,46 @@
+// Copyright 2019 Guillaume AUJAY. All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include "result_snapshots.h"
+
+
+ResultSnapshots::ResultSnapshots(QObject *parent)
+    : QObject(parent)
+{}
+
+ResultSnapshots* ResultSnapshots::instance()
+{
+    static ResultSnapshots snapshots;
+    return &snapshots;
+}
+
+/**************************************************************************************************/
+
+QString ResultSnapshots::sourceKey(const QString &filename, const QVector<FileReload> &addFilenames)
+{
+    QString key = filename;
+    for (const auto& addFile : addFilenames)
+        key += (addFile.isAppend ? "\n+" : "\n=") + addFile.filename;
+    
+    return key;
+}
+
+/**************************************************************************************************/
+
+void ResultSnapshots::publish(const QString &sourceKey, const BenchSnapshot &bchResults)
+{
+    emit published(sourceKey, bchResults);
+}
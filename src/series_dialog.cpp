@@ -23,10 +23,50 @@
 #include <QColorDialog>
 #include <QScreen>
 #include <QGuiApplication>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
 
 #include <utility>
 
 
+void loadSeriesConfig(const QJsonObject &json, SeriesMapping &mapping, int from)
+{
+    if ( !json.contains("series") || !json["series"].isArray() )
+        return;
+    
+    const auto series = json["series"].toArray();
+    for (int idx = 0; idx < series.size(); ++idx) {
+        QJsonObject config = series[idx].toObject();
+        if ( config.contains("oldName")  && config["oldName"].isString()
+          && config.contains("newName")  && config["newName"].isString()
+          && config.contains("newColor") && config["newColor"].isString()
+          && QColor::isValidColorName(config["newColor"].toString()) )
+        {
+            SeriesConfig savedConfig(config["oldName"].toString(), "");
+            int iCfg = mapping.indexOf(savedConfig, from);
+            if (iCfg >= 0) {
+                mapping[iCfg].newName = config["newName"].toString();
+                mapping[iCfg].newColor = QColor::fromString( config["newColor"].toString() );
+            }
+        }
+    }
+}
+
+bool loadSeriesConfig(const QString &configPath, SeriesMapping &mapping, int from)
+{
+    QFile configFile(configPath);
+    if ( !configFile.open(QIODevice::ReadOnly) )
+        return false;
+    
+    QJsonDocument configDoc( QJsonDocument::fromJson(configFile.readAll()) );
+    loadSeriesConfig(configDoc.object(), mapping, from);
+    return true;
+}
+
+/**************************************************************************************************/
+
 class FieldWidget : public QWidget
 {
 public: